@@ -29,10 +29,43 @@ using namespace QtUtilities;
 
 namespace Cli {
 
-SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argument &pedanticArg)
+FileListArgs::FileListArgs(Argument &filesArg)
     : filesArg(filesArg)
+    , nullArg("null", '\0', "indicates that the paths read via --files-from are separated by NUL characters (e.g. find -print0)")
+    , filesFromArg("files-from", '\0',
+          "reads the paths of the files to be opened from the specified file (or stdin if \"-\") while processing the files; the paths are "
+          "separated by newlines",
+          { "path/-" })
+    , extensionsArg("extensions", '\0', "considers only files with one of the specified extensions (case-insensitive)", { "flac", "mp3" })
+    , sortByInodeArg("sort-by-inode", '\0',
+          "processes the files in the order of their inode numbers which usually reduces seeking on rotating disks (waits for the walk to "
+          "finish)")
+    , recursiveArg("recursive", 'r',
+          "opens all files in the specified directories and their subdirectories which look taggable according to their signature; the "
+          "directories are walked in parallel while processing the files",
+          { "dir 1", "dir 2" })
+    , prefetchArg("prefetch", '\0',
+          "opens the specified number of files (8 if none specified) ahead of time and prefetches their beginning and end while the "
+          "current file is processed",
+          { "number" })
+{
+    filesFromArg.setValueCompletionBehavior(ValueCompletionBehavior::Files);
+    extensionsArg.setRequiredValueCount(Argument::varValueCount);
+    recursiveArg.setRequiredValueCount(Argument::varValueCount);
+    recursiveArg.setValueCompletionBehavior(ValueCompletionBehavior::Directories);
+    recursiveArg.setSubArguments({ &extensionsArg, &sortByInodeArg });
+    prefetchArg.setRequiredValueCount(Argument::varValueCount);
+}
+
+SetTagInfoArgs::SetTagInfoArgs(
+    FileListArgs &fileListArgs, Argument &verboseArg, Argument &pedanticArg, Argument &timingsArg, Argument &progressArg, Argument &incrementalArg)
+    : fileListArgs(fileListArgs)
+    , filesArg(fileListArgs.filesArg)
     , verboseArg(verboseArg)
     , pedanticArg(pedanticArg)
+    , timingsArg(timingsArg)
+    , progressArg(progressArg)
+    , incrementalArg(incrementalArg)
     , quietArg("quiet", 'q', "suppress printing progress information")
     , docTitleArg("doc-title", 'd', "specifies the document title (has no affect if not supported by the container)",
           { "title of first segment", "title of second segment" })
@@ -69,6 +102,10 @@ SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argumen
           { "max. padding in byte" })
     , prefPaddingArg("preferred-padding", '\0', "specifies the preferred padding before the media data (used when the file is rewritten)",
           { "preferred padding in byte" })
+    , paddingArg("padding", '\0',
+          "gathers tag sizes and padding of the processed files and prints suggested padding values per container format which keep the "
+          "rate of rewrites below the specified percentage (5 % if none specified); \"auto\" applies the suggestions to subsequent files",
+          { "auto/stats", "percent" })
     , tagPosValueArg("value", '\0', "specifies the position, either front, back or current", { "front/back/current" })
     , forceTagPosArg("force", '\0', "forces the specified position even if the file needs to be rewritten")
     , tagPosArg("tag-pos", '\0', "specifies the preferred tag position")
@@ -94,9 +131,30 @@ SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argumen
           "specifies the delimiter for providing cover type and description after the cover path (defaults to \":\" so the default syntax for cover "
           "values is \"path:cover-type:description\")",
           { "delimiter" })
+    , jobsArg("jobs", '\0',
+          "specifies the number of files to process in parallel (defaults to 1, 0 means one per CPU core); the output is still printed in order",
+          { "number" })
+    , manifestArg("manifest", '\0',
+          "reads the files to be modified and the values to be set for them line by line from the specified TSV or NDJSON file (see README)",
+          { "path" })
+    , fromJsonArg("from-json", '\0',
+          "reads the files to be modified and the values to be set for them from the specified output of the export operation (\"-\" for "
+          "stdin); the records are parsed one after another (see README)",
+          { "path" })
+    , skipUnchangedArg("skip-unchanged", '\0',
+          "skips files which would not be altered because all fields, track properties and the document title already have the specified values")
+    , planArg("plan", '\0',
+          "only predicts whether the changes could be applied in-place or whether files would be rewritten entirely and how many bytes "
+          "would be written; no files are modified")
+    , journalArg("journal", '\0',
+          "records processed files in the specified journal so running the same operation again skips files which have already been "
+          "processed and re-checks files which have been left in the middle of processing (see README)",
+          { "path" })
     , setTagInfoArg("set", 's', "sets the specified tag information and attachments")
 {
     docTitleArg.setRequiredValueCount(Argument::varValueCount);
+    paddingArg.setRequiredValueCount(Argument::varValueCount);
+    paddingArg.setPreDefinedCompletionValues("auto stats");
     id3v1UsageArg.setPreDefinedCompletionValues("always keepexisting never");
     id3v2UsageArg.setPreDefinedCompletionValues("always keepexisting never");
     id3v2VersionArg.setPreDefinedCompletionValues("1 2 3 4");
@@ -131,6 +189,9 @@ SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argumen
     jsArg.setValueCompletionBehavior(ValueCompletionBehavior::Files);
     jsSettingsArg.setValueCompletionBehavior(ValueCompletionBehavior::AppendEquationSign);
     jsSettingsArg.setRequiredValueCount(Argument::varValueCount);
+    manifestArg.setValueCompletionBehavior(ValueCompletionBehavior::Files);
+    fromJsonArg.setValueCompletionBehavior(ValueCompletionBehavior::Files);
+    journalArg.setValueCompletionBehavior(ValueCompletionBehavior::Files);
     setTagInfoArg.setCallback(std::bind(Cli::setTagInfo, std::cref(*this)));
     setTagInfoArg.setExample(PROJECT_NAME
         " set title=\"Title of \"{1st,2nd,3rd}\" file\" title=\"Title of \"{4..16}\"th file\" album=\"The Album\" -f /some/dir/*.m4a\n" PROJECT_NAME
@@ -142,12 +203,14 @@ SetTagInfoArgs::SetTagInfoArgs(Argument &filesArg, Argument &verboseArg, Argumen
         " set mkv:CUSTOM_FIELD=\"Matroska-only\" vorbis:CUSTOM_FIELD=\"Vorbis-only\" mp4:©ust=\"MP4-only\" \\\n"
         "             -f file.mkv file.ogg file.m4a\n"
         "For more examples and detailed descriptions see " APP_URL "#writing-tags");
-    setTagInfoArg.setSubArguments({ &valuesArg, &filesArg, &docTitleArg, &removeOtherFieldsArg, &treatUnknownFilesAsMp3FilesArg, &id3v1UsageArg,
-        &id3v2UsageArg, &id3InitOnCreateArg, &id3TransferOnRemovalArg, &mergeMultipleSuccessiveTagsArg, &id3v2VersionArg, &encodingArg,
-        &removeTargetArg, &addAttachmentArg, &updateAttachmentArg, &removeAttachmentArg, &removeExistingAttachmentsArg, &minPaddingArg,
-        &maxPaddingArg, &prefPaddingArg, &tagPosArg, &indexPosArg, &forceRewriteArg, &backupDirArg, &layoutOnlyArg, &preserveModificationTimeArg,
-        &preserveMuxingAppArg, &preserveWritingAppArg, &preserveTotalFieldsArg, &jsArg, &jsSettingsArg, &coverTypeDelimiterArg, &verboseArg,
-        &pedanticArg, &quietArg, &outputFilesArg });
+    setTagInfoArg.setSubArguments({ &valuesArg, &filesArg, &fileListArgs.filesFromArg, &fileListArgs.nullArg, &fileListArgs.recursiveArg,
+        &docTitleArg, &removeOtherFieldsArg, &treatUnknownFilesAsMp3FilesArg, &id3v1UsageArg, &id3v2UsageArg, &id3InitOnCreateArg,
+        &id3TransferOnRemovalArg, &mergeMultipleSuccessiveTagsArg, &id3v2VersionArg, &encodingArg, &removeTargetArg, &addAttachmentArg,
+        &updateAttachmentArg, &removeAttachmentArg, &removeExistingAttachmentsArg, &minPaddingArg, &maxPaddingArg, &prefPaddingArg, &paddingArg,
+        &tagPosArg, &indexPosArg, &forceRewriteArg, &backupDirArg, &layoutOnlyArg, &preserveModificationTimeArg, &preserveMuxingAppArg,
+        &preserveWritingAppArg, &preserveTotalFieldsArg, &jsArg, &jsSettingsArg, &coverTypeDelimiterArg, &jobsArg, &manifestArg, &fromJsonArg,
+        &skipUnchangedArg, &planArg, &journalArg, &verboseArg, &pedanticArg, &timingsArg, &progressArg, &incrementalArg, &quietArg,
+        &outputFilesArg });
 }
 
 } // namespace Cli
@@ -170,6 +233,25 @@ int main(int argc, char *argv[])
         { "critical/warning/info/debug" });
     pedanticArg.setRequiredValueCount(Argument::varValueCount);
     pedanticArg.setPreDefinedCompletionValues("error warning info debug");
+    // timings option
+    ConfigValueArgument timingsArg("timings", '\0',
+        "records the wall-clock time, the CPU time and the I/O of each processing phase per file and prints them tab-separated followed by "
+        "percentiles over all files (to stderr or to the specified file)",
+        { "path" });
+    timingsArg.setRequiredValueCount(Argument::varValueCount);
+    // progress option
+    ConfigValueArgument progressArg("progress", '\0',
+        "shows the progress of all files (processed files, files and bytes per second and the estimated remaining time) in a status line "
+        "on stderr");
+    // incremental option
+    ConfigValueArgument incrementalArg("incremental", '\0',
+        "skips files which have not been changed since the last run with the same arguments according to the specified state database "
+        "(the output of the last run is used for those files)",
+        { "path" });
+    incrementalArg.setValueCompletionBehavior(ValueCompletionBehavior::Files);
+    // mmap option
+    ConfigValueArgument mmapArg("mmap", '\0',
+        "reads files via a read-only memory mapping instead of buffered reads (attachments are extracted directly from the mapping)");
     // input/output file/files
     ConfigValueArgument fileArg("file", 'f', "specifies the path of the file to be opened", { "path" });
     ConfigValueArgument defaultFileArg(fileArg);
@@ -178,16 +260,23 @@ int main(int argc, char *argv[])
     ConfigValueArgument filesArg("files", 'f', "specifies the path of the file(s) to be opened", { "path 1", "path 2" });
     filesArg.setRequiredValueCount(Argument::varValueCount);
     ConfigValueArgument outputFileArg("output-file", 'o', "specifies the path of the output file", { "path" });
+    Cli::FileListArgs fileListArgs(filesArg);
     // print field names
     OperationArgument printFieldNamesArg("print-field-names", '\0', "lists available field names, track attribute names and modifier");
     printFieldNamesArg.setCallback(Cli::printFieldNames);
     // display general file info
     ConfigValueArgument validateArg(
         "validate", 'c', "validates the file integrity as accurately as possible; the structure of the file will be parsed completely");
+    ConfigValueArgument paddingStatsArg("padding-stats", '\0',
+        "prints histograms of tag sizes and padding per container format and suggests padding values which keep the rate of rewrites below "
+        "the specified percentage (5 % if none specified)",
+        { "percent" });
+    paddingStatsArg.setRequiredValueCount(Argument::varValueCount);
     OperationArgument displayFileInfoArg("info", 'i', "displays general file information", PROJECT_NAME " info -f /some/dir/*.m4a");
-    displayFileInfoArg.setCallback(
-        std::bind(Cli::displayFileInfo, _1, std::cref(filesArg), std::cref(verboseArg), std::cref(pedanticArg), std::cref(validateArg)));
-    displayFileInfoArg.setSubArguments({ &filesArg, &validateArg, &verboseArg, &pedanticArg });
+    displayFileInfoArg.setCallback(std::bind(Cli::displayFileInfo, _1, std::cref(fileListArgs), std::cref(verboseArg), std::cref(pedanticArg),
+        std::cref(validateArg), std::cref(paddingStatsArg), std::cref(timingsArg), std::cref(progressArg), std::cref(mmapArg)));
+    displayFileInfoArg.setSubArguments({ &filesArg, &fileListArgs.filesFromArg, &fileListArgs.nullArg, &fileListArgs.recursiveArg,
+        &fileListArgs.prefetchArg, &validateArg, &paddingStatsArg, &verboseArg, &pedanticArg, &timingsArg, &progressArg, &mmapArg });
     // display tag info
     ConfigValueArgument fieldsArg("fields", 'n', "specifies the field names to be displayed", { "title", "album", "artist", "trackpos" });
     fieldsArg.setRequiredValueCount(Argument::varValueCount);
@@ -196,32 +285,89 @@ int main(int argc, char *argv[])
     OperationArgument displayTagInfoArg("get", 'g', "displays the values of all specified tag fields (displays all fields if none specified)",
         PROJECT_NAME " get title album artist -f /some/dir/*.m4a");
     ConfigValueArgument showUnsupportedArg("show-unsupported", 'u', "shows unsupported fields (has only effect when no field names specified)");
-    displayTagInfoArg.setCallback(std::bind(Cli::displayTagInfo, std::cref(fieldsArg), std::cref(showUnsupportedArg), std::cref(filesArg),
-        std::cref(verboseArg), std::cref(pedanticArg)));
-    displayTagInfoArg.setSubArguments({ &fieldsArg, &showUnsupportedArg, &filesArg, &verboseArg, &pedanticArg });
+    ConfigValueArgument formatArg("format", '\0',
+        "prints a record per file with a column for each field in the specified machine-readable format instead of the human-readable listing",
+        { "tsv/csv/ndjson" });
+    formatArg.setPreDefinedCompletionValues("tsv csv ndjson");
+    ConfigValueArgument perTagArg("per-tag", '\0', "prints a record per tag (with the tag name as second column) instead of per file");
+    formatArg.setSubArguments({ &perTagArg });
+    displayTagInfoArg.setCallback(std::bind(Cli::displayTagInfo, std::cref(fieldsArg), std::cref(showUnsupportedArg), std::cref(formatArg),
+        std::cref(perTagArg), std::cref(fileListArgs), std::cref(verboseArg), std::cref(pedanticArg), std::cref(timingsArg), std::cref(progressArg),
+        std::cref(incrementalArg), std::cref(mmapArg)));
+    displayTagInfoArg.setSubArguments({ &fieldsArg, &showUnsupportedArg, &formatArg, &filesArg, &fileListArgs.filesFromArg, &fileListArgs.nullArg,
+        &fileListArgs.recursiveArg, &fileListArgs.prefetchArg, &verboseArg, &pedanticArg, &timingsArg, &progressArg, &incrementalArg, &mmapArg });
     // set tag info
-    Cli::SetTagInfoArgs setTagInfoArgs(filesArg, verboseArg, pedanticArg);
+    Cli::SetTagInfoArgs setTagInfoArgs(fileListArgs, verboseArg, pedanticArg, timingsArg, progressArg, incrementalArg);
     // extract cover
     ConfigValueArgument fieldArg("field", 'n', "specifies the field to be extracted", { "field name" });
     fieldArg.setImplicit(true);
     ConfigValueArgument attachmentArg("attachment", 'a', "specifies the attachment to be extracted", { "id=..." });
     ConfigValueArgument indexArg("index", 'i', "specifies the value/attachment to extract by its index, e.g. 0 for the first value", { "0/1/2/..." });
+    ConfigValueArgument extractFilesArg("file", 'f', "specifies the path of the file(s) to extract from", { "path 1", "path 2" });
+    extractFilesArg.setRequiredValueCount(Argument::varValueCount);
+    extractFilesArg.setRequired(true);
+    ConfigValueArgument outputDirArg("output-dir", '\0',
+        "stores the values of all specified files once per distinct content in the specified directory (named by their SHA-256) or the "
+        "attachments under their name and writes \"index.tsv\" mapping the files to the stored values/attachments",
+        { "path" });
+    outputDirArg.setValueCompletionBehavior(ValueCompletionBehavior::Directories);
+    ConfigValueArgument dedupArg("dedup", '\0', "stores attachments once per distinct content (named by their SHA-256) as well");
+    outputDirArg.setSubArguments({ &dedupArg });
     OperationArgument extractFieldArg("extract", 'e',
         "saves the value of the specified field (e.g. cover or other binary field) or attachment to the specified file or writes it to stdout if no "
         "output file has been specified");
-    extractFieldArg.setSubArguments({ &fieldArg, &attachmentArg, &indexArg, &fileArg, &outputFileArg, &verboseArg });
-    extractFieldArg.setExample(PROJECT_NAME " extract cover --output-file the-cover.jpg --file some-file.opus");
-    extractFieldArg.setCallback(std::bind(Cli::extractField, std::cref(fieldArg), std::cref(attachmentArg), std::cref(fileArg),
-        std::cref(outputFileArg), std::cref(indexArg), std::cref(verboseArg)));
+    extractFieldArg.setSubArguments({ &fieldArg, &attachmentArg, &indexArg, &extractFilesArg, &outputFileArg, &outputDirArg, &verboseArg,
+        &timingsArg, &progressArg, &mmapArg });
+    extractFieldArg.setExample(PROJECT_NAME " extract cover --output-file the-cover.jpg --file some-file.opus\n" PROJECT_NAME
+                                            " extract cover --output-dir covers --file /some/dir/*.mp3\n" PROJECT_NAME
+                                            " extract --attachment name=font.ttf --output-dir fonts --dedup --file /some/dir/*.mkv");
+    extractFieldArg.setCallback(std::bind(Cli::extractField, std::cref(fieldArg), std::cref(attachmentArg), std::cref(extractFilesArg),
+        std::cref(outputFileArg), std::cref(outputDirArg), std::cref(dedupArg), std::cref(indexArg), std::cref(verboseArg), std::cref(timingsArg),
+        std::cref(progressArg), std::cref(mmapArg)));
     // export to JSON
     ConfigValueArgument prettyArg("pretty", '\0', "prints with indentation and spacing");
+    ConfigValueArgument ndjsonArg("ndjson", '\0', "prints one JSON object per line (NDJSON) instead of an array");
+    ConfigValueArgument blobsArg("blobs", '\0',
+        "stores covers and other binary values once per distinct content in the specified directory and only references them by their "
+        "SHA-256 digest (or only prints the digest if \"hash-only\" is specified) instead of embedding them as Base64",
+        { "directory/hash-only" });
+    blobsArg.setValueCompletionBehavior(ValueCompletionBehavior::Directories | ValueCompletionBehavior::PreDefinedValues);
+    blobsArg.setPreDefinedCompletionValues("hash-only");
     OperationArgument exportArg("export", 'j', "exports the tag information for the specified files to JSON");
-    exportArg.setSubArguments({ &filesArg, &prettyArg });
-    exportArg.setCallback(std::bind(Cli::exportToJson, _1, std::cref(filesArg), std::cref(prettyArg)));
+    exportArg.setSubArguments({ &filesArg, &fileListArgs.filesFromArg, &fileListArgs.nullArg, &fileListArgs.recursiveArg,
+        &fileListArgs.prefetchArg, &prettyArg, &ndjsonArg, &blobsArg, &setTagInfoArgs.jobsArg, &timingsArg, &progressArg, &incrementalArg,
+        &mmapArg });
+    exportArg.setCallback(std::bind(Cli::exportToJson, _1, std::cref(fileListArgs), std::cref(prettyArg), std::cref(ndjsonArg),
+        std::cref(blobsArg), std::cref(setTagInfoArgs.jobsArg), std::cref(timingsArg), std::cref(progressArg), std::cref(incrementalArg),
+        std::cref(mmapArg)));
+    // verify files
+    ConfigValueArgument readAheadArg("read-ahead", '\0',
+        "specifies how many MiB of the files are read ahead sequentially before they are parsed (defaults to 1024, 0 disables reading "
+        "files ahead so each job reads its file on its own)",
+        { "MiB" });
+    OperationArgument verifyArg("verify", '\0',
+        "validates the integrity of the specified files (like info --validate) and prints a line with the result (pass/warn/fail) and the "
+        "relevant diagnostic messages per file",
+        PROJECT_NAME " verify --jobs 0 --recursive /some/archive");
+    verifyArg.setSubArguments({ &filesArg, &fileListArgs.filesFromArg, &fileListArgs.nullArg, &fileListArgs.recursiveArg,
+        &setTagInfoArgs.jobsArg, &readAheadArg, &verboseArg, &timingsArg, &progressArg, &mmapArg });
+    verifyArg.setCallback(std::bind(Cli::verifyFiles, _1, std::cref(fileListArgs), std::cref(setTagInfoArgs.jobsArg), std::cref(readAheadArg),
+        std::cref(verboseArg), std::cref(timingsArg), std::cref(progressArg), std::cref(mmapArg)));
     // file info
     OperationArgument genInfoArg("html-info", '\0', "generates technical information about the specified file as HTML document");
     genInfoArg.setSubArguments({ &fileArg, &validateArg, &outputFileArg });
     genInfoArg.setCallback(std::bind(Cli::generateFileInfo, _1, std::cref(fileArg), std::cref(outputFileArg), std::cref(validateArg)));
+    // serve requests
+    ConfigValueArgument socketArg("socket", '\0', "specifies the path of the Unix domain socket to listen on", { "path" });
+    socketArg.setRequired(true);
+    socketArg.setValueCompletionBehavior(ValueCompletionBehavior::Files);
+    ConfigValueArgument serveJobsArg("jobs", '\0',
+        "specifies the number of requests to process in parallel (defaults to 0 which means one per CPU core)", { "number" });
+    OperationArgument serveArg("serve", '\0',
+        "serves info/get/set/extract requests received as length-prefixed JSON via a Unix domain socket until stopped (see README)",
+        PROJECT_NAME " serve --socket /run/user/1000/tageditor.sock");
+    serveArg.setSubArguments({ &socketArg, &serveJobsArg });
+    serveArg.setCallback(std::bind(Cli::serve, std::ref(parser), std::cref(socketArg), std::cref(serveJobsArg)));
     // renaming utility
     ConfigValueArgument renamingUtilityArg("renaming-utility", '\0', "launches the renaming utility instead of the main GUI");
     // set arguments to parser
@@ -229,7 +375,8 @@ int main(int argc, char *argv[])
     qtConfigArgs.qtWidgetsGuiArg().addSubArgument(&defaultFileArg);
     qtConfigArgs.qtWidgetsGuiArg().addSubArgument(&renamingUtilityArg);
     parser.setMainArguments({ &qtConfigArgs.qtWidgetsGuiArg(), &printFieldNamesArg, &displayFileInfoArg, &displayTagInfoArg,
-        &setTagInfoArgs.setTagInfoArg, &extractFieldArg, &exportArg, &genInfoArg, &timeSpanFormatArg, &parser.noColorArg(), &parser.helpArg() });
+        &setTagInfoArgs.setTagInfoArg, &extractFieldArg, &exportArg, &verifyArg, &genInfoArg, &serveArg, &timeSpanFormatArg, &parser.noColorArg(),
+        &parser.helpArg() });
     // parse given arguments
     parser.parseArgs(argc, argv, ParseArgumentBehavior::CheckConstraints | ParseArgumentBehavior::ExitOnFailure);
 
@@ -0,0 +1,168 @@
+#include "./batchprocessor.h"
+#include "./helper.h"
+
+#include <c++utilities/application/argumentparser.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace Cli {
+
+/*!
+ * \class BatchProcessor
+ * \brief The BatchProcessor class processes a sequence of items (usually files) using a pool of worker threads.
+ *
+ * Processing an item is split into three steps:
+ * 1. prepare: Assigns the next item to a slot. Invoked for one item after another in order and never concurrently,
+ *    so it may advance state which depends on the order of the items (e.g. auto-incremented field values).
+ * 2. process: Does the actual work. Invoked concurrently from the worker threads. Workers grab the next item as soon
+ *    as they are done with the previous one so slow files don't hold up the other workers.
+ * 3. emit: Prints/consumes the results. Invoked on the thread calling run() in the order the items have been
+ *    prepared, so output remains grouped per item and in input order.
+ *
+ * If only one job has been requested, everything happens on the calling thread one item after another.
+ */
+
+BatchProcessor::BatchProcessor(std::size_t jobs)
+    : m_jobs(jobs ? jobs : 1)
+    , m_aborted(false)
+{
+}
+
+/*!
+ * \brief Processes items until \a prepare returns false or the batch has been aborted.
+ * \remarks If a callback throws, the batch is aborted and the exception is re-thrown after all workers have stopped. Items
+ *          which have already been processed are still emitted.
+ */
+void BatchProcessor::run(const PrepareFunction &prepare, const ProcessFunction &process, const EmitFunction &emit)
+{
+    if (!isParallel()) {
+        for (auto itemIndex = std::size_t(); !isAborted() && prepare(itemIndex, 0); ++itemIndex) {
+            process(0, 0);
+            emit(0);
+        }
+        return;
+    }
+
+    enum class SlotState { Free, Processing, Done };
+    const auto slots = slotCount();
+    auto slotStates = std::vector<SlotState>(slots, SlotState::Free);
+    auto mutex = std::mutex();
+    auto stateChanged = std::condition_variable();
+    auto preparedItems = std::size_t(), emittedItems = std::size_t();
+    auto noMoreItems = false;
+    auto exception = std::exception_ptr();
+    // use a timeout when waiting so an abort requested via signal handler (which can not notify) is noticed
+    constexpr auto pollInterval = std::chrono::milliseconds(100);
+
+    const auto work = [&](std::size_t workerIndex) {
+        for (;;) {
+            auto lock = std::unique_lock<std::mutex>(mutex);
+            while (!noMoreItems && !isAborted() && preparedItems - emittedItems >= slots) {
+                stateChanged.wait_for(lock, pollInterval);
+            }
+            if (noMoreItems || isAborted()) {
+                return;
+            }
+            const auto slot = preparedItems % slots;
+            try {
+                if (!prepare(preparedItems, slot)) {
+                    noMoreItems = true;
+                    stateChanged.notify_all();
+                    return;
+                }
+            } catch (...) {
+                exception = std::current_exception();
+                noMoreItems = true;
+                abort();
+                stateChanged.notify_all();
+                return;
+            }
+            ++preparedItems;
+            slotStates[slot] = SlotState::Processing;
+            lock.unlock();
+
+            try {
+                process(workerIndex, slot);
+            } catch (...) {
+                lock.lock();
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                abort();
+                lock.unlock();
+            }
+
+            lock.lock();
+            slotStates[slot] = SlotState::Done;
+            stateChanged.notify_all();
+        }
+    };
+
+    auto workers = std::vector<std::thread>();
+    workers.reserve(m_jobs);
+    for (auto workerIndex = std::size_t(); workerIndex != m_jobs; ++workerIndex) {
+        workers.emplace_back(work, workerIndex);
+    }
+
+    // emit results in order as they become available
+    for (;;) {
+        auto lock = std::unique_lock<std::mutex>(mutex);
+        const auto slot = emittedItems % slots;
+        while (!(emittedItems < preparedItems && slotStates[slot] == SlotState::Done)
+            && !(emittedItems == preparedItems && (noMoreItems || isAborted()))) {
+            stateChanged.wait_for(lock, pollInterval);
+        }
+        if (emittedItems == preparedItems) {
+            // abort() might have been called before any worker had a chance to notice
+            noMoreItems = true;
+            stateChanged.notify_all();
+            break;
+        }
+        lock.unlock();
+        try {
+            emit(slot);
+        } catch (...) {
+            lock.lock();
+            if (!exception) {
+                exception = std::current_exception();
+            }
+            abort();
+            lock.unlock();
+        }
+        lock.lock();
+        slotStates[slot] = SlotState::Free;
+        ++emittedItems;
+        stateChanged.notify_all();
+    }
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+/*!
+ * \brief Returns the number of jobs specified via \a jobsArg.
+ * \remarks Returns \a defaultJobs if \a jobsArg is not present and the number of hardware threads if it is set to 0.
+ */
+std::size_t parseJobCount(const Argument &jobsArg, std::uint64_t defaultJobs)
+{
+    const auto jobs = parseUInt64(jobsArg, defaultJobs);
+    if (jobs) {
+        return static_cast<std::size_t>(jobs);
+    }
+    const auto hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads ? hardwareThreads : 1;
+}
+
+} // namespace Cli
@@ -0,0 +1,73 @@
+#ifndef CLI_BATCH_PROCESSOR
+#define CLI_BATCH_PROCESSOR
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace CppUtilities {
+class Argument;
+}
+
+namespace Cli {
+
+class BatchProcessor {
+public:
+    using PrepareFunction = std::function<bool(std::size_t itemIndex, std::size_t slot)>;
+    using ProcessFunction = std::function<void(std::size_t workerIndex, std::size_t slot)>;
+    using EmitFunction = std::function<void(std::size_t slot)>;
+
+    explicit BatchProcessor(std::size_t jobs = 1);
+    std::size_t jobs() const;
+    std::size_t slotCount() const;
+    bool isParallel() const;
+    bool isAborted() const;
+    void abort();
+    void run(const PrepareFunction &prepare, const ProcessFunction &process, const EmitFunction &emit);
+
+private:
+    std::size_t m_jobs;
+    std::atomic_bool m_aborted;
+};
+
+inline std::size_t BatchProcessor::jobs() const
+{
+    return m_jobs;
+}
+
+/*!
+ * \brief Returns the number of slots the caller needs to provide storage for.
+ * \remarks An item is assigned to a slot when it is prepared and the slot is only re-used after the item
+ *          has been emitted. So at most slotCount() items are "in flight" at the same time which keeps the
+ *          memory usage bounded, regardless of how many items there are.
+ */
+inline std::size_t BatchProcessor::slotCount() const
+{
+    return m_jobs > 1 ? m_jobs * 2 : 1;
+}
+
+inline bool BatchProcessor::isParallel() const
+{
+    return m_jobs > 1;
+}
+
+inline bool BatchProcessor::isAborted() const
+{
+    return m_aborted.load();
+}
+
+/*!
+ * \brief Prevents further items from being prepared; items already in flight will still be processed and emitted.
+ * \remarks Only sets an atomic flag so it is safe to call this function from within a signal handler.
+ */
+inline void BatchProcessor::abort()
+{
+    m_aborted.store(true);
+}
+
+std::size_t parseJobCount(const CppUtilities::Argument &jobsArg, std::uint64_t defaultJobs = 1);
+
+} // namespace Cli
+
+#endif // CLI_BATCH_PROCESSOR
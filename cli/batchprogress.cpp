@@ -0,0 +1,201 @@
+#include "./batchprogress.h"
+
+#include <c++utilities/chrono/timespan.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/path.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace TagParser;
+
+namespace Cli {
+
+/*!
+ * \class BatchProgress
+ * \brief The BatchProgress class combines the progress of all files of a batch into a single status line.
+ *
+ * The status line shows the number of processed files, the throughput in files and bytes per second and the estimated
+ * remaining time. The progress of files currently being processed is taken into account via the progress feedback returned
+ * by feedback() so the estimation does not stall while processing big files. If the total size of the files is known, the
+ * remaining time is estimated from the number of remaining bytes; otherwise it is estimated from the number of remaining
+ * files. If the number of files is not known at all (e.g. when reading them from a manifest) no estimation is shown.
+ *
+ * The status line is written to stderr and redrawn at most every 250 milliseconds so printing it does not slow down the
+ * processing. All functions may be called from multiple threads at the same time. Redrawing is simply skipped if another
+ * thread is currently updating the status line.
+ */
+
+/*!
+ * \brief Constructs a new progress for \a fileCount files with a total size of \a totalSize bytes processed by \a workerCount
+ *        workers.
+ * \remarks Pass zero as \a fileCount or \a totalSize if the value is not known.
+ */
+BatchProgress::BatchProgress(std::size_t fileCount, std::uint64_t totalSize, std::size_t workerCount)
+    : m_out(std::cerr)
+    , m_workers(std::max<std::size_t>(workerCount, 1))
+    , m_fileCount(fileCount)
+    , m_finishedFiles(0)
+    , m_totalSize(totalSize)
+    , m_finishedSize(0)
+    , m_startTime(Clock::now())
+    , m_lastDrawTime()
+    , m_lineLength(0)
+{
+}
+
+/*!
+ * \brief Returns a progress feedback forwarding the progress of the file the specified worker is processing.
+ */
+AbortableProgressFeedback BatchProgress::feedback(std::size_t workerIndex)
+{
+    const auto update = [this, workerIndex](AbortableProgressFeedback &progress) { updateFile(workerIndex, progress.overallPercentage()); };
+    return AbortableProgressFeedback(update, update);
+}
+
+/*!
+ * \brief Marks the start of processing a file with the specified \a size by the worker with the specified \a workerIndex.
+ */
+void BatchProgress::startFile(std::size_t workerIndex, std::uint64_t size)
+{
+    auto lock = std::unique_lock<std::mutex>(m_mutex);
+    auto &worker = m_workers[workerIndex];
+    worker.size = size;
+    worker.fraction = 0.0;
+    worker.active = true;
+    draw(false);
+}
+
+/*!
+ * \brief Updates the progress of the file the worker with the specified \a workerIndex is processing.
+ * \remarks The progress of a file never decreases as some operations (e.g. parsing and applying changes) report their
+ *          progress separately.
+ */
+void BatchProgress::updateFile(std::size_t workerIndex, std::uint8_t percentage)
+{
+    auto lock = std::unique_lock<std::mutex>(m_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+    auto &worker = m_workers[workerIndex];
+    worker.fraction = std::max(worker.fraction, std::min(percentage, std::uint8_t(100)) / 100.0);
+    draw(false);
+}
+
+/*!
+ * \brief Marks the file the worker with the specified \a workerIndex is processing as finished.
+ * \remarks Files which have not been started (e.g. because they could not be opened) are counted as well.
+ */
+void BatchProgress::finishFile(std::size_t workerIndex)
+{
+    auto lock = std::unique_lock<std::mutex>(m_mutex);
+    auto &worker = m_workers[workerIndex];
+    ++m_finishedFiles;
+    if (worker.active) {
+        m_finishedSize += worker.size;
+        worker = Worker();
+    }
+    draw(false);
+}
+
+/*!
+ * \brief Clears the status line so other output can be printed; it is redrawn on the next update.
+ * \returns Returns a lock which prevents the status line from being redrawn (by other threads) as long as it is held.
+ * \remarks The lock must be released before calling any other function of the progress on the same thread.
+ */
+std::unique_lock<std::mutex> BatchProgress::clearLine()
+{
+    auto lock = std::unique_lock<std::mutex>(m_mutex);
+    if (m_lineLength) {
+        m_out << '\r' << std::string(m_lineLength, ' ') << '\r' << std::flush;
+        m_lineLength = 0;
+        m_lastDrawTime = Clock::time_point();
+    }
+    return lock;
+}
+
+/*!
+ * \brief Draws the final status line and terminates it.
+ */
+void BatchProgress::finish()
+{
+    auto lock = std::unique_lock<std::mutex>(m_mutex);
+    draw(true);
+    m_out << std::endl;
+    m_lineLength = 0;
+}
+
+/*!
+ * \brief Returns the total size of the files with the specified \a paths; files which can not be accessed are ignored.
+ */
+std::uint64_t BatchProgress::totalSize(const std::vector<const char *> &paths)
+{
+    auto size = std::uint64_t();
+    auto error = std::error_code();
+    for (const auto *const path : paths) {
+        if (const auto fileSize = std::filesystem::file_size(makeNativePath(path), error); !error) {
+            size += fileSize;
+        }
+    }
+    return size;
+}
+
+void BatchProgress::draw(bool force)
+{
+    const auto now = Clock::now();
+    if (!force && now - m_lastDrawTime < redrawInterval) {
+        return;
+    }
+    m_lastDrawTime = now;
+
+    // determine processed files and bytes including the portion of files currently being processed
+    auto processedFiles = static_cast<double>(m_finishedFiles);
+    auto processedSize = static_cast<double>(m_finishedSize);
+    for (const auto &worker : m_workers) {
+        if (worker.active) {
+            processedFiles += worker.fraction;
+            processedSize += worker.fraction * static_cast<double>(worker.size);
+        }
+    }
+    const auto elapsedSeconds = std::chrono::duration<double>(now - m_startTime).count();
+    const auto filesPerSecond = elapsedSeconds > 0.0 ? processedFiles / elapsedSeconds : 0.0;
+    const auto bytesPerSecond = elapsedSeconds > 0.0 ? processedSize / elapsedSeconds : 0.0;
+
+    // compose status line
+    auto line = std::ostringstream();
+    line << std::fixed << std::setprecision(1) << " - [" << m_finishedFiles;
+    if (m_fileCount) {
+        line << '/' << m_fileCount << " files, " << std::min(processedFiles / static_cast<double>(m_fileCount) * 100.0, 100.0) << " %] ";
+    } else {
+        line << " files] ";
+    }
+    line << filesPerSecond << " files/s, " << dataSizeToString(static_cast<std::uint64_t>(bytesPerSecond)) << "/s";
+    auto remainingSeconds = -1.0;
+    if (m_totalSize && bytesPerSecond > 0.0) {
+        remainingSeconds = std::max(static_cast<double>(m_totalSize) - processedSize, 0.0) / bytesPerSecond;
+    } else if (m_fileCount && filesPerSecond > 0.0) {
+        remainingSeconds = std::max(static_cast<double>(m_fileCount) - processedFiles, 0.0) / filesPerSecond;
+    }
+    if (force) {
+        line << ", took " << TimeSpan::fromSeconds(elapsedSeconds).toString(TimeSpanOutputFormat::WithMeasures, true);
+    } else if (remainingSeconds >= 0.0) {
+        line << ", ETA " << TimeSpan::fromSeconds(remainingSeconds).toString(TimeSpanOutputFormat::WithMeasures, true);
+    }
+
+    // overwrite the previous status line
+    const auto text = line.str();
+    m_out << '\r' << text;
+    if (text.size() < m_lineLength) {
+        m_out << std::string(m_lineLength - text.size(), ' ');
+    }
+    m_out << std::flush;
+    m_lineLength = text.size();
+}
+
+} // namespace Cli
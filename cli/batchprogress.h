@@ -0,0 +1,52 @@
+#ifndef CLI_BATCH_PROGRESS
+#define CLI_BATCH_PROGRESS
+
+#include <tagparser/progressfeedback.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace Cli {
+
+class BatchProgress {
+public:
+    explicit BatchProgress(std::size_t fileCount, std::uint64_t totalSize, std::size_t workerCount = 1);
+    TagParser::AbortableProgressFeedback feedback(std::size_t workerIndex);
+    void startFile(std::size_t workerIndex, std::uint64_t size);
+    void updateFile(std::size_t workerIndex, std::uint8_t percentage);
+    void finishFile(std::size_t workerIndex);
+    std::unique_lock<std::mutex> clearLine();
+    void finish();
+
+    static std::uint64_t totalSize(const std::vector<const char *> &paths);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Worker {
+        std::uint64_t size = 0;
+        double fraction = 0.0;
+        bool active = false;
+    };
+    static constexpr auto redrawInterval = std::chrono::milliseconds(250);
+
+    void draw(bool force);
+
+    std::mutex m_mutex;
+    std::ostream &m_out;
+    std::vector<Worker> m_workers;
+    std::size_t m_fileCount;
+    std::size_t m_finishedFiles;
+    std::uint64_t m_totalSize;
+    std::uint64_t m_finishedSize;
+    Clock::time_point m_startTime;
+    Clock::time_point m_lastDrawTime;
+    std::size_t m_lineLength;
+};
+
+} // namespace Cli
+
+#endif // CLI_BATCH_PROGRESS
@@ -0,0 +1,117 @@
+#include "./blobstore.h"
+#include "./sha256.h"
+
+#include <c++utilities/io/nativefilestream.h>
+#include <c++utilities/io/path.h>
+
+#include <filesystem>
+#include <ios>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace Cli {
+
+/*!
+ * \class BlobStore
+ * \brief The BlobStore class stores binary data (e.g. covers) content-addressed within a directory.
+ *
+ * Each distinct payload is stored once as "<first two digits of digest>/<digest>" within the directory where the digest is the
+ * SHA-256 of the data as lower-case hex string. Data which is already present (also from previous runs) is not written again so
+ * identical covers of many files only take space once. If no directory has been specified, only digests are computed.
+ *
+ * Blobs are written to a temporary file first and renamed afterwards so the directory never contains partially written blobs.
+ * It is safe to store data from multiple threads concurrently.
+ */
+
+/*!
+ * \brief Constructs a store for the specified \a directory; only digests are computed if \a directory is empty.
+ */
+BlobStore::BlobStore(std::string_view directory)
+    : m_directory(directory)
+{
+}
+
+/*!
+ * \brief Stores the specified \a data unless it is already present.
+ * \returns Returns the digest of \a data.
+ * \throws Throws std::ios_base::failure or std::filesystem::filesystem_error when an IO error occurs.
+ */
+std::string BlobStore::store(std::string_view data)
+{
+    auto digest = Sha256::hexDigest(data);
+    if (!isHashOnly()) {
+        store(digest, [data](const std::string &tempPath) {
+            auto file = NativeFileStream();
+            file.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+            file.open(tempPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            file.close();
+        });
+    }
+    return digest;
+}
+
+/*!
+ * \brief Stores the data with the specified \a digest unless it is already present.
+ *
+ * The callback \a write is supposed to write the data to the path it is given. This allows the caller to write data which is
+ * not present in memory, e.g. by copying it from another file within the kernel.
+ *
+ * \returns Returns whether \a write has been invoked (and the blob has therefore been added).
+ * \throws Throws std::ios_base::failure or std::filesystem::filesystem_error when an IO error occurs; exceptions thrown by
+ *         \a write are passed as well.
+ * \remarks Must not be called if only digests are computed.
+ */
+bool BlobStore::store(const std::string &digest, const std::function<void(const std::string &)> &write)
+{
+    {
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        if (!m_storedDigests.emplace(digest).second) {
+            return false;
+        }
+    }
+    try {
+        const auto blobPath = std::filesystem::path(makeNativePath(path(digest)));
+        if (std::filesystem::exists(blobPath)) {
+            return false;
+        }
+        std::filesystem::create_directories(blobPath.parent_path());
+        auto tempPath = blobPath;
+        tempPath += ".tmp";
+        write(tempPath.string());
+        std::filesystem::rename(tempPath, blobPath);
+    } catch (...) {
+        const auto lock = std::lock_guard<std::mutex>(m_mutex);
+        m_storedDigests.erase(digest);
+        throw;
+    }
+    return true;
+}
+
+/*!
+ * \brief Returns the path of the blob with the specified \a digest.
+ */
+std::string BlobStore::path(std::string_view digest) const
+{
+    auto path = m_directory;
+    if (!path.empty() && path.back() != '/') {
+        path += '/';
+    }
+    return path += relativePath(digest);
+}
+
+/*!
+ * \brief Returns the path of the blob with the specified \a digest relative to the directory of the store.
+ */
+std::string BlobStore::relativePath(std::string_view digest)
+{
+    auto path = std::string();
+    path.reserve(digest.size() + 3);
+    path += digest.substr(0, 2);
+    path += '/';
+    path += digest;
+    return path;
+}
+
+} // namespace Cli
@@ -0,0 +1,47 @@
+#ifndef CLI_BLOB_STORE
+#define CLI_BLOB_STORE
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace Cli {
+
+class BlobStore {
+public:
+    explicit BlobStore(std::string_view directory = std::string_view());
+
+    bool isHashOnly() const;
+    const std::string &directory() const;
+    std::string store(std::string_view data);
+    bool store(const std::string &digest, const std::function<void(const std::string &)> &write);
+    std::string path(std::string_view digest) const;
+    static std::string relativePath(std::string_view digest);
+
+private:
+    std::string m_directory;
+    std::mutex m_mutex;
+    std::unordered_set<std::string> m_storedDigests;
+};
+
+/*!
+ * \brief Returns whether only digests are computed without storing any data.
+ */
+inline bool BlobStore::isHashOnly() const
+{
+    return m_directory.empty();
+}
+
+/*!
+ * \brief Returns the directory blobs are stored in; empty if only digests are computed.
+ */
+inline const std::string &BlobStore::directory() const
+{
+    return m_directory;
+}
+
+} // namespace Cli
+
+#endif // CLI_BLOB_STORE
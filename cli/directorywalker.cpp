@@ -0,0 +1,369 @@
+#include "./directorywalker.h"
+
+#include <tagparser/signature.h>
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/io/nativefilestream.h>
+
+#ifdef PLATFORM_UNIX
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#include <system_error>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <ios>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace TagParser;
+
+namespace Cli {
+
+/// \cond
+constexpr auto maxQueuedFiles = std::size_t(1024);
+constexpr auto signatureSize = std::size_t(16);
+
+static bool isTaggableFormat(ContainerFormat format)
+{
+    switch (format) {
+    case ContainerFormat::Adts:
+    case ContainerFormat::Ebml:
+    case ContainerFormat::Flac:
+    case ContainerFormat::Id3v2Tag:
+    case ContainerFormat::Matroska:
+    case ContainerFormat::Mp4:
+    case ContainerFormat::MpegAudioFrames:
+    case ContainerFormat::Ogg:
+    case ContainerFormat::QuickTime:
+    case ContainerFormat::RiffWave:
+    case ContainerFormat::Webm:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static std::string joinPath(const std::string &directory, std::string_view name)
+{
+    auto path = std::string();
+    path.reserve(directory.size() + name.size() + 1);
+    path.append(directory);
+    if (!path.empty() && path.back() != '/') {
+        path += '/';
+    }
+    path.append(name);
+    return path;
+}
+
+static std::string lowerCase(std::string_view str)
+{
+    auto lower = std::string(str);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower;
+}
+/// \endcond
+
+/*!
+ * \class DirectoryWalker
+ * \brief The DirectoryWalker class walks directory trees in parallel and provides the paths of all files which look taggable.
+ *
+ * Worker threads take directories from a shared queue, read them and add their subdirectories to the queue again. On Unix
+ * directories are read via readdir() relying on the file type it returns (so files are usually not stat'ed separately) and
+ * files are opened via openat() relative to the directory which has been read. Files are skipped unless their extension is
+ * one of the specified extensions (if any have been specified) and unless the first bytes of the file denote a container
+ * format tags can be read from. Symbolic links to files are followed but symbolic links to directories are not (to avoid
+ * cycles). Further hard and symbolic links to a file which has already been found are skipped as well; therefore the device
+ * and inode of every found file are recorded (a symbolic link and its target have a link count of one, so the link count can
+ * not be used to limit this to hard links).
+ *
+ * The found paths are buffered in a bounded queue which is drained via next() while the walk is still ongoing. So the
+ * processing of the files overlaps with the walk. When sorting by inode is requested, next() waits for the walk to finish
+ * instead and returns the paths in the order of their inode numbers (which roughly corresponds to their location on disk for
+ * many file systems).
+ */
+
+/*!
+ * \brief Starts walking the specified \a directories using \a threadCount threads (one per CPU core if 0).
+ * \remarks Extensions are compared case-insensitively and may be specified with or without leading dot.
+ */
+DirectoryWalker::DirectoryWalker(
+    const std::vector<const char *> &directories, const std::vector<const char *> &extensions, bool sortByInode, std::size_t threadCount)
+    : m_sortByInode(sortByInode)
+    , m_sorted(false)
+    , m_aborted(false)
+    , m_busyThreads(0)
+    , m_directories(directories.begin(), directories.end())
+{
+    m_extensions.reserve(extensions.size());
+    for (const auto *const value : extensions) {
+        auto extension = std::string_view(value);
+        if (!extension.empty() && extension.front() == '.') {
+            extension.remove_prefix(1);
+        }
+        if (!extension.empty()) {
+            m_extensions.emplace_back(lowerCase(extension));
+        }
+    }
+    if (!threadCount) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    m_threads.reserve(threadCount);
+    for (; threadCount; --threadCount) {
+        m_threads.emplace_back(&DirectoryWalker::work, this);
+    }
+}
+
+/*!
+ * \brief Aborts the walk (if still ongoing) and waits for the worker threads to finish.
+ */
+DirectoryWalker::~DirectoryWalker()
+{
+    {
+        auto lock = std::unique_lock(m_mutex);
+        m_aborted = true;
+    }
+    m_directoriesChanged.notify_all();
+    m_filesChanged.notify_all();
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+/*!
+ * \brief Assigns the next path to \a path; blocks until a path is available or the walk has finished.
+ * \returns Returns whether a path has been assigned; returns false if all paths have been returned.
+ * \throws Throws WalkError when a directory or file could not be read. The walk goes on nevertheless so next() can be called
+ *         again to obtain further paths.
+ */
+bool DirectoryWalker::next(std::string &path)
+{
+    auto lock = std::unique_lock(m_mutex);
+    m_filesChanged.wait(lock, [this] { return !m_errors.empty() || (!m_sortByInode && !m_files.empty()) || isDone(); });
+    if (!m_errors.empty()) {
+        auto error = WalkError(m_errors.front());
+        m_errors.pop_front();
+        throw error;
+    }
+    if (m_sortByInode && !m_sorted) {
+        std::stable_sort(m_files.begin(), m_files.end(), [](const File &lhs, const File &rhs) { return lhs.inode < rhs.inode; });
+        m_sorted = true;
+    }
+    if (m_files.empty()) {
+        return false;
+    }
+    path = std::move(m_files.front().path);
+    m_files.pop_front();
+    m_filesChanged.notify_all();
+    return true;
+}
+
+/*!
+ * \brief Returns whether all directories have been walked.
+ * \remarks Must be called with the mutex locked.
+ */
+bool DirectoryWalker::isDone() const
+{
+    return m_aborted || (m_directories.empty() && !m_busyThreads);
+}
+
+/*!
+ * \brief Walks directories from the queue until the walk is done.
+ */
+void DirectoryWalker::work()
+{
+    auto lock = std::unique_lock(m_mutex);
+    for (;;) {
+        m_directoriesChanged.wait(lock, [this] { return !m_directories.empty() || isDone(); });
+        if (m_aborted || m_directories.empty()) {
+            break;
+        }
+        const auto directory = std::move(m_directories.front());
+        m_directories.pop_front();
+        ++m_busyThreads;
+        lock.unlock();
+        walkDirectory(directory);
+        lock.lock();
+        --m_busyThreads;
+        if (isDone()) {
+            break;
+        }
+    }
+    m_directoriesChanged.notify_all();
+    m_filesChanged.notify_all();
+}
+
+/*!
+ * \brief Returns whether \a name ends with one of the specified extensions (or whether no extensions have been specified).
+ */
+bool DirectoryWalker::matchesExtension(std::string_view name) const
+{
+    if (m_extensions.empty()) {
+        return true;
+    }
+    const auto dot = name.rfind('.');
+    if (dot == std::string_view::npos) {
+        return false;
+    }
+    const auto extension = lowerCase(name.substr(dot + 1));
+    return std::find(m_extensions.begin(), m_extensions.end(), extension) != m_extensions.end();
+}
+
+/*!
+ * \brief Returns whether the file with the specified \a device and \a inode has not been found before.
+ */
+bool DirectoryWalker::isFirstLink(std::uint64_t device, std::uint64_t inode)
+{
+    auto lock = std::unique_lock(m_mutex);
+    return m_seenLinks.emplace(device, inode).second;
+}
+
+/*!
+ * \brief Adds the specified error \a message to be thrown by next().
+ */
+void DirectoryWalker::addError(std::string &&message)
+{
+    {
+        auto lock = std::unique_lock(m_mutex);
+        m_errors.emplace_back(std::move(message));
+    }
+    m_filesChanged.notify_all();
+}
+
+/*!
+ * \brief Adds the specified \a subdirectories to the directories to walk and the specified \a files to the files to return.
+ * \remarks Blocks while the queue of files is full (unless sorting by inode) so the walk does not get too far ahead of the
+ *          processing.
+ */
+void DirectoryWalker::addFiles(std::vector<std::string> &&subdirectories, std::vector<File> &&files)
+{
+    auto lock = std::unique_lock(m_mutex);
+    if (!subdirectories.empty()) {
+        m_directories.insert(m_directories.end(), std::make_move_iterator(subdirectories.begin()), std::make_move_iterator(subdirectories.end()));
+        m_directoriesChanged.notify_all();
+    }
+    for (auto &file : files) {
+        if (!m_sortByInode) {
+            m_filesChanged.wait(lock, [this] { return m_aborted || m_files.size() < maxQueuedFiles; });
+        }
+        if (m_aborted) {
+            return;
+        }
+        m_files.emplace_back(std::move(file));
+        m_filesChanged.notify_all();
+    }
+}
+
+#ifdef PLATFORM_UNIX
+/*!
+ * \brief Reads the specified \a directory adding its subdirectories and the taggable files it contains.
+ */
+void DirectoryWalker::walkDirectory(const std::string &directory)
+{
+    const auto directoryFd = ::open(directory.data(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    auto *const dir = directoryFd >= 0 ? ::fdopendir(directoryFd) : nullptr;
+    if (!dir) {
+        addError("Unable to open directory \"" % directory % "\": " + std::strerror(errno));
+        if (directoryFd >= 0) {
+            ::close(directoryFd);
+        }
+        return;
+    }
+    auto subdirectories = std::vector<std::string>();
+    auto files = std::vector<File>();
+    char signature[signatureSize];
+    struct stat stats = {};
+    for (errno = 0; const auto *const entry = ::readdir(dir); errno = 0) {
+        const auto name = std::string_view(entry->d_name);
+        if (name == "." || name == "..") {
+            continue;
+        }
+
+        // determine the file type (usually without extra syscall)
+        auto type = entry->d_type;
+        if (type == DT_UNKNOWN && !::fstatat(directoryFd, entry->d_name, &stats, AT_SYMLINK_NOFOLLOW)) {
+            type = S_ISDIR(stats.st_mode) ? DT_DIR : S_ISLNK(stats.st_mode) ? DT_LNK : S_ISREG(stats.st_mode) ? DT_REG : DT_UNKNOWN;
+        }
+        if (type == DT_LNK && !::fstatat(directoryFd, entry->d_name, &stats, 0)) {
+            type = S_ISREG(stats.st_mode) ? DT_REG : DT_UNKNOWN;
+        }
+        if (type == DT_DIR) {
+            subdirectories.emplace_back(joinPath(directory, name));
+            continue;
+        }
+        if (type != DT_REG || !matchesExtension(name)) {
+            continue;
+        }
+
+        // check the signature and skip further links to files which have already been found
+        const auto fileFd = ::openat(directoryFd, entry->d_name, O_RDONLY | O_CLOEXEC | O_NOCTTY);
+        if (fileFd < 0) {
+            addError("Unable to open \"" % joinPath(directory, name) % "\": " + std::strerror(errno));
+            continue;
+        }
+        const auto bytesRead = ::read(fileFd, signature, signatureSize);
+        const auto statFailed = ::fstat(fileFd, &stats);
+        ::close(fileFd);
+        if (bytesRead <= 0 || statFailed || !isTaggableFormat(parseSignature(signature, static_cast<std::size_t>(bytesRead)))) {
+            continue;
+        }
+        if (!isFirstLink(static_cast<std::uint64_t>(stats.st_dev), static_cast<std::uint64_t>(stats.st_ino))) {
+            continue;
+        }
+        files.emplace_back(File{ joinPath(directory, name), static_cast<std::uint64_t>(stats.st_ino) });
+    }
+    if (errno) {
+        addError("Unable to read directory \"" % directory % "\": " + std::strerror(errno));
+    }
+    ::closedir(dir);
+    addFiles(std::move(subdirectories), std::move(files));
+}
+#else
+/*!
+ * \brief Reads the specified \a directory adding its subdirectories and the taggable files it contains.
+ * \remarks This generic implementation does not detect hard and symbolic links to the same file and does not provide inode numbers.
+ */
+void DirectoryWalker::walkDirectory(const std::string &directory)
+{
+    auto subdirectories = std::vector<std::string>();
+    auto files = std::vector<File>();
+    auto error = std::error_code();
+    auto signature = std::string(signatureSize, '\0');
+    const auto end = std::filesystem::directory_iterator();
+    for (auto i = std::filesystem::directory_iterator(std::filesystem::u8path(directory), error); !error && i != end; i.increment(error)) {
+        const auto name = i->path().filename().u8string();
+        if (i->is_directory(error) && !i->is_symlink(error)) {
+            subdirectories.emplace_back(joinPath(directory, name));
+            continue;
+        }
+        if (!i->is_regular_file(error) || !matchesExtension(name)) {
+            continue;
+        }
+        auto path = joinPath(directory, name);
+        auto file = NativeFileStream();
+        file.open(path, std::ios_base::in | std::ios_base::binary);
+        if (!file) {
+            addError("Unable to open \"" % path + "\".");
+            continue;
+        }
+        file.read(signature.data(), static_cast<std::streamsize>(signatureSize));
+        const auto bytesRead = static_cast<std::size_t>(file.gcount());
+        if (bytesRead && isTaggableFormat(parseSignature(signature.data(), bytesRead))) {
+            files.emplace_back(File{ std::move(path), 0 });
+        }
+    }
+    if (error) {
+        addError("Unable to read directory \"" % directory % "\": " + error.message());
+    }
+    addFiles(std::move(subdirectories), std::move(files));
+}
+#endif
+
+} // namespace Cli
@@ -0,0 +1,65 @@
+#ifndef CLI_DIRECTORY_WALKER
+#define CLI_DIRECTORY_WALKER
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Cli {
+
+class WalkError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class DirectoryWalker {
+public:
+    explicit DirectoryWalker(const std::vector<const char *> &directories, const std::vector<const char *> &extensions, bool sortByInode,
+        std::size_t threadCount = 0);
+    ~DirectoryWalker();
+    DirectoryWalker(const DirectoryWalker &) = delete;
+    DirectoryWalker &operator=(const DirectoryWalker &) = delete;
+
+    bool next(std::string &path);
+
+private:
+    struct File {
+        std::string path;
+        std::uint64_t inode;
+    };
+
+    void work();
+    void walkDirectory(const std::string &directory);
+    bool isDone() const;
+    bool matchesExtension(std::string_view name) const;
+    bool isFirstLink(std::uint64_t device, std::uint64_t inode);
+    void addError(std::string &&message);
+    void addFiles(std::vector<std::string> &&subdirectories, std::vector<File> &&files);
+
+    std::vector<std::string> m_extensions;
+    bool m_sortByInode;
+    bool m_sorted;
+    bool m_aborted;
+    std::size_t m_busyThreads;
+    std::mutex m_mutex;
+    std::condition_variable m_directoriesChanged;
+    std::condition_variable m_filesChanged;
+    std::deque<std::string> m_directories;
+    std::deque<File> m_files;
+    std::deque<std::string> m_errors;
+    std::set<std::pair<std::uint64_t, std::uint64_t>> m_seenLinks;
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace Cli
+
+#endif // CLI_DIRECTORY_WALKER
@@ -0,0 +1,208 @@
+#include "./fastcopy.h"
+
+#include <c++utilities/application/global.h>
+#include <c++utilities/conversion/stringbuilder.h>
+
+#ifdef PLATFORM_LINUX
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <ios>
+#include <string>
+#include <system_error>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace Cli {
+
+/*!
+ * \brief Returns a human-readable name for the specified \a method.
+ */
+std::string_view fastCopyMethodName(FastCopyMethod method)
+{
+    switch (method) {
+    case FastCopyMethod::None:
+        return "none";
+    case FastCopyMethod::Reflink:
+        return "reflink";
+    case FastCopyMethod::CopyFileRange:
+        return "copy_file_range";
+    case FastCopyMethod::Sendfile:
+        return "sendfile";
+    }
+    return std::string_view();
+}
+
+#ifdef PLATFORM_LINUX
+namespace {
+/// \brief Closes the file descriptor when going out of scope.
+struct FileDescriptor {
+    explicit FileDescriptor(int fd)
+        : fd(fd)
+    {
+    }
+    ~FileDescriptor()
+    {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    FileDescriptor(const FileDescriptor &) = delete;
+    FileDescriptor &operator=(const FileDescriptor &) = delete;
+    int fd;
+};
+
+[[noreturn]] void throwIoError(std::string_view what, std::string_view path, int error)
+{
+    throw std::ios_base::failure(argsToString(what, " \"", path, "\": ", std::strerror(error)), std::error_code(error, std::generic_category()));
+}
+
+/// \brief Returns whether \a error means that the kernel can not copy the data between the involved files (so a regular copy is needed).
+bool isUnsupported(int error)
+{
+    return error == EXDEV || error == ENOSYS || error == EINVAL || error == EOPNOTSUPP;
+}
+} // namespace
+#endif
+
+/*!
+ * \brief Clones the file at \a sourcePath to \a targetPath via FICLONE.
+ *
+ * This is almost free on filesystems supporting reflinks (e.g. Btrfs and XFS) because the data is shared until it is modified.
+ * Other ways of copying (e.g. copy_file_range()) are deliberately not tried as they would read and write the whole file.
+ *
+ * \returns Returns FastCopyMethod::Reflink or FastCopyMethod::None if the file can not be cloned (e.g. because the filesystem does
+ *          not support it or the files are on different filesystems). In the latter case the target file has not been created.
+ * \throws Throws std::ios_base::failure when a file can not be opened.
+ * \remarks
+ * - An existing file at \a targetPath is overridden unless it is the same file as \a sourcePath.
+ * - Only implemented under Linux; always returns FastCopyMethod::None on other platforms.
+ */
+FastCopyMethod cloneFile(std::string_view sourcePath, std::string_view targetPath)
+{
+#ifdef PLATFORM_LINUX
+    const auto source = FileDescriptor(::open(std::string(sourcePath).data(), O_RDONLY | O_CLOEXEC));
+    if (source.fd < 0) {
+        throwIoError("Unable to open", sourcePath, errno);
+    }
+    struct stat sourceStat, targetStat;
+    if (::fstat(source.fd, &sourceStat)) {
+        throwIoError("Unable to stat", sourcePath, errno);
+    }
+    const auto targetPathStr = std::string(targetPath);
+    if (!::stat(targetPathStr.data(), &targetStat) && sourceStat.st_dev == targetStat.st_dev && sourceStat.st_ino == targetStat.st_ino) {
+        return FastCopyMethod::None;
+    }
+    const auto target = FileDescriptor(::open(targetPathStr.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, sourceStat.st_mode & 0777));
+    if (target.fd < 0) {
+        throwIoError("Unable to open", targetPath, errno);
+    }
+    if (!::ioctl(target.fd, FICLONE, source.fd)) {
+        return FastCopyMethod::Reflink;
+    }
+    ::unlink(targetPathStr.data());
+    return FastCopyMethod::None;
+#else
+    CPP_UTILITIES_UNUSED(sourcePath)
+    CPP_UTILITIES_UNUSED(targetPath)
+    return FastCopyMethod::None;
+#endif
+}
+
+/*!
+ * \brief Copies \a size bytes starting at \a offset of the file at \a sourcePath to a new file at \a targetPath via copy_file_range().
+ *
+ * This is used to extract parts of a file (e.g. attachments) without passing the data through userspace.
+ *
+ * \returns Returns FastCopyMethod::CopyFileRange or FastCopyMethod::None if the kernel can not copy the data. In the latter case
+ *          the target file has not been created and the caller is supposed to use a regular copy instead.
+ * \throws Throws std::ios_base::failure when an IO error occurs (including when the source file is shorter than expected).
+ * \remarks Only implemented under Linux; always returns FastCopyMethod::None on other platforms.
+ */
+FastCopyMethod fastCopyRange(std::string_view sourcePath, std::uint64_t offset, std::uint64_t size, std::string_view targetPath)
+{
+#ifdef PLATFORM_LINUX
+    const auto source = FileDescriptor(::open(std::string(sourcePath).data(), O_RDONLY | O_CLOEXEC));
+    if (source.fd < 0) {
+        throwIoError("Unable to open", sourcePath, errno);
+    }
+    const auto targetPathStr = std::string(targetPath);
+    const auto target = FileDescriptor(::open(targetPathStr.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666));
+    if (target.fd < 0) {
+        throwIoError("Unable to open", targetPath, errno);
+    }
+    auto sourceOffset = static_cast<loff_t>(offset);
+    for (auto remaining = size; remaining;) {
+        const auto res = ::copy_file_range(source.fd, &sourceOffset, target.fd, nullptr, static_cast<std::size_t>(remaining), 0);
+        if (res < 0) {
+            const auto error = errno;
+            if (remaining == size && isUnsupported(error)) {
+                ::unlink(targetPathStr.data());
+                return FastCopyMethod::None;
+            }
+            throwIoError("Unable to copy data to", targetPath, error);
+        }
+        if (!res) {
+            throwIoError("Unable to read data from", sourcePath, EIO);
+        }
+        remaining -= static_cast<std::uint64_t>(res);
+    }
+    return FastCopyMethod::CopyFileRange;
+#else
+    CPP_UTILITIES_UNUSED(sourcePath)
+    CPP_UTILITIES_UNUSED(offset)
+    CPP_UTILITIES_UNUSED(size)
+    CPP_UTILITIES_UNUSED(targetPath)
+    return FastCopyMethod::None;
+#endif
+}
+
+/*!
+ * \brief Writes \a size bytes starting at \a offset of the file at \a sourcePath to stdout via sendfile().
+ * \returns Returns FastCopyMethod::Sendfile or FastCopyMethod::None if the kernel can not send the data to stdout (e.g. because
+ *          it is a terminal). In the latter case nothing has been written.
+ * \throws Throws std::ios_base::failure when an IO error occurs (including when the source file is shorter than expected).
+ * \remarks
+ * - Data buffered by std::cout must be flushed before calling this function.
+ * - Only implemented under Linux; always returns FastCopyMethod::None on other platforms.
+ */
+FastCopyMethod fastCopyRangeToStdout(std::string_view sourcePath, std::uint64_t offset, std::uint64_t size)
+{
+#ifdef PLATFORM_LINUX
+    const auto source = FileDescriptor(::open(std::string(sourcePath).data(), O_RDONLY | O_CLOEXEC));
+    if (source.fd < 0) {
+        throwIoError("Unable to open", sourcePath, errno);
+    }
+    auto sourceOffset = static_cast<off_t>(offset);
+    for (auto remaining = size; remaining;) {
+        const auto res = ::sendfile(STDOUT_FILENO, source.fd, &sourceOffset, static_cast<std::size_t>(remaining));
+        if (res < 0) {
+            const auto error = errno;
+            if (remaining == size && isUnsupported(error)) {
+                return FastCopyMethod::None;
+            }
+            throwIoError("Unable to write data of", sourcePath, error);
+        }
+        if (!res) {
+            throwIoError("Unable to read data from", sourcePath, EIO);
+        }
+        remaining -= static_cast<std::uint64_t>(res);
+    }
+    return FastCopyMethod::Sendfile;
+#else
+    CPP_UTILITIES_UNUSED(sourcePath)
+    CPP_UTILITIES_UNUSED(offset)
+    CPP_UTILITIES_UNUSED(size)
+    return FastCopyMethod::None;
+#endif
+}
+
+} // namespace Cli
@@ -0,0 +1,23 @@
+#ifndef CLI_FAST_COPY
+#define CLI_FAST_COPY
+
+#include <cstdint>
+#include <string_view>
+
+namespace Cli {
+
+enum class FastCopyMethod {
+    None, /**< no fast method is available; the file has not been copied */
+    Reflink, /**< the file has been cloned via FICLONE sharing the data with the source file */
+    CopyFileRange, /**< the file has been copied within the kernel via copy_file_range() */
+    Sendfile, /**< the data has been written to stdout within the kernel via sendfile() */
+};
+
+std::string_view fastCopyMethodName(FastCopyMethod method);
+FastCopyMethod cloneFile(std::string_view sourcePath, std::string_view targetPath);
+FastCopyMethod fastCopyRange(std::string_view sourcePath, std::uint64_t offset, std::uint64_t size, std::string_view targetPath);
+FastCopyMethod fastCopyRangeToStdout(std::string_view sourcePath, std::uint64_t offset, std::uint64_t size);
+
+} // namespace Cli
+
+#endif // CLI_FAST_COPY
@@ -0,0 +1,98 @@
+#include "./fieldplan.h"
+
+#include <tagparser/tag.h>
+
+#include <c++utilities/conversion/conversionexception.h>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace TagParser;
+
+namespace Cli {
+
+/*!
+ * \class FieldPlan
+ * \brief The FieldPlan class holds the field denotations of the "set"-operation in a form which is quick to apply to many files.
+ *
+ * The plan is computed once before processing the first file:
+ * - The denotations are stored as flat list of entries.
+ * - Entries which values are the same for every file are marked as static (not dynamic). Their relevant values don't need to be
+ *   selected for each file and their text values are only converted once per encoding (see convertedValue()).
+ * - Entries which values depend on the file index or are incremented are marked as dynamic. Only those need to be re-evaluated
+ *   for each file.
+ * - Which entries apply to a tag only depends on the tag's type and target. So this is only determined once per type/target
+ *   (see tagEntries()).
+ *
+ * The plan may be used from multiple threads at the same time.
+ */
+
+/*!
+ * \brief Computes the plan for the specified \a fields.
+ * \remarks The \a fields must outlive the plan.
+ */
+FieldPlan::FieldPlan(FieldDenotations &fields)
+{
+    m_entries.reserve(fields.size());
+    for (auto &[scope, values] : fields) {
+        auto &entry = m_entries.emplace_back(Entry{ &scope, &values, false });
+        for (const auto &value : values.allValues) {
+            if (value.fileIndex || value.type == DenotationType::Increment) {
+                entry.isDynamic = true;
+                break;
+            }
+        }
+        if (scope.isTrack()) {
+            m_trackEntries.emplace_back(m_entries.size() - 1);
+        }
+    }
+}
+
+/*!
+ * \brief Returns the indexes of the entries which apply to the specified \a tag.
+ */
+const std::vector<std::size_t> &FieldPlan::tagEntries(const Tag &tag) const
+{
+    const auto tagType = tag.type();
+    const auto targetSupported = tag.supportsTarget();
+    const auto &tagTarget = tag.target();
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    for (const auto &tagEntries : m_tagEntries) {
+        if (tagEntries.tagType == tagType && tagEntries.targetSupported == targetSupported && tagEntries.tagTarget == tagTarget) {
+            return tagEntries.entries;
+        }
+    }
+    auto &tagEntries = m_tagEntries.emplace_back(TagEntries{ tagType, tagTarget, targetSupported, std::vector<std::size_t>() });
+    for (auto i = std::size_t(); i != m_entries.size(); ++i) {
+        const auto &denotedScope = *m_entries[i].scope;
+        // skip values which scope does not match the tag
+        if (denotedScope.isTrack() || !(denotedScope.tagType == TagType::Unspecified || (denotedScope.tagType & tagType))
+            || !(!targetSupported || (tagType == TagType::OggVorbisComment && denotedScope.tagTarget.isEmpty())
+                || (denotedScope.exactTargetMatching ? denotedScope.tagTarget == tagTarget : denotedScope.tagTarget.matches(tagTarget)))) {
+            continue;
+        }
+        tagEntries.entries.emplace_back(i);
+    }
+    return tagEntries.entries;
+}
+
+/*!
+ * \brief Returns the specified text value of a static entry converted to the specified \a encoding.
+ * \remarks
+ * - The conversion is only done on the first call. The returned reference stays valid as long as the plan exists.
+ * - If the conversion failed, the returned value is empty and the error is set instead.
+ */
+const FieldPlan::ConvertedValue &FieldPlan::convertedValue(std::size_t entryIndex, std::size_t valueIndex, TagTextEncoding encoding) const
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    auto [i, inserted] = m_convertedValues.try_emplace(std::make_tuple(entryIndex, valueIndex, encoding));
+    if (inserted) {
+        try {
+            i->second.value.emplace(m_entries[entryIndex].values->allValues[valueIndex].value, TagTextEncoding::Utf8, encoding);
+        } catch (const ConversionException &e) {
+            i->second.error = e.what();
+        }
+    }
+    return i->second;
+}
+
+} // namespace Cli
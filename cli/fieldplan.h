@@ -0,0 +1,70 @@
+#ifndef CLI_FIELD_PLAN
+#define CLI_FIELD_PLAN
+
+#include "./helper.h"
+
+#include <tagparser/tagvalue.h>
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace Cli {
+
+class FieldPlan {
+public:
+    struct Entry {
+        const FieldScope *scope;
+        FieldValues *values;
+        bool isDynamic;
+    };
+    struct ConvertedValue {
+        std::optional<TagParser::TagValue> value;
+        std::string error;
+    };
+
+    explicit FieldPlan(FieldDenotations &fields);
+    const std::vector<Entry> &entries() const;
+    const std::vector<std::size_t> &trackEntries() const;
+    const std::vector<std::size_t> &tagEntries(const TagParser::Tag &tag) const;
+    const ConvertedValue &convertedValue(std::size_t entryIndex, std::size_t valueIndex, TagParser::TagTextEncoding encoding) const;
+
+private:
+    struct TagEntries {
+        TagParser::TagType tagType;
+        TagParser::TagTarget tagTarget;
+        bool targetSupported;
+        std::vector<std::size_t> entries;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<std::size_t> m_trackEntries;
+    mutable std::mutex m_mutex;
+    mutable std::list<TagEntries> m_tagEntries;
+    mutable std::map<std::tuple<std::size_t, std::size_t, TagParser::TagTextEncoding>, ConvertedValue> m_convertedValues;
+};
+
+/*!
+ * \brief Returns all entries of the plan.
+ */
+inline const std::vector<FieldPlan::Entry> &FieldPlan::entries() const
+{
+    return m_entries;
+}
+
+/*!
+ * \brief Returns the indexes of the entries which apply to tracks.
+ */
+inline const std::vector<std::size_t> &FieldPlan::trackEntries() const
+{
+    return m_trackEntries;
+}
+
+} // namespace Cli
+
+#endif // CLI_FIELD_PLAN
@@ -0,0 +1,185 @@
+#include "./filecache.h"
+
+#include <tagparser/diagnostics.h>
+#include <tagparser/mediafileinfo.h>
+#include <tagparser/progressfeedback.h>
+
+#include <c++utilities/application/global.h>
+#include <c++utilities/io/path.h>
+
+#ifdef PLATFORM_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <ios>
+#include <system_error>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace TagParser;
+
+namespace Cli {
+
+/*!
+ * \class CachedFile
+ * \brief The CachedFile class holds the contents and the MIME type of a file loaded via FileCache.
+ * \remarks The data stays valid as long as the CachedFile object exists, even if it has been evicted from the cache meanwhile.
+ */
+
+/*!
+ * \class FileCache
+ * \brief The FileCache class loads files which are used as values (e.g. covers) only once per run.
+ *
+ * Files are identified by their path, size and modification time so a file modified during the run is loaded again. On UNIX
+ * the file is mapped into memory; otherwise it is read into a buffer. All tag values referring to the same file are created
+ * from the same buffer so the file is neither read nor MIME-sniffed again. On UNIX, the size and modification time are
+ * determined via the descriptor which is mapped so the mapping never exceeds the file that has been identified.
+ *
+ * The memory used by cached files is limited to the byte budget specified when constructing the cache. The least recently
+ * used files are evicted first. Files which are bigger than the budget are not cached at all.
+ *
+ * The cache may be used from multiple threads at the same time.
+ */
+
+FileCache::FileCache(std::size_t byteBudget)
+    : m_byteBudget(byteBudget)
+    , m_usedBytes(0)
+{
+}
+
+/*!
+ * \brief Returns the contents of the file with the specified \a path, loading the file if it is not cached yet.
+ * \throws Throws TagParser::Failure if the MIME type can not be determined and std::ios_base::failure if an IO error occurs.
+ */
+std::shared_ptr<const CachedFile> FileCache::load(std::string_view path)
+{
+    // determine size and modification time of the file which is going to be mapped (and not of whatever the path refers to
+    // later) so the mapping is never bigger than the file
+    auto key = std::string(path);
+#ifdef PLATFORM_UNIX
+    const auto fd = ::open(key.data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::ios_base::failure(std::strerror(errno));
+    }
+    struct stat st;
+    if (::fstat(fd, &st)) {
+        const auto statError = errno;
+        ::close(fd);
+        throw std::ios_base::failure(std::strerror(statError));
+    }
+    const auto size = static_cast<std::uintmax_t>(st.st_size);
+#ifdef PLATFORM_LINUX
+    const auto modificationTime = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#else
+    const auto modificationTime = static_cast<std::int64_t>(st.st_mtime) * 1000000000;
+#endif
+#else
+    const auto fd = -1;
+    const auto nativePath = makeNativePath(key);
+    auto ec = std::error_code();
+    const auto size = std::filesystem::file_size(nativePath, ec);
+    const auto modificationTime
+        = ec ? std::int64_t() : static_cast<std::int64_t>(std::filesystem::last_write_time(nativePath, ec).time_since_epoch().count());
+    if (ec) {
+        throw std::ios_base::failure(ec.message());
+    }
+#endif
+
+    // return cached file if it is still up-to-date
+    auto lock = std::unique_lock<std::mutex>(m_mutex);
+    if (const auto i = m_entries.find(key); i != m_entries.end()) {
+        auto &entry = i->second;
+        if (entry.size == size && entry.modificationTime == modificationTime) {
+            m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+#ifdef PLATFORM_UNIX
+            ::close(fd);
+#endif
+            return entry.file;
+        }
+        m_usedBytes -= static_cast<std::size_t>(entry.size);
+        m_lru.erase(entry.lruPosition);
+        m_entries.erase(i);
+    }
+
+    // load the file without holding the lock so other threads are not blocked by the IO
+    lock.unlock();
+    auto file = readFile(key, fd, size);
+    if (size > m_byteBudget) {
+        return file;
+    }
+    lock.lock();
+    if (const auto i = m_entries.find(key); i != m_entries.end()) {
+        return i->second.file; // another thread has loaded the file in the meantime
+    }
+    evict(static_cast<std::size_t>(size));
+    m_lru.emplace_front(key);
+    m_entries.emplace(std::move(key), Entry{ size, modificationTime, file, m_lru.begin() });
+    m_usedBytes += static_cast<std::size_t>(size);
+    return file;
+}
+
+/*!
+ * \brief Evicts the least recently used files until \a requiredBytes fit into the budget.
+ * \remarks Must be called while holding the lock.
+ */
+void FileCache::evict(std::size_t requiredBytes)
+{
+    while (!m_lru.empty() && m_usedBytes + requiredBytes > m_byteBudget) {
+        const auto i = m_entries.find(m_lru.back());
+        m_usedBytes -= static_cast<std::size_t>(i->second.size);
+        m_entries.erase(i);
+        m_lru.pop_back();
+    }
+}
+
+/*!
+ * \brief Maps/reads the contents of the file with the specified \a path and \a size and determines its MIME type.
+ * \remarks On UNIX, the file is mapped via the already opened \a fd which is closed in any case.
+ */
+std::shared_ptr<const CachedFile> FileCache::readFile(const std::string &path, int fd, std::uintmax_t size)
+{
+    auto file = std::make_shared<CachedFile>();
+    file->m_size = static_cast<std::size_t>(size);
+#ifdef PLATFORM_UNIX
+    if (size) {
+        auto *const mapping = ::mmap(nullptr, file->m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        const auto mmapError = errno;
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::ios_base::failure(std::strerror(mmapError));
+        }
+        const auto mappedSize = file->m_size;
+        file->m_data = std::shared_ptr<const char>(static_cast<const char *>(mapping), [mappedSize](const char *data) {
+            ::munmap(const_cast<char *>(data), mappedSize);
+        });
+    } else {
+        ::close(fd);
+    }
+#else
+    CPP_UTILITIES_UNUSED(fd)
+#endif
+
+    auto fileInfo = MediaFileInfo(path);
+    auto diag = Diagnostics();
+    auto progress = AbortableProgressFeedback();
+    fileInfo.open(true);
+    fileInfo.parseContainerFormat(diag, progress);
+    file->m_mimeType = fileInfo.mimeType();
+#ifndef PLATFORM_UNIX
+    if (size) {
+        auto buffer = std::shared_ptr<char[]>(new char[file->m_size]);
+        fileInfo.stream().seekg(static_cast<std::streamoff>(0));
+        fileInfo.stream().read(buffer.get(), static_cast<std::streamoff>(file->m_size));
+        file->m_data = std::shared_ptr<const char>(buffer, buffer.get());
+    }
+#endif
+    return file;
+}
+
+} // namespace Cli
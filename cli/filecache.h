@@ -0,0 +1,78 @@
+#ifndef CLI_FILE_CACHE
+#define CLI_FILE_CACHE
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Cli {
+
+class CachedFile {
+    friend class FileCache;
+
+public:
+    const char *data() const;
+    std::size_t size() const;
+    const std::string &mimeType() const;
+
+private:
+    std::shared_ptr<const char> m_data;
+    std::size_t m_size = 0;
+    std::string m_mimeType;
+};
+
+inline const char *CachedFile::data() const
+{
+    return m_data.get();
+}
+
+inline std::size_t CachedFile::size() const
+{
+    return m_size;
+}
+
+inline const std::string &CachedFile::mimeType() const
+{
+    return m_mimeType;
+}
+
+class FileCache {
+public:
+    static constexpr std::size_t defaultByteBudget = 64 * 1024 * 1024;
+
+    explicit FileCache(std::size_t byteBudget = defaultByteBudget);
+    std::shared_ptr<const CachedFile> load(std::string_view path);
+    std::size_t usedBytes() const;
+
+private:
+    struct Entry {
+        std::uintmax_t size;
+        std::int64_t modificationTime; /**< modification time in nanoseconds (UNIX) or ticks of std::filesystem::file_time_type */
+        std::shared_ptr<const CachedFile> file;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    static std::shared_ptr<const CachedFile> readFile(const std::string &path, int fd, std::uintmax_t size);
+    void evict(std::size_t requiredBytes);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_lru;
+    std::size_t m_byteBudget;
+    std::size_t m_usedBytes;
+};
+
+inline std::size_t FileCache::usedBytes() const
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    return m_usedBytes;
+}
+
+} // namespace Cli
+
+#endif // CLI_FILE_CACHE
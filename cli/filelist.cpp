@@ -0,0 +1,143 @@
+#include "./filelist.h"
+#include "./batchprogress.h"
+#include "./mainfeatures.h"
+
+#include <c++utilities/application/argumentparser.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <ios>
+#include <istream>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace Cli {
+
+/// \cond
+static const auto noFiles = std::vector<const char *>();
+/// \endcond
+
+/*!
+ * \class FileList
+ * \brief The FileList class provides the paths of the files to be processed one after another.
+ *
+ * The paths specified via --files are returned first. Then the paths are read from the file specified via --files-from
+ * (or from stdin if "-" has been specified). Those paths are read as a stream while the files are processed so processing
+ * starts immediately and the memory usage does not depend on the number of files. The paths are separated by newlines
+ * (a trailing carriage return is removed) or by NUL characters if --null is present. Empty paths are skipped. Finally, the
+ * paths found by walking the directories specified via --recursive are returned (see DirectoryWalker). The walk is started
+ * immediately so it overlaps with the processing of the files specified before.
+ *
+ * When prefetching is enabled, the paths of the next files are determined ahead of time and the files are prefetched while
+ * the current file is processed (see Prefetcher).
+ */
+
+/*!
+ * \brief Opens the list specified via --files-from and starts walking the directories specified via --recursive (if present).
+ * \throws Throws std::ios_base::failure when the list can not be opened.
+ */
+FileList::FileList(const FileListArgs &args)
+    : m_files(args.filesArg.isPresent() ? &args.filesArg.values() : &noFiles)
+    , m_index(0)
+    , m_separator(args.nullArg.isPresent() ? '\0' : '\n')
+    , m_prefetchCount(0)
+    , m_fetchedCount(0)
+    , m_returnedCount(0)
+{
+    if (args.recursiveArg.isPresent() && !args.recursiveArg.values().empty()) {
+        m_walker.emplace(args.recursiveArg.values(), args.extensionsArg.isPresent() ? args.extensionsArg.values() : noFiles,
+            args.sortByInodeArg.isPresent());
+    }
+    if (!args.filesFromArg.isPresent() || args.filesFromArg.values().empty()) {
+        return;
+    }
+    m_listPath = args.filesFromArg.values().front();
+    m_list.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+    if (m_listPath == "-") {
+        m_list.openFromFileDescriptor(fileno(stdin), std::ios_base::in | std::ios_base::binary);
+    } else {
+        m_list.open(m_listPath, std::ios_base::in | std::ios_base::binary);
+    }
+    m_list.exceptions(std::ios_base::badbit);
+}
+
+/*!
+ * \brief Returns the next path or nullptr if all files have been returned.
+ * \remarks The returned pointer is only valid until the next call.
+ * \throws Throws std::ios_base::failure when an IO error occurs when reading the list.
+ * \throws Throws WalkError when a directory or file could not be read when walking the directories. Further paths can be
+ *         obtained nevertheless by calling next() again.
+ */
+const char *FileList::next()
+{
+    if (!m_prefetcher) {
+        return fetch();
+    }
+    while (m_lookahead.size() <= m_prefetchCount) {
+        const char *const path = fetch();
+        if (!path) {
+            break;
+        }
+        m_prefetcher->prefetch(std::string(m_lookahead.emplace_back(path)), m_fetchedCount++);
+    }
+    if (m_lookahead.empty()) {
+        return nullptr;
+    }
+    m_current = std::move(m_lookahead.front());
+    m_lookahead.pop_front();
+    m_prefetcher->skipUntil(++m_returnedCount);
+    return m_current.data();
+}
+
+/*!
+ * \brief Enables prefetching the next \a fileCount files while the current file is processed.
+ * \remarks Must be called before next() is called for the first time.
+ */
+void FileList::enablePrefetching(std::size_t fileCount)
+{
+    if (!fileCount) {
+        return;
+    }
+    m_prefetchCount = fileCount;
+    m_prefetcher.emplace(std::min(fileCount, std::size_t(4)));
+}
+
+/*!
+ * \brief Returns the next path from the sources without looking ahead.
+ */
+const char *FileList::fetch()
+{
+    if (m_index < m_files->size()) {
+        return (*m_files)[m_index++];
+    }
+    if (!m_listPath.empty()) {
+        while (std::getline(m_list, m_current, m_separator)) {
+            if (m_separator == '\n' && !m_current.empty() && m_current.back() == '\r') {
+                m_current.pop_back();
+            }
+            if (!m_current.empty()) {
+                return m_current.data();
+            }
+        }
+    }
+    return m_walker && m_walker->next(m_current) ? m_current.data() : nullptr;
+}
+
+/*!
+ * \brief Returns the number of files or 0 if it is not known in advance.
+ */
+std::size_t FileList::count() const
+{
+    return isStreamed() ? 0 : m_files->size();
+}
+
+/*!
+ * \brief Returns the total size of all files or 0 if it is not known in advance.
+ */
+std::uint64_t FileList::totalSize() const
+{
+    return isStreamed() ? 0 : BatchProgress::totalSize(*m_files);
+}
+
+} // namespace Cli
@@ -0,0 +1,72 @@
+#ifndef CLI_FILE_LIST
+#define CLI_FILE_LIST
+
+#include "./directorywalker.h"
+#include "./prefetcher.h"
+
+#include <c++utilities/io/nativefilestream.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Cli {
+
+struct FileListArgs;
+
+class FileList {
+public:
+    explicit FileList(const FileListArgs &args);
+    FileList(const FileList &) = delete;
+    FileList &operator=(const FileList &) = delete;
+
+    const char *next();
+    void enablePrefetching(std::size_t fileCount);
+    bool isStreamed() const;
+    std::size_t count() const;
+    std::uint64_t totalSize() const;
+    const std::string &listPath() const;
+
+    static constexpr std::size_t defaultPrefetchCount = 8;
+
+private:
+    const char *fetch();
+
+    const std::vector<const char *> *m_files;
+    std::size_t m_index;
+    std::string m_listPath;
+    CppUtilities::NativeFileStream m_list;
+    char m_separator;
+    std::string m_current;
+    std::optional<DirectoryWalker> m_walker;
+    std::optional<Prefetcher> m_prefetcher;
+    std::deque<std::string> m_lookahead;
+    std::size_t m_prefetchCount;
+    std::size_t m_fetchedCount;
+    std::size_t m_returnedCount;
+};
+
+/*!
+ * \brief Returns whether (further) paths are read from a list or found by walking directories so the number of files is not
+ *        known in advance.
+ */
+inline bool FileList::isStreamed() const
+{
+    return !m_listPath.empty() || m_walker.has_value();
+}
+
+/*!
+ * \brief Returns the path of the list specified via --files-from ("-" for stdin).
+ */
+inline const std::string &FileList::listPath() const
+{
+    return m_listPath;
+}
+
+} // namespace Cli
+
+#endif // CLI_FILE_LIST
@@ -19,6 +19,7 @@
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <csignal>
 #include <cstring>
 #include <iostream>
@@ -160,27 +161,44 @@ string incremented(const string &str, unsigned int toIncrement)
     return res;
 }
 
+/*!
+ * \brief Function called by printDiagMessages() with all messages (regardless of their level) if assigned.
+ * \remarks Used by the "serve"-operation to pass diagnostic messages to clients in structured form.
+ */
+void (*diagMessageRecorder)(const Diagnostics &diag) = nullptr;
+
+/*!
+ * \brief Returns the level from which on diagnostic messages lead to a non-zero exit code according to \a pedanticArg.
+ */
+DiagLevel badExitLevel(const CppUtilities::Argument *pedanticArg)
+{
+    if (!pedanticArg || !pedanticArg->isPresent()) {
+        return DiagLevel::Fatal;
+    }
+    const auto &values = pedanticArg->values();
+    if (values.empty() || values.front() == "error"sv || values.front() == "critical"sv) {
+        return DiagLevel::Critical;
+    } else if (values.front() == "warning"sv) {
+        return DiagLevel::Warning;
+    } else if (values.front() == "info"sv) {
+        return DiagLevel::Information;
+    } else {
+        return DiagLevel::Debug;
+    }
+}
+
 void printDiagMessages(const Diagnostics &diag, const char *head, bool beVerbose, const CppUtilities::Argument *pedanticArg)
 {
     if (diag.empty()) {
         return;
     }
+    if (diagMessageRecorder) {
+        diagMessageRecorder(diag);
+    }
 
     // set exit code to failure if there are diag messages considered bad enough
-    auto minLevel = beVerbose ? DiagLevel::Information : DiagLevel::Warning;
-    auto badExitLevel = DiagLevel::Fatal;
-    if (pedanticArg && pedanticArg->isPresent()) {
-        const auto &values = pedanticArg->values();
-        if (values.empty() || values.front() == "error"sv || values.front() == "critical"sv) {
-            badExitLevel = DiagLevel::Critical;
-        } else if (values.front() == "warning"sv) {
-            badExitLevel = DiagLevel::Warning;
-        } else if (values.front() == "info"sv) {
-            badExitLevel = minLevel = DiagLevel::Information;
-        } else {
-            badExitLevel = minLevel = DiagLevel::Debug;
-        }
-    }
+    const auto badExitLevel = Cli::badExitLevel(pedanticArg);
+    const auto minLevel = std::min(beVerbose ? DiagLevel::Information : DiagLevel::Warning, badExitLevel);
 
     // set exit code if there are severe enough messages and check whether there's something to print
     auto hasAnythingToPrint = false;
@@ -276,75 +294,75 @@ void printProperty(const char *propName, ElementPosition elementPosition, const
     }
 }
 
-static void printFieldName(std::string_view fieldName)
+static void printFieldName(std::ostream &out, std::string_view fieldName)
 {
-    cout << "    " << fieldName;
+    out << "    " << fieldName;
     // also write padding
     constexpr auto defaultIndent = 18;
     if (fieldName.size() >= defaultIndent) {
         // write at least one space
-        cout << ' ';
+        out << ' ';
         return;
     }
     for (auto i = fieldName.size(); i < defaultIndent; ++i) {
-        cout << ' ';
+        out << ' ';
     }
 }
 
-static void printTagValue(const TagValue &value)
+static void printTagValue(std::ostream &out, const TagValue &value)
 {
     switch (value.type()) {
     case TagDataType::Binary:
     case TagDataType::Picture: {
         const auto type = !value.mimeType().empty() ? std::string_view(value.mimeType()) : std::string_view("data");
-        std::cout << "can't display " << type << " as string (use --extract)";
+        out << "can't display " << type << " as string (use --extract)";
         break;
     }
     default:
-        std::cout << value.toDisplayString();
+        out << value.toDisplayString();
     }
-    cout << '\n';
+    out << '\n';
 }
 
-static void printDescription(const TagValue &value)
+static void printDescription(std::ostream &out, const TagValue &value)
 {
     if (value.description().empty()) {
         return;
     }
-    printFieldName("  description:");
+    printFieldName(out, "  description:");
     if (value.descriptionEncoding() == TagTextEncoding::Utf8) {
-        cout << value.description();
+        out << value.description();
     } else {
         auto tempValue = TagValue();
         tempValue.setDescription(value.description(), value.descriptionEncoding());
         tempValue.convertDescriptionEncoding(TagTextEncoding::Utf8);
-        cout << tempValue.description();
+        out << tempValue.description();
     }
-    cout << '\n';
+    out << '\n';
 }
 
-template <class TagType> static void printId3v2CoverValues(TagType *tag)
+template <class TagType> static void printId3v2CoverValues(std::ostream &out, TagType *tag)
 {
     const auto &fields = tag->fields();
     const auto id = tag->fieldId(KnownField::Cover);
     for (auto range = fields.equal_range(id); range.first != range.second; ++range.first) {
         const auto &field = range.first->second;
-        printFieldName(argsToString("Cover (", id3v2CoverName(static_cast<CoverType>(field.typeInfo())), ")"));
-        printTagValue(field.value());
-        printDescription(field.value());
+        printFieldName(out, argsToString("Cover (", id3v2CoverName(static_cast<CoverType>(field.typeInfo())), ")"));
+        printTagValue(out, field.value());
+        printDescription(out, field.value());
     }
 }
 
-void printField(const FieldScope &scope, const Tag *tag, TagType tagType, bool skipEmpty)
+void printField(std::ostream &out, const FieldScope &scope, const Tag *tag, TagType tagType, bool skipEmpty)
 {
     const auto fieldName = std::string_view(scope.field.name());
     try {
         if (scope.field.knownFieldForTag(tag, tagType) == KnownField::Cover) {
             if (tagType == TagType::Id3v2Tag) {
-                printId3v2CoverValues(static_cast<const Id3v2Tag *>(tag));
+                printId3v2CoverValues(out, static_cast<const Id3v2Tag *>(tag));
                 return;
             } else if (tagType == TagType::VorbisComment) {
-                printId3v2CoverValues(static_cast<const VorbisComment *>(tag));
+                printId3v2CoverValues(out, static_cast<const VorbisComment *>(tag));
                 return;
             }
         }
@@ -364,26 +382,26 @@ void printField(const FieldScope &scope, const Tag *tag, TagType tagType, bool s
 
         // print empty value (if not prevented)
         if (values.first.empty()) {
-            printFieldName(fieldName);
-            cout << "none\n";
+            printFieldName(out, fieldName);
+            out << "none\n";
             return;
         }
 
         // print values
         for (const auto &value : values.first) {
-            printFieldName(fieldName);
-            printTagValue(*value);
-            printDescription(*value);
+            printFieldName(out, fieldName);
+            printTagValue(out, *value);
+            printDescription(out, *value);
         }
 
     } catch (const ConversionException &e) {
         // handle conversion error which might happen when parsing field denotation
-        printFieldName(fieldName);
-        cout << "unable to parse - " << e.what() << '\n';
+        printFieldName(out, fieldName);
+        out << "unable to parse - " << e.what() << '\n';
     }
 }
 
-template <typename ConcreteTag> void printNativeFields(const Tag *tag)
+template <typename ConcreteTag> void printNativeFields(std::ostream &out, const Tag *tag)
 {
     const auto *const concreteTag = static_cast<const ConcreteTag *>(tag);
     for (const auto &field : concreteTag->fields()) {
@@ -393,26 +411,26 @@ template <typename ConcreteTag> void printNativeFields(const Tag *tag)
         }
 
         const auto fieldId(ConcreteTag::FieldType::fieldIdToString(field.first));
-        printFieldName(fieldId);
-        printTagValue(field.second.value());
+        printFieldName(out, fieldId);
+        printTagValue(out, field.second.value());
     }
 }
 
-void printNativeFields(const Tag *tag)
+void printNativeFields(std::ostream &out, const Tag *tag)
 {
     switch (tag->type()) {
     case TagType::Id3v2Tag:
-        printNativeFields<Id3v2Tag>(tag);
+        printNativeFields<Id3v2Tag>(out, tag);
         break;
     case TagType::Mp4Tag:
-        printNativeFields<Mp4Tag>(tag);
+        printNativeFields<Mp4Tag>(out, tag);
         break;
     case TagType::MatroskaTag:
-        printNativeFields<MatroskaTag>(tag);
+        printNativeFields<MatroskaTag>(out, tag);
         break;
     case TagType::VorbisComment:
     case TagType::OggVorbisComment:
-        printNativeFields<VorbisComment>(tag);
+        printNativeFields<VorbisComment>(out, tag);
         break;
     default:;
     }
@@ -572,14 +590,28 @@ bool applyTargetConfiguration(TagTarget &target, std::string_view configStr)
     }
 }
 
-FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
+FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly, std::vector<FieldScope> *order)
 {
     auto fields = FieldDenotations();
     if (!fieldsArg.isPresent()) {
         return fields;
     }
+    try {
+        parseFieldDenotations(std::vector<std::string_view>(fieldsArg.values().cbegin(), fieldsArg.values().cend()), readOnly, fields, order);
+    } catch (const DenotationError &) {
+        std::exit(-1);
+    }
+    return fields;
+}
 
-    const std::vector<const char *> &fieldDenotations = fieldsArg.values();
+/*!
+ * \brief Parses the specified \a fieldDenotations adding the denoted scopes/values to \a fields.
+ * \remarks If \a order is specified, newly denoted scopes are appended to it in the order they have been specified.
+ * \throws Throws DenotationError if a denotation is invalid. The error has already been printed to std::cerr in that case.
+ */
+void parseFieldDenotations(
+    const std::vector<std::string_view> &fieldDenotations, bool readOnly, FieldDenotations &fields, std::vector<FieldScope> *order)
+{
     auto scope = FieldScope();
 
     for (std::string_view fieldDenotationString : fieldDenotations) {
@@ -589,7 +621,7 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
             if (tagTypeString.empty()) {
                 cerr << Phrases::Error << "The \"tag\"-specifier has been used with no value(s)." << Phrases::End
                      << "note: Possible values are id3,id3v1,id3v2,itunes,vorbis,matroska and all." << endl;
-                std::exit(-1);
+                throw DenotationError("invalid field denotation");
             }
             auto tagType = TagType::Unspecified;
             for (const auto &part : splitStringSimple<std::vector<std::string_view>>(tagTypeString, ",")) {
@@ -614,7 +646,7 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
                 } else {
                     cerr << Phrases::Error << "The value \"" << part << " for the \"tag\"-specifier is invalid." << Phrases::End
                          << "note: Possible values are id3,id3v1,id3v2,itunes,vorbis,matroska and all." << endl;
-                    std::exit(-1);
+                    throw DenotationError("invalid field denotation");
                 }
             }
             scope.tagType = tagType;
@@ -647,7 +679,7 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
                 } catch (const ConversionException &) {
                     cerr << Phrases::Error << "The value provided with the \"track\"-specifier is invalid." << Phrases::End
                          << "note: It must be a comma-separated list of track IDs." << endl;
-                    std::exit(-1);
+                    throw DenotationError("invalid field denotation");
                 }
             }
             scope.allTracks = allTracks;
@@ -687,7 +719,7 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
         }
         if (!fieldNameLen) {
             cerr << Phrases::Error << "The field denotation \"" << fieldDenotationString << "\" has no field name." << Phrases::EndFlush;
-            exit(-1);
+            throw DenotationError("invalid field denotation");
         }
 
         // parse the denoted field ID
@@ -701,7 +733,7 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
         } catch (const ConversionException &e) {
             // unable to parse field ID denotation -> discard the field denotation
             cerr << Phrases::Error << "The field denotation \"" << fieldName << "\" could not be parsed: " << e.what() << Phrases::EndFlush;
-            std::exit(-1);
+            throw DenotationError("invalid field denotation");
         }
 
         // read cover always from file
@@ -710,13 +742,17 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
         }
 
         // add field denotation scope
-        auto &fieldValues = fields[scope];
+        const auto [fieldDenotation, isNewScope] = fields.try_emplace(scope);
+        auto &fieldValues = fieldDenotation->second;
+        if (order && isNewScope) {
+            order->emplace_back(scope);
+        }
         // add value to the scope (if present)
         if (equationPos != std::string_view::npos) {
             if (readOnly) {
                 cerr << Phrases::Error << "A value has been specified for \"" << fieldName << "\"." << Phrases::End
                      << "note: This is only possible when the \"set\"-operation is used." << endl;
-                std::exit(-1);
+                throw DenotationError("invalid field denotation");
             } else {
                 // file index might have been specified explicitly
                 // if not (mult == 1) use the index of the last value and increase it by one if the value is not an additional one
@@ -729,10 +765,9 @@ FieldDenotations parseFieldDenotations(const Argument &fieldsArg, bool readOnly)
         if (additionalValue && readOnly) {
             cerr << Phrases::Error << "Indication of an additional value for \"" << fieldName << "\" is invalid." << Phrases::End
                  << "note: This is only possible when the \"set\"-operation is used." << endl;
-            std::exit(-1);
+            throw DenotationError("invalid field denotation");
         }
     }
-    return fields;
 }
 
 template <class ConcreteTag, TagType tagTypeMask = ConcreteTag::tagType>
@@ -3,6 +3,7 @@
 
 #include "../application/knownfieldmodel.h"
 
+#include <tagparser/diagnostics.h>
 #include <tagparser/id3/id3v2tag.h>
 #include <tagparser/tag.h>
 #include <tagparser/vorbis/vorbiscomment.h>
@@ -15,6 +16,8 @@
 #include <c++utilities/misc/traits.h>
 
 #include <functional>
+#include <ostream>
+#include <stdexcept>
 #include <string_view>
 #include <type_traits>
 #include <unordered_map>
@@ -260,6 +263,11 @@ struct FieldValues {
 };
 using FieldDenotations = std::unordered_map<FieldScope, FieldValues>;
 
+class DenotationError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
 // declare/define actual helpers
 
 constexpr bool isDigit(char c)
@@ -269,8 +277,10 @@ constexpr bool isDigit(char c)
 
 std::string incremented(const std::string &str, unsigned int toIncrement = 1);
 
+TagParser::DiagLevel badExitLevel(const CppUtilities::Argument *pedanticArg);
 void printDiagMessages(
     const TagParser::Diagnostics &diag, const char *head = nullptr, bool beVerbose = false, const CppUtilities::Argument *pedanticArg = nullptr);
+extern void (*diagMessageRecorder)(const TagParser::Diagnostics &diag);
 void printProperty(const char *propName, std::string_view value, const char *suffix = nullptr, CppUtilities::Indentation indentation = 4);
 void printProperty(const char *propName, ElementPosition elementPosition, const char *suffix = nullptr, CppUtilities::Indentation indentation = 4);
 
@@ -301,8 +311,8 @@ inline void printProperty(
     }
 }
 
-void printField(const FieldScope &scope, const Tag *tag, TagType tagType, bool skipEmpty);
-void printNativeFields(const Tag *tag);
+void printField(std::ostream &out, const FieldScope &scope, const Tag *tag, TagType tagType, bool skipEmpty);
+void printNativeFields(std::ostream &out, const Tag *tag);
 
 CppUtilities::TimeSpanOutputFormat parseTimeSpanOutputFormat(
     const CppUtilities::Argument &usageArg, CppUtilities::TimeSpanOutputFormat defaultFormat);
@@ -312,7 +322,9 @@ ElementPosition parsePositionDenotation(const CppUtilities::Argument &posArg, co
 std::uint64_t parseUInt64(const CppUtilities::Argument &arg, std::uint64_t defaultValue);
 TagTarget::IdContainerType parseIds(std::string_view concatenatedIds);
 bool applyTargetConfiguration(TagTarget &target, std::string_view configStr);
-FieldDenotations parseFieldDenotations(const CppUtilities::Argument &fieldsArg, bool readOnly);
+FieldDenotations parseFieldDenotations(const CppUtilities::Argument &fieldsArg, bool readOnly, std::vector<FieldScope> *order = nullptr);
+void parseFieldDenotations(
+    const std::vector<std::string_view> &fieldDenotations, bool readOnly, FieldDenotations &fields, std::vector<FieldScope> *order = nullptr);
 std::string tagName(const Tag *tag);
 bool stringToBool(const std::string &str);
 extern bool logLineFinalized;
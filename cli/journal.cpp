@@ -0,0 +1,302 @@
+#include "./journal.h"
+
+#include <c++utilities/application/argumentparser.h>
+#include <c++utilities/conversion/conversionexception.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/nativefilestream.h>
+#include <c++utilities/io/path.h>
+
+#ifdef PLATFORM_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <ios>
+#include <string>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace Cli {
+
+/*!
+ * \brief Returns the current size and modification time of the file with the specified \a path.
+ */
+JournalFileState JournalFileState::read(const std::filesystem::path &path, std::error_code &error)
+{
+    auto state = JournalFileState();
+    state.size = std::filesystem::file_size(path, error);
+    if (!error) {
+        state.modificationTime = static_cast<std::int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+    }
+    return state;
+}
+
+/*!
+ * \class BatchJournal
+ * \brief The BatchJournal class records which files have been processed by a batch so an interrupted batch can be resumed.
+ *
+ * A record is appended to the journal file when processing a file starts and when it has been finished successfully. Each
+ * record is synced to disk before the file is touched (respectively before the next file is processed) so the journal is
+ * still meaningful when the process is killed or the system crashes.
+ *
+ * Records are keyed by the path of the file. They contain a hash of the requested operation as well as the size and the
+ * modification time of the file. So a file is only considered processed if it has been processed with the same operation
+ * and has not been changed since then.
+ *
+ * Each record is a line with the tab-separated fields status ("started" or "finished"), the operation hash (hexadecimal),
+ * the size, the modification time and the path. Tabs, newlines and backslashes within the path are escaped via backslashes.
+ * An incomplete last line (written when the process has been killed) is ignored.
+ */
+
+/*!
+ * \brief Opens the journal with the specified \a path, reads all existing records and prepares appending new records.
+ * \throws Throws std::ios_base::failure when the journal can not be read or opened for writing.
+ */
+BatchJournal::BatchJournal(std::string_view path)
+    : m_path(path)
+#ifdef PLATFORM_UNIX
+    , m_fd(-1)
+#endif
+{
+    read();
+#ifdef PLATFORM_UNIX
+    m_fd = ::open(m_path.data(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        throw std::ios_base::failure("unable to open for writing", std::error_code(errno, std::generic_category()));
+    }
+#else
+    m_file.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+    m_file.open(m_path, std::ios_base::out | std::ios_base::app | std::ios_base::binary);
+#endif
+    // terminate an incomplete last line so the next record starts on a new line
+    if (!m_line.empty()) {
+        m_line = "\n";
+        append(std::string_view(), JournalRecord());
+    }
+}
+
+/*!
+ * \brief Closes the journal.
+ */
+BatchJournal::~BatchJournal()
+{
+#ifdef PLATFORM_UNIX
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+#endif
+}
+
+/// \cond
+static void appendEscaped(std::string &out, std::string_view value)
+{
+    for (const auto c : value) {
+        switch (c) {
+        case '\t':
+            out += "\\t";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        default:
+            out += c;
+        }
+    }
+}
+
+static std::string unescaped(std::string_view value)
+{
+    auto res = std::string();
+    res.reserve(value.size());
+    for (auto i = value.begin(), end = value.end(); i != end; ++i) {
+        if (*i != '\\' || i + 1 == end) {
+            res += *i;
+            continue;
+        }
+        switch (*++i) {
+        case 't':
+            res += '\t';
+            break;
+        case 'n':
+            res += '\n';
+            break;
+        default:
+            res += *i;
+        }
+    }
+    return res;
+}
+/// \endcond
+
+/*!
+ * \brief Reads the existing records; the last record of each file takes precedence.
+ * \remarks An incomplete last line is left in m_line.
+ */
+void BatchJournal::read()
+{
+    auto error = std::error_code();
+    if (!std::filesystem::exists(makeNativePath(m_path), error)) {
+        return;
+    }
+    auto file = NativeFileStream();
+    file.exceptions(std::ios_base::badbit);
+    file.open(m_path, std::ios_base::in | std::ios_base::binary);
+    if (!file) {
+        throw std::ios_base::failure("unable to open for reading");
+    }
+    while (std::getline(file, m_line)) {
+        if (file.eof()) {
+            return; // incomplete last line
+        }
+        const auto fields = splitStringSimple<std::vector<std::string_view>>(m_line, "\t", 5);
+        if (fields.size() != 5) {
+            continue;
+        }
+        auto record = JournalRecord();
+        if (fields[0] == "started") {
+            record.status = JournalRecord::Status::Started;
+        } else if (fields[0] == "finished") {
+            record.status = JournalRecord::Status::Finished;
+        } else {
+            continue;
+        }
+        try {
+            record.operationHash = stringToNumber<std::uint64_t>(fields[1], 16);
+            record.state.size = stringToNumber<std::uint64_t>(fields[2]);
+            record.state.modificationTime = stringToNumber<std::int64_t>(fields[3]);
+        } catch (const ConversionException &) {
+            continue;
+        }
+        m_records[unescaped(fields[4])] = record;
+    }
+    m_line.clear();
+}
+
+/*!
+ * \brief Returns the last record for the file with the specified \a filePath.
+ */
+JournalRecord BatchJournal::record(std::string_view filePath) const
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    const auto i = m_records.find(std::string(filePath));
+    return i != m_records.end() ? i->second : JournalRecord();
+}
+
+/*!
+ * \brief Records that processing the file with the specified \a filePath and \a state is started.
+ * \throws Throws std::ios_base::failure when the record can not be written.
+ */
+void BatchJournal::start(std::string_view filePath, std::uint64_t operationHash, const JournalFileState &state)
+{
+    append(filePath, JournalRecord{ JournalRecord::Status::Started, operationHash, state });
+}
+
+/*!
+ * \brief Records that processing the file with the specified \a filePath has been finished leaving it in the specified \a state.
+ * \throws Throws std::ios_base::failure when the record can not be written.
+ */
+void BatchJournal::finish(std::string_view filePath, std::uint64_t operationHash, const JournalFileState &state)
+{
+    append(filePath, JournalRecord{ JournalRecord::Status::Finished, operationHash, state });
+}
+
+/*!
+ * \brief Appends the specified \a record and syncs it to disk.
+ * \remarks Writes the contents of m_line as-is if \a record has no status.
+ */
+void BatchJournal::append(std::string_view filePath, const JournalRecord &record)
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    if (record.status != JournalRecord::Status::None) {
+        m_line = record.status == JournalRecord::Status::Started ? "started\t" : "finished\t";
+        m_line += numberToString(record.operationHash, 16);
+        m_line += '\t';
+        m_line += numberToString(record.state.size);
+        m_line += '\t';
+        m_line += numberToString(record.state.modificationTime);
+        m_line += '\t';
+        appendEscaped(m_line, filePath);
+        m_line += '\n';
+        m_records[std::string(filePath)] = record;
+    }
+#ifdef PLATFORM_UNIX
+    for (auto remaining = std::string_view(m_line); !remaining.empty();) {
+        const auto written = ::write(m_fd, remaining.data(), remaining.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::ios_base::failure("unable to append record", std::error_code(errno, std::generic_category()));
+        }
+        remaining.remove_prefix(static_cast<std::size_t>(written));
+    }
+    if (::fsync(m_fd)) {
+        throw std::ios_base::failure("unable to sync record", std::error_code(errno, std::generic_category()));
+    }
+#else
+    m_file << m_line << std::flush;
+#endif
+}
+
+/*!
+ * \brief Returns a hash of the specified \a data (64-bit FNV-1a) continuing the specified \a hash.
+ * \remarks The hash is only used to tell whether the same operation has been requested; it is not cryptographically secure.
+ */
+std::uint64_t BatchJournal::hash(std::string_view data, std::uint64_t hash)
+{
+    for (const auto c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+/*!
+ * \brief Returns a hash of the values of all present sub-arguments of the specified \a operationArg except \a ignoredArgs.
+ */
+std::uint64_t BatchJournal::hashArguments(const Argument &operationArg, const std::vector<const Argument *> &ignoredArgs)
+{
+    auto res = initialHash;
+    for (const auto *const arg : operationArg.subArguments()) {
+        if (!arg->isPresent() || std::find(ignoredArgs.cbegin(), ignoredArgs.cend(), arg) != ignoredArgs.cend()) {
+            continue;
+        }
+        // add the name and a separator that can not be part of values (which are separated by a null character)
+        res = hash(arg->name(), res);
+        res = hash(std::string_view("\n", 1), res);
+        for (auto i = std::size_t(), occurrences = arg->occurrences(); i != occurrences; ++i) {
+            for (const auto *const value : arg->values(i)) {
+                res = hash(std::string_view(value, std::char_traits<char>::length(value) + 1), res);
+            }
+            res = hash(std::string_view("\n", 1), res);
+        }
+        res = hash(numberToString(hashArguments(*arg, ignoredArgs), 16), res);
+    }
+    return res;
+}
+
+/*!
+ * \brief Returns the path of the backup file tagparser creates for the file with the specified \a filePath when rewriting it.
+ * \remarks The backup is moved back when applying changes fails. However, if the process has been killed while rewriting the
+ *          file, the original file is only left at this path.
+ */
+std::filesystem::path BatchJournal::backupFilePath(std::string_view filePath, std::string_view backupDirectory)
+{
+    auto path = std::filesystem::path(makeNativePath(filePath));
+    if (backupDirectory.empty()) {
+        return path += ".bak";
+    }
+    auto backupPath = std::filesystem::path(makeNativePath(backupDirectory));
+    if (backupPath.is_relative()) {
+        backupPath = path.parent_path() / backupPath;
+    }
+    return (backupPath /= path.filename()) += ".bak";
+}
+
+} // namespace Cli
@@ -0,0 +1,84 @@
+#ifndef CLI_JOURNAL
+#define CLI_JOURNAL
+
+#include <c++utilities/application/global.h>
+#ifndef PLATFORM_UNIX
+#include <c++utilities/io/nativefilestream.h>
+#endif
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace CppUtilities {
+class Argument;
+}
+
+namespace Cli {
+
+struct JournalFileState {
+    std::uint64_t size = 0;
+    std::int64_t modificationTime = 0; /**< the modification time as ticks of std::filesystem::file_time_type */
+
+    bool operator==(const JournalFileState &other) const;
+    static JournalFileState read(const std::filesystem::path &path, std::error_code &error);
+};
+
+/*!
+ * \brief Returns whether the size and the modification time of the states are equal.
+ */
+inline bool JournalFileState::operator==(const JournalFileState &other) const
+{
+    return size == other.size && modificationTime == other.modificationTime;
+}
+
+struct JournalRecord {
+    enum class Status {
+        None, /**< the file has not been processed so far */
+        Started, /**< processing the file has been started but not finished (e.g. because the process has been killed) */
+        Finished, /**< processing the file has been finished successfully */
+    };
+    Status status = Status::None;
+    std::uint64_t operationHash = 0;
+    JournalFileState state;
+};
+
+class BatchJournal {
+public:
+    explicit BatchJournal(std::string_view path);
+    ~BatchJournal();
+    BatchJournal(const BatchJournal &) = delete;
+    BatchJournal &operator=(const BatchJournal &) = delete;
+
+    JournalRecord record(std::string_view filePath) const;
+    void start(std::string_view filePath, std::uint64_t operationHash, const JournalFileState &state);
+    void finish(std::string_view filePath, std::uint64_t operationHash, const JournalFileState &state);
+
+    static constexpr std::uint64_t initialHash = 0xcbf29ce484222325;
+    static std::uint64_t hash(std::string_view data, std::uint64_t hash = initialHash);
+    static std::uint64_t hashArguments(const CppUtilities::Argument &operationArg, const std::vector<const CppUtilities::Argument *> &ignoredArgs);
+    static std::filesystem::path backupFilePath(std::string_view filePath, std::string_view backupDirectory);
+
+private:
+    void read();
+    void append(std::string_view filePath, const JournalRecord &record);
+
+    std::string m_path;
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, JournalRecord> m_records;
+    std::string m_line;
+#ifdef PLATFORM_UNIX
+    int m_fd;
+#else
+    CppUtilities::NativeFileStream m_file;
+#endif
+};
+
+} // namespace Cli
+
+#endif // CLI_JOURNAL
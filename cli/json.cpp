@@ -1,4 +1,5 @@
 #include "./json.h"
+#include "./blobstore.h"
 #include "./fieldmapping.h"
 
 #include <reflective_rapidjson/json/reflector-chronoutilities.h>
@@ -7,8 +8,11 @@
 #include <tagparser/tag.h>
 #include <tagparser/caseinsensitivecomparer.h>
 
+#include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/conversion/stringconversion.h>
 
+#include <system_error>
+
 using namespace std;
 using namespace CppUtilities;
 using namespace TagParser;
@@ -37,14 +41,30 @@ namespace Json {
 
 /*!
  * \brief Converts the specified TagParser::TagValue to an object suitable for JSON serialization.
+ * \remarks If a \a blobStore is specified, pictures and binary values are passed to it and only referenced by their digest and
+ *          size instead of being embedded as Base64 (which is limited to 1 MiB).
  */
-TagValue::TagValue(const TagParser::TagValue &tagValue, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator)
+TagValue::TagValue(const TagParser::TagValue &tagValue, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator, BlobStore *blobStore)
     : mimeType(tagValue.mimeType())
 {
     if (tagValue.isEmpty()) {
         value.SetNull();
         return;
     }
+    if (blobStore && (tagValue.type() == TagDataType::Picture || tagValue.type() == TagDataType::Binary)) {
+        kind = tagValue.type() == TagDataType::Picture ? "picture" : "binary";
+        try {
+            const auto digest = blobStore->store(std::string_view(tagValue.dataPointer(), tagValue.dataSize()));
+            value.SetObject();
+            value.AddMember(
+                "sha256", RAPIDJSON_NAMESPACE::Value(digest.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(digest.size()), allocator), allocator);
+            value.AddMember("size", RAPIDJSON_NAMESPACE::Value(static_cast<std::uint64_t>(tagValue.dataSize())), allocator);
+        } catch (const std::system_error &e) {
+            ReflectiveRapidJSON::JsonReflector::push(argsToString("unable to store blob: ", e.what()), value, allocator);
+            kind = "error";
+        }
+        return;
+    }
     try {
         switch(tagValue.type()) {
         case TagDataType::Text:
@@ -115,7 +135,7 @@ TargetInfo::TargetInfo(const TagTarget &tagTarget, RAPIDJSON_NAMESPACE::Document
 /*!
  * \brief Copies relevant information from TagParser::Tag for serialization (especially the fields).
  */
-TagInfo::TagInfo(const Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator)
+TagInfo::TagInfo(const Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator, BlobStore *blobStore)
     : format(tag.typeName())
     , target(tag.target(), allocator)
 {
@@ -127,7 +147,7 @@ TagInfo::TagInfo(const Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &a
         std::vector<TagValue> valueObjects;
         valueObjects.reserve(tagValues.size());
         for (const auto *tagValue : tagValues) {
-            valueObjects.emplace_back(*tagValue, allocator);
+            valueObjects.emplace_back(*tagValue, allocator, blobStore);
         }
         auto key = std::string(FieldMapping::fieldDenotation(field));
         for (auto &c : key) {
@@ -141,15 +161,16 @@ TagInfo::TagInfo(const Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &a
  * \brief Copies relevant information from TagParser::MediaFileInfo for serialization.
  * \remarks The \a mediaFileInfo must have been parsed before.
  */
-FileInfo::FileInfo(const TagParser::MediaFileInfo &mediaFileInfo, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator)
+FileInfo::FileInfo(const TagParser::MediaFileInfo &mediaFileInfo, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator, BlobStore *blobStore)
     : fileName(mediaFileInfo.fileName())
+    , path(mediaFileInfo.path())
     , size(mediaFileInfo.size())
     , mimeType(mediaFileInfo.mimeType())
     , formatSummary(mediaFileInfo.technicalSummary())
     , duration(mediaFileInfo.duration())
 {
     for (const Tag *tag : mediaFileInfo.tags()) {
-        tags.emplace_back(*tag, allocator);
+        tags.emplace_back(*tag, allocator, blobStore);
     }
 }
 
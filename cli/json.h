@@ -16,10 +16,12 @@ class TagValue;
 }
 
 namespace Cli {
+class BlobStore;
+
 namespace Json {
 
 struct TagValue : ReflectiveRapidJSON::JsonSerializable<TagValue> {
-    TagValue(const TagParser::TagValue &tagValue, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator);
+    TagValue(const TagParser::TagValue &tagValue, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator, BlobStore *blobStore = nullptr);
 
     const char *kind = "undefined";
     const std::string mimeType;
@@ -40,7 +42,7 @@ struct TargetInfo : ReflectiveRapidJSON::JsonSerializable<TargetInfo> {
 };
 
 struct TagInfo : ReflectiveRapidJSON::JsonSerializable<TagInfo> {
-    TagInfo(const TagParser::Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator);
+    TagInfo(const TagParser::Tag &tag, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator, BlobStore *blobStore = nullptr);
 
     std::string_view format;
     TargetInfo target;
@@ -48,9 +50,11 @@ struct TagInfo : ReflectiveRapidJSON::JsonSerializable<TagInfo> {
 };
 
 struct FileInfo : ReflectiveRapidJSON::JsonSerializable<FileInfo> {
-    FileInfo(const TagParser::MediaFileInfo &mediaFileInfo, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator);
+    FileInfo(
+        const TagParser::MediaFileInfo &mediaFileInfo, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator, BlobStore *blobStore = nullptr);
 
     std::string fileName;
+    std::string path;
     std::size_t size;
     std::string_view mimeType;
     std::vector<TagInfo> tags;
@@ -1,6 +1,24 @@
 #include "./mainfeatures.h"
 #include "./attachmentinfo.h"
+#include "./batchprocessor.h"
+#include "./batchprogress.h"
+#include "./blobstore.h"
+#include "./fastcopy.h"
+#include "./fieldplan.h"
+#include "./filecache.h"
+#include "./filelist.h"
 #include "./helper.h"
+#include "./journal.h"
+#include "./manifest.h"
+#include "./mappedfile.h"
+#include "./paddingadvisor.h"
+#include "./readscheduler.h"
+#include "./recordwriter.h"
+#include "./rewriteplan.h"
+#include "./server.h"
+#include "./sha256.h"
+#include "./statedatabase.h"
+#include "./timings.h"
 #ifdef TAGEDITOR_JSON_EXPORT
 #include "./json.h"
 #endif
@@ -62,8 +80,8 @@
 #endif
 
 #ifdef TAGEDITOR_JSON_EXPORT
-#include <rapidjson/ostreamwrapper.h>
 #include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 #endif
 
@@ -75,7 +93,11 @@
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <sstream>
 #include <string_view>
+#include <system_error>
+#include <tuple>
+#include <unordered_set>
 
 using namespace std;
 using namespace CppUtilities;
@@ -119,6 +141,20 @@ const char *const fieldNames = FIELD_NAMES;
 const char *const fieldNamesForSet = TAG_MODIFIER " " FIELD_NAMES " " TRACK_MODIFIER " " TRACK_ATTRIBUTE_NAMES " " TARGET_MODIFIER;
 int exitCode = EXIT_SUCCESS;
 
+/// \cond
+/*!
+ * \brief The KeptState struct holds state which is kept between operations if enabled via keepStateBetweenOperations().
+ */
+struct KeptState {
+    FileCache fileCache;
+    std::string fieldsKey;
+    FieldDenotations fields;
+    std::optional<FieldPlan> plan;
+    std::optional<StateDatabase> stateDatabase;
+};
+static std::unique_ptr<KeptState> keptState;
+/// \endcond
+
 void printFieldNames(const ArgumentOccurrence &)
 {
     CMD_UTILS_START_CONSOLE;
@@ -136,6 +172,156 @@ void printFieldNames(const ArgumentOccurrence &)
          << flush;
 }
 
+/*!
+ * \brief Opens the state database specified via \a incrementalArg or exits if that is not possible.
+ * \returns Returns the database which is either assigned to \a stateDatabase or kept between operations. A kept database is
+ *          re-opened if a different database is specified or if it has been replaced in the meantime (e.g. by another process).
+ */
+static StateDatabase *openStateDatabase(std::optional<StateDatabase> &stateDatabase, const Argument &incrementalArg)
+{
+    const char *const path = incrementalArg.values().front();
+    auto &database = keptState ? keptState->stateDatabase : stateDatabase;
+    try {
+        if (!database || database->path() != path || database->hasBeenReplaced()) {
+            database.reset();
+            database.emplace(path);
+        }
+        return &database.value();
+    } catch (const std::exception &e) {
+        std::cerr << Phrases::Error << "Unable to open the state database \"" << path << "\": " << e.what() << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+/*!
+ * \brief Computes the plan for the specified \a fields denoted via \a valuesArg.
+ * \returns Returns the plan which is either assigned to \a plan or kept between operations. A kept plan (and the \a fields it
+ *          refers to) is re-used if the same fields are denoted again unless its values depend on the file index or are incremented
+ *          (as those values are altered while processing files).
+ */
+static const FieldPlan &planFields(FieldDenotations &fields, const Argument &valuesArg, std::optional<FieldPlan> &plan)
+{
+    if (!keptState) {
+        return plan.emplace(fields);
+    }
+    auto key = std::string();
+    for (auto i = std::size_t(), occurrences = valuesArg.occurrences(); i != occurrences; ++i) {
+        for (const auto *const value : valuesArg.values(i)) {
+            key.append(value, std::strlen(value) + 1);
+        }
+    }
+    auto &kept = *keptState;
+    if (!kept.plan || kept.fieldsKey != key
+        || std::any_of(kept.plan->entries().cbegin(), kept.plan->entries().cend(), [](const auto &entry) { return entry.isDynamic; })) {
+        kept.plan.reset();
+        kept.fields = std::move(fields);
+        kept.fieldsKey = std::move(key);
+        kept.plan.emplace(kept.fields);
+    }
+    return kept.plan.value();
+}
+
+/*!
+ * \brief Saves the specified \a stateDatabase; an error is printed if that is not possible.
+ */
+static void saveStateDatabase(StateDatabase &stateDatabase, const Argument &incrementalArg)
+{
+    try {
+        stateDatabase.save();
+    } catch (const std::exception &e) {
+        std::cerr << Phrases::Error << "Unable to save the state database \"" << incrementalArg.values().front() << "\": " << e.what()
+                  << Phrases::EndFlush;
+        exitCode = EXIT_IO_FAILURE;
+    }
+}
+
+/*!
+ * \brief Splits the specified \a denotedValue of a value read from a file into the path, the cover type and the description.
+ * \remarks A leading drive letter is returned as separate part.
+ */
+static std::vector<std::string_view> splitFileValue(std::string_view denotedValue, const Argument &coverTypeDelimiterArg)
+{
+    const auto firstPartIsDriveLetter = denotedValue.size() >= 2 && denotedValue[1] == ':' ? 1u : 0u;
+    const auto maxParts = std::size_t(3u + firstPartIsDriveLetter);
+    return splitStringSimple<std::vector<std::string_view>>(
+        denotedValue, coverTypeDelimiterArg.firstValueOr(":"), static_cast<int>(maxParts));
+}
+
+/*!
+ * \brief Returns the path of the file the specified \a denotedValue of a value read from a file refers to.
+ * \remarks The \a parts must have been determined via splitFileValue().
+ */
+static std::string_view filePathOfValue(std::string_view denotedValue, const std::vector<std::string_view> &parts)
+{
+    const auto firstPartIsDriveLetter = denotedValue.size() >= 2 && denotedValue[1] == ':';
+    return parts.empty()
+        ? std::string_view()
+        : (firstPartIsDriveLetter ? std::string_view(denotedValue.data(), parts[0].size() + parts[1].size() + 1) : parts.front());
+}
+
+/*!
+ * \brief Mixes the stamp of the file with the specified \a path into \a hash so results depending on the contents of the file
+ *        (e.g. a cover or a script) are not considered up-to-date anymore once the file has been changed.
+ */
+static std::uint64_t hashFileStamp(std::string_view path, std::uint64_t hash)
+{
+    auto error = std::error_code();
+    const auto stamp = FileStamp::read(path, error);
+    const std::uint64_t values[] = { stamp.device, stamp.inode, stamp.size, static_cast<std::uint64_t>(stamp.modificationTime),
+        static_cast<std::uint64_t>(stamp.changeTime), static_cast<std::uint64_t>(error.value()) };
+    return BatchJournal::hash(std::string_view(reinterpret_cast<const char *>(values), sizeof(values)), hash);
+}
+
+/*!
+ * \brief Returns whether \a arg is present and has at least one value.
+ */
+static bool hasValues(const Argument &arg)
+{
+    return arg.isPresent() && !arg.values().empty();
+}
+
+/*!
+ * \brief Opens the list of files specified via \a args or exits if no files have been specified.
+ */
+static void openFileList(std::optional<FileList> &fileList, const FileListArgs &args)
+{
+    if (!hasValues(args.filesArg) && !hasValues(args.filesFromArg) && !hasValues(args.recursiveArg)) {
+        std::cerr << Phrases::Error << "No files have been specified." << Phrases::End;
+        std::exit(EXIT_FAILURE);
+    }
+    try {
+        fileList.emplace(args);
+    } catch (const std::ios_base::failure &e) {
+        std::cerr << Phrases::Error << "Unable to open the file list \"" << args.filesFromArg.values().front() << "\": " << e.what()
+                  << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+    if (args.prefetchArg.isPresent()) {
+        fileList->enablePrefetching(
+            args.prefetchArg.values().empty() ? FileList::defaultPrefetchCount : static_cast<std::size_t>(parseUInt64(args.prefetchArg, 0)));
+    }
+}
+
+/*!
+ * \brief Returns the next path from the specified \a fileList or exits if the list can not be read.
+ * \remarks Directories and files which can not be read when walking directories are only reported as warnings (but lead to a
+ *          non-zero exit code).
+ */
+static const char *nextFile(FileList &fileList)
+{
+    for (;;) {
+        try {
+            return fileList.next();
+        } catch (const WalkError &e) {
+            std::cerr << Phrases::Warning << e.what() << Phrases::EndFlush;
+            exitCode = EXIT_IO_FAILURE;
+        } catch (const std::ios_base::failure &e) {
+            std::cerr << Phrases::Error << "Unable to read the file list \"" << fileList.listPath() << "\": " << e.what() << Phrases::EndFlush;
+            std::exit(EXIT_IO_FAILURE);
+        }
+    }
+}
+
 void generateFileInfo(const ArgumentOccurrence &, const Argument &inputFileArg, const Argument &outputFileArg, const Argument &validateArg)
 {
     CMD_UTILS_START_CONSOLE;
@@ -185,30 +371,58 @@ void generateFileInfo(const ArgumentOccurrence &, const Argument &inputFileArg,
 #endif
 }
 
-void displayFileInfo(
-    const ArgumentOccurrence &, const Argument &filesArg, const Argument &verboseArg, const Argument &pedanticArg, const Argument &validateArg)
+void displayFileInfo(const ArgumentOccurrence &, const FileListArgs &fileListArgs, const Argument &verboseArg, const Argument &pedanticArg,
+    const Argument &validateArg, const Argument &paddingStatsArg, const Argument &timingsArg, const Argument &progressArg, const Argument &mmapArg)
 {
     CMD_UTILS_START_CONSOLE;
 
     // check whether files have been specified
-    if (!filesArg.isPresent() || filesArg.values().empty()) {
-        cerr << Phrases::Error << "No files have been specified." << Phrases::End;
-        std::exit(EXIT_FAILURE);
+    auto fileList = std::optional<FileList>();
+    openFileList(fileList, fileListArgs);
+
+    auto paddingAdvisor = std::optional<PaddingAdvisor>();
+    if (paddingStatsArg.isPresent()) {
+        paddingAdvisor.emplace(parseMaxRewriteRate(paddingStatsArg, 0));
+    }
+    auto timings = std::optional<TimingsReport>();
+    if (timingsArg.isPresent()) {
+        timings.emplace(timingsArg);
+    }
+
+    auto batchProgress = std::optional<BatchProgress>();
+    if (progressArg.isPresent()) {
+        batchProgress.emplace(fileList->count(), fileList->totalSize());
     }
 
     MediaFileInfo fileInfo;
-    for (const char *file : filesArg.values()) {
+    auto fileTimings = FileTimings(timings.has_value());
+    while (const char *const file = nextFile(*fileList)) {
         Diagnostics diag;
-        AbortableProgressFeedback progress; // FIXME: actually use the progress object
+        auto progress = batchProgress ? batchProgress->feedback(0) : AbortableProgressFeedback();
+        fileTimings.reset(file);
         try {
             // parse tags
             if (validateArg.isPresent()) {
                 fileInfo.setForceFullParse(true);
             }
             fileInfo.setPath(std::string(file));
+            fileTimings.start("open");
             fileInfo.open(true);
+            auto mapping = std::optional<FileMapping>();
+            if (mmapArg.isPresent()) {
+                mapping.emplace(fileInfo, validateArg.isPresent() ? AccessPattern::Sequential : AccessPattern::Random);
+            }
+            if (batchProgress) {
+                batchProgress->startFile(0, fileInfo.size());
+            }
+            fileTimings.start("parse-container");
             fileInfo.parseContainerFormat(diag, progress);
+            fileTimings.start("parse-everything");
             fileInfo.parseEverything(diag, progress);
+            fileTimings.start("print");
+            if (batchProgress) {
+                batchProgress->clearLine();
+            }
 
             // print general/container-related info
             cout << "Technical information for \"" << file << "\":\n";
@@ -251,6 +465,9 @@ void displayFileInfo(
             if (fileInfo.paddingSize()) {
                 printProperty("Padding", dataSizeToString(fileInfo.paddingSize()));
             }
+            if (paddingAdvisor) {
+                paddingAdvisor->addFile(fileInfo.containerFormatName(), currentTagSize(fileInfo), fileInfo.paddingSize());
+            }
 
             // print tracks
             const auto tracks = fileInfo.tracks();
@@ -366,81 +583,421 @@ void displayFileInfo(
             }
 
         } catch (const TagParser::Failure &) {
+            if (batchProgress) {
+                batchProgress->clearLine();
+            }
             cerr << Phrases::Error << "A parsing failure occurred when reading the file \"" << file << "\"." << Phrases::EndFlush;
             exitCode = EXIT_PARSING_FAILURE;
         } catch (const std::ios_base::failure &) {
+            if (batchProgress) {
+                batchProgress->clearLine();
+            }
             cerr << Phrases::Error << "An IO error occurred when reading the file \"" << file << "\"" << Phrases::EndFlush;
             exitCode = EXIT_IO_FAILURE;
         }
 
         printDiagMessages(diag, "Diagnostic messages:", verboseArg.isPresent(), &pedanticArg);
         cout << endl;
+        if (timings) {
+            timings->add(fileTimings);
+        }
+        if (batchProgress) {
+            batchProgress->finishFile(0);
+        }
+    }
+
+    if (batchProgress) {
+        batchProgress->finish();
+    }
+    if (paddingAdvisor) {
+        paddingAdvisor->printReport(cout);
+        cout << flush;
+    }
+    if (timings) {
+        timings->printSummary();
     }
 }
 
-void displayTagInfo(
-    const Argument &fieldsArg, const Argument &showUnsupportedArg, const Argument &filesArg, const Argument &verboseArg, const Argument &pedanticArg)
+/*!
+ * \brief The VerifyFile struct holds the state of a file processed by the "verify"-operation.
+ */
+struct VerifyFile {
+    std::string path;
+    std::size_t index = 0;
+    std::string error;
+    FileTimings timings;
+    Diagnostics diag;
+    int exitCode = EXIT_SUCCESS;
+};
+
+/*!
+ * \brief Implements the "verify"-operation of the CLI.
+ *
+ * The structure of each file is parsed completely (like "info --validate" does) and only a line with the result ("pass", "warn" or
+ * "fail") followed by the relevant diagnostic messages is printed per file. Files are parsed in parallel if --jobs is specified.
+ *
+ * Unless --read-ahead is set to 0, the files are read from start to end by a ReadScheduler before they are parsed. This keeps the
+ * disk streaming sequentially even though multiple files are parsed at the same time and reveals files which can not be read
+ * completely.
+ */
+void verifyFiles(const ArgumentOccurrence &, const FileListArgs &fileListArgs, const Argument &jobsArg, const Argument &readAheadArg,
+    const Argument &verboseArg, const Argument &timingsArg, const Argument &progressArg, const Argument &mmapArg)
 {
     CMD_UTILS_START_CONSOLE;
 
     // check whether files have been specified
-    if (!filesArg.isPresent() || filesArg.values().empty()) {
-        std::cerr << Phrases::Error << "No files have been specified." << Phrases::End;
-        std::exit(EXIT_FAILURE);
+    auto fileList = std::optional<FileList>();
+    openFileList(fileList, fileListArgs);
+
+    auto batch = BatchProcessor(parseJobCount(jobsArg));
+    auto scheduler = std::optional<ReadScheduler>();
+    if (const auto readAhead = parseUInt64(readAheadArg, ReadScheduler::defaultBudget / (1024 * 1024))) {
+        scheduler.emplace(readAhead * 1024 * 1024);
+    }
+    auto timings = std::optional<TimingsReport>();
+    if (timingsArg.isPresent()) {
+        timings.emplace(timingsArg);
+    }
+    auto batchProgress = std::optional<BatchProgress>();
+    if (progressArg.isPresent()) {
+        batchProgress.emplace(fileList->count(), fileList->totalSize(), batch.jobs());
+    }
+    auto files = std::vector<VerifyFile>(batch.slotCount());
+    auto fileInfos = std::vector<std::unique_ptr<MediaFileInfo>>();
+    fileInfos.reserve(batch.jobs());
+    for (auto i = std::size_t(); i != batch.jobs(); ++i) {
+        fileInfos.emplace_back(std::make_unique<MediaFileInfo>())->setForceFullParse(true);
+    }
+
+    // assigns the next file to the specified slot and schedules reading it
+    const auto prepareFile = [&](std::size_t itemIndex, std::size_t slot) {
+        const char *const path = nextFile(*fileList);
+        if (!path) {
+            return false;
+        }
+        auto &file = files[slot];
+        file.path.assign(path);
+        file.index = itemIndex;
+        file.error.clear();
+        file.timings = FileTimings(timings.has_value());
+        file.timings.reset(file.path);
+        file.diag.clear();
+        file.exitCode = EXIT_SUCCESS;
+        if (scheduler) {
+            scheduler->add(std::string(path), itemIndex);
+        }
+        return true;
+    };
+
+    // parses the structure of the file in the specified slot completely (possibly from a worker thread)
+    const auto processFile = [&](std::size_t workerIndex, std::size_t slot) {
+        auto &fileInfo = *fileInfos[workerIndex];
+        auto &file = files[slot];
+        auto progress = batchProgress ? batchProgress->feedback(workerIndex) : AbortableProgressFeedback();
+
+        // release the file in any case (also on unexpected exceptions) so its budget and descriptor are not leaked; otherwise
+        // reading subsequent files might block forever
+        struct ReleaseGuard {
+            ~ReleaseGuard()
+            {
+                if (scheduler) {
+                    scheduler->release(index);
+                }
+            }
+            ReadScheduler *scheduler;
+            std::size_t index;
+        } const releaseGuard{ scheduler ? &*scheduler : nullptr, file.index };
+
+        if (scheduler) {
+            file.timings.start("read");
+            file.error = scheduler->waitUntilRead(file.index);
+        }
+        if (!file.error.empty()) {
+            file.exitCode = EXIT_IO_FAILURE;
+        } else {
+            try {
+                fileInfo.setPath(file.path);
+                file.timings.start("open");
+                fileInfo.open(true);
+                auto mapping = std::optional<FileMapping>();
+                if (mmapArg.isPresent()) {
+                    mapping.emplace(fileInfo, AccessPattern::Sequential);
+                }
+                if (batchProgress) {
+                    batchProgress->startFile(workerIndex, fileInfo.size());
+                }
+                file.timings.start("parse-container");
+                fileInfo.parseContainerFormat(file.diag, progress);
+                file.timings.start("parse-everything");
+                fileInfo.parseEverything(file.diag, progress);
+            } catch (const TagParser::Failure &) {
+                file.error = "a parsing failure occurred";
+                file.exitCode = EXIT_PARSING_FAILURE;
+            } catch (const std::ios_base::failure &e) {
+                file.error = argsToString("an IO error occurred: ", e.what());
+                file.exitCode = EXIT_IO_FAILURE;
+            }
+            fileInfo.close();
+        }
+    };
+
+    // prints the result of the file in the specified slot as soon as it is the next one in order
+    auto passed = std::size_t(), warned = std::size_t(), failed = std::size_t();
+    const auto minLevel = verboseArg.isPresent() ? DiagLevel::Information : DiagLevel::Warning;
+    const auto emitFile = [&](std::size_t slot) {
+        auto &file = files[slot];
+        const auto level = file.diag.level();
+        const auto progressLock = batchProgress ? batchProgress->clearLine() : std::unique_lock<std::mutex>();
+        if (file.exitCode != EXIT_SUCCESS || level >= DiagLevel::Critical) {
+            setStyle(cout, Color::Red, ColorContext::Foreground, TextAttribute::Bold);
+            cout << "fail";
+            exitCode = file.exitCode != EXIT_SUCCESS ? file.exitCode : EXIT_PARSING_FAILURE;
+            ++failed;
+        } else if (level >= DiagLevel::Warning) {
+            setStyle(cout, Color::Yellow, ColorContext::Foreground, TextAttribute::Bold);
+            cout << "warn";
+            ++warned;
+        } else {
+            setStyle(cout, Color::Green, ColorContext::Foreground, TextAttribute::Bold);
+            cout << "pass";
+            ++passed;
+        }
+        setStyle(cout, TextAttribute::Reset);
+        cout << "  " << file.path << '\n';
+        if (!file.error.empty()) {
+            cout << "      " << file.error << '\n';
+        }
+        for (const auto &message : file.diag) {
+            if (message.level() < minLevel) {
+                continue;
+            }
+            cout << "      " << DiagMessage::levelName(message.level()) << ": ";
+            if (!message.context().empty()) {
+                cout << message.context() << ": ";
+            }
+            cout << message.message() << '\n';
+        }
+        cout << flush;
+        if (timings) {
+            timings->add(file.timings);
+        }
+    };
+
+    const auto handler = InterruptHandler([&batch] { batch.abort(); });
+    batch.run(
+        prepareFile,
+        [&](std::size_t workerIndex, std::size_t slot) {
+            processFile(workerIndex, slot);
+            files[slot].timings.stop();
+            if (batchProgress) {
+                batchProgress->finishFile(workerIndex);
+            }
+        },
+        emitFile);
+    if (batchProgress) {
+        batchProgress->finish();
+    }
+    cout << "Verified " << (passed + warned + failed) << " files: " << passed << " passed, " << warned << " with warnings, " << failed
+         << " failed" << endl;
+    if (timings) {
+        timings->printSummary();
     }
+}
+
+void displayTagInfo(const Argument &fieldsArg, const Argument &showUnsupportedArg, const Argument &formatArg, const Argument &perTagArg,
+    const FileListArgs &fileListArgs, const Argument &verboseArg, const Argument &pedanticArg, const Argument &timingsArg,
+    const Argument &progressArg, const Argument &incrementalArg, const Argument &mmapArg)
+{
+    CMD_UTILS_START_CONSOLE;
+
+    // check whether files have been specified
+    auto fileList = std::optional<FileList>();
+    openFileList(fileList, fileListArgs);
 
     // parse specified fields
-    const auto fields = parseFieldDenotations(fieldsArg, true);
+    auto columns = std::vector<FieldScope>();
+    const auto fields = parseFieldDenotations(fieldsArg, true, &columns);
+
+    // print machine-readable records instead of the human-readable listing if --format is present
+    auto recordWriter = std::optional<RecordWriter>();
+    if (formatArg.isPresent()) {
+        auto format = RecordFormat::Tsv;
+        if (formatArg.values().empty() || !RecordWriter::parseFormat(formatArg.values().front(), format)) {
+            cerr << Phrases::Error << "The specified format is invalid." << Phrases::End << "note: Possible values are tsv, csv and ndjson."
+                 << endl;
+            std::exit(EXIT_FAILURE);
+        }
+        if (showUnsupportedArg.isPresent()) {
+            cerr << Phrases::Error << "Unsupported fields can not be shown when a format is specified." << Phrases::EndFlush;
+            std::exit(EXIT_FAILURE);
+        }
+        if (fields.empty()) {
+            for (auto field = firstKnownField; field != KnownField::Invalid; field = nextKnownField(field)) {
+                columns.emplace_back(field);
+            }
+        }
+        // the output is only written via std::cout so there is no need to synchronize with C's stdio
+        std::ios_base::sync_with_stdio(false);
+        recordWriter.emplace(format, perTagArg.isPresent(), std::move(columns));
+        recordWriter->writeHeader(cout);
+    }
+
+    auto timings = std::optional<TimingsReport>();
+    if (timingsArg.isPresent()) {
+        timings.emplace(timingsArg);
+    }
+
+    auto batchProgress = std::optional<BatchProgress>();
+    if (progressArg.isPresent()) {
+        batchProgress.emplace(fileList->count(), fileList->totalSize());
+    }
+
+    // buffer the output of each file to store it in the state database if --incremental is present
+    auto openedStateDatabase = std::optional<StateDatabase>();
+    auto *stateDatabase = static_cast<StateDatabase *>(nullptr);
+    auto operationHash = std::uint64_t();
+    if (incrementalArg.isPresent()) {
+        stateDatabase = openStateDatabase(openedStateDatabase, incrementalArg);
+        operationHash = hashIncrementalArguments("get", { &fieldsArg, &showUnsupportedArg, &formatArg, &perTagArg });
+        // the output also depends on whether escape codes are enabled and on the format of time spans
+        const char outputSettings[] = { EscapeCodes::enabled ? '1' : '0', static_cast<char>(timeSpanOutputFormat) };
+        operationHash = BatchJournal::hash(std::string_view(outputSettings, sizeof(outputSettings)), operationHash);
+    }
+    auto bufferedOutput = std::ostringstream();
+    auto &out = stateDatabase ? static_cast<std::ostream &>(bufferedOutput) : std::cout;
 
     auto fileInfo = MediaFileInfo();
+    auto fileTimings = FileTimings(timings.has_value());
     fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::ConvertTotalFields);
-    for (const char *file : filesArg.values()) {
+    while (const char *const file = nextFile(*fileList)) {
         Diagnostics diag;
-        AbortableProgressFeedback progress; // FIXME: actually use the progress object
+        auto progress = batchProgress ? batchProgress->feedback(0) : AbortableProgressFeedback();
+        fileTimings.reset(file);
+
+        // print the output of the last run if the file has not been changed since then
+        auto stamp = FileStamp();
+        auto stampError = std::error_code();
+        if (stateDatabase) {
+            bufferedOutput.str(std::string());
+            stamp = FileStamp::read(file, stampError);
+            if (const auto cachedOutput = !stampError ? stateDatabase->lookup(operationHash, file, stamp) : std::nullopt) {
+                if (batchProgress) {
+                    batchProgress->clearLine();
+                }
+                cout << *cachedOutput << flush;
+                if (batchProgress) {
+                    batchProgress->finishFile(0);
+                }
+                continue;
+            }
+        }
+        // stores the buffered output in the state database (only if there are no warnings as diagnostic messages are not stored)
+        const auto flushOutput = [&](bool succeeded, std::string_view suffix) {
+            if (!stateDatabase) {
+                return;
+            }
+            if (succeeded && !stampError && !diag.has(DiagLevel::Warning)) {
+                stateDatabase->store(operationHash, file, stamp, bufferedOutput.str() + std::string(suffix));
+            }
+            cout << bufferedOutput.str();
+        };
+
         try {
             // parse tags
             fileInfo.setPath(std::string(file));
+            fileTimings.start("open");
             fileInfo.open(true);
+            auto mapping = std::optional<FileMapping>();
+            if (mmapArg.isPresent()) {
+                mapping.emplace(fileInfo, AccessPattern::Random);
+            }
+            if (batchProgress) {
+                batchProgress->startFile(0, fileInfo.size());
+            }
+            fileTimings.start("parse-container");
             fileInfo.parseContainerFormat(diag, progress);
+            fileTimings.start("parse-tags");
             fileInfo.parseTags(diag, progress);
-            cout << "Tag information for \"" << file << "\":\n";
-            const auto tags = fileInfo.tags();
-            if (tags.empty()) {
-                cout << " - File has no (supported) tag information.\n";
-                continue;
+            fileTimings.start("print");
+            if (batchProgress) {
+                batchProgress->clearLine();
             }
-            // iterate through all tags
-            for (const auto *tag : tags) {
-                // determine tag type
-                const TagType tagType = tag->type();
-                // write tag name and target, eg. MP4/iTunes tag
-                cout << " - " << TextAttribute::Bold << tagName(tag) << TextAttribute::Reset << '\n';
-                // iterate through fields specified by the user
-                if (fields.empty()) {
-                    for (auto field = firstKnownField; field != KnownField::Invalid; field = nextKnownField(field)) {
-                        printField(FieldScope(field), tag, tagType, true);
+            const auto tags = fileInfo.tags();
+            if (recordWriter) {
+                recordWriter->writeFile(out, file, tags);
+                flushOutput(true, std::string_view());
+            } else {
+                out << "Tag information for \"" << file << "\":\n";
+                if (tags.empty()) {
+                    out << " - File has no (supported) tag information.\n";
+                    flushOutput(true, std::string_view());
+                    if (timings) {
+                        timings->add(fileTimings);
                     }
-                    if (showUnsupportedArg.isPresent()) {
-                        printNativeFields(tag);
+                    if (batchProgress) {
+                        batchProgress->finishFile(0);
                     }
-                } else {
-                    for (const auto &fieldDenotation : fields) {
-                        const FieldScope &denotedScope = fieldDenotation.first;
-                        if (denotedScope.tagType == TagType::Unspecified || (denotedScope.tagType | tagType) != TagType::Unspecified) {
-                            printField(denotedScope, tag, tagType, false);
+                    continue;
+                }
+                // iterate through all tags
+                for (const auto *tag : tags) {
+                    // determine tag type
+                    const TagType tagType = tag->type();
+                    // write tag name and target, eg. MP4/iTunes tag
+                    out << " - " << TextAttribute::Bold << tagName(tag) << TextAttribute::Reset << '\n';
+                    // iterate through fields specified by the user
+                    if (fields.empty()) {
+                        for (auto field = firstKnownField; field != KnownField::Invalid; field = nextKnownField(field)) {
+                            printField(out, FieldScope(field), tag, tagType, true);
+                        }
+                        if (showUnsupportedArg.isPresent()) {
+                            printNativeFields(out, tag);
+                        }
+                    } else {
+                        for (const auto &fieldDenotation : fields) {
+                            const FieldScope &denotedScope = fieldDenotation.first;
+                            if (denotedScope.tagType == TagType::Unspecified || (denotedScope.tagType | tagType) != TagType::Unspecified) {
+                                printField(out, denotedScope, tag, tagType, false);
+                            }
                         }
                     }
                 }
+                flushOutput(true, "\n");
             }
         } catch (const TagParser::Failure &) {
+            flushOutput(false, std::string_view());
+            if (batchProgress) {
+                batchProgress->clearLine();
+            }
             cerr << Phrases::Error << "A parsing failure occurred when reading the file \"" << file << "\"." << Phrases::EndFlush;
             exitCode = EXIT_PARSING_FAILURE;
         } catch (const std::ios_base::failure &) {
+            flushOutput(false, std::string_view());
+            if (batchProgress) {
+                batchProgress->clearLine();
+            }
             cerr << Phrases::Error << "An IO error occurred when reading the file \"" << file << "\"." << Phrases::EndFlush;
             exitCode = EXIT_IO_FAILURE;
         }
         printDiagMessages(diag, "Diagnostic messages:", verboseArg.isPresent(), &pedanticArg);
-        cout << endl;
+        if (!recordWriter) {
+            cout << endl;
+        }
+        if (timings) {
+            timings->add(fileTimings);
+        }
+        if (batchProgress) {
+            batchProgress->finishFile(0);
+        }
+    }
+    if (batchProgress) {
+        batchProgress->finish();
+    }
+    if (stateDatabase) {
+        saveStateDatabase(*stateDatabase, incrementalArg);
+    }
+    if (timings) {
+        timings->printSummary();
     }
 }
 
@@ -485,6 +1042,49 @@ template <class TagType> static void setId3v2CoverValues(TagType *tag, std::vect
     }
 }
 
+/*!
+ * \brief Returns whether setting the specified cover \a values via setId3v2CoverValues() would alter the specified \a tag.
+ */
+template <class TagType> static bool id3v2CoverValuesDiffer(const TagType *tag, const std::vector<Id3v2Cover> &values)
+{
+    const auto &fields = tag->fields();
+    const auto range = fields.equal_range(tag->fieldId(KnownField::Cover));
+    for (const auto &[tagValue, coverType, description] : values) {
+        const auto predicate = std::bind(&fieldPredicate<TagType>, coverType, description, placeholders::_1);
+        auto pair = std::find_if(range.first, range.second, predicate);
+        if (pair == range.second) {
+            if (!tagValue.isEmpty()) {
+                return true;
+            }
+        } else if (pair->second.value() != tagValue || std::find_if(++pair, range.second, predicate) != range.second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+ * \brief Returns whether setting \a newValues would alter a field which currently has the specified \a currentValues.
+ * \remarks Empty values are not taken into account as setting them only removes values.
+ */
+static bool valuesDiffer(const std::vector<const TagValue *> &currentValues, const std::vector<TagValue> &newValues)
+{
+    auto currentValue = currentValues.cbegin(), currentEnd = currentValues.cend();
+    auto newValue = newValues.cbegin(), newEnd = newValues.cend();
+    for (;; ++currentValue, ++newValue) {
+        for (; currentValue != currentEnd && (*currentValue)->isEmpty(); ++currentValue)
+            ;
+        for (; newValue != newEnd && newValue->isEmpty(); ++newValue)
+            ;
+        if (currentValue == currentEnd || newValue == newEnd) {
+            return currentValue != currentEnd || newValue != newEnd;
+        }
+        if (**currentValue != *newValue) {
+            return true;
+        }
+    }
+}
+
 #ifdef TAGEDITOR_USE_JSENGINE
 class JavaScriptProcessor {
 public:
@@ -600,66 +1200,248 @@ void JavaScriptProcessor::addWarnings(Diagnostics &diag, const string &context,
         diag.emplace_back(DiagLevel::Warning, warning.toString().toStdString(), context);
     }
 }
-#endif
+
+/// \cond
+static std::string keptJavaScriptKey;
+static std::unique_ptr<JavaScriptProcessor> keptJavaScriptProcessor;
+/// \endcond
 
 /*!
- * \brief Implements the "set"-operation of the CLI.
+ * \brief Initializes JavaScript processing for the specified \a args.
+ * \returns Returns the processor which is either assigned to \a processor or kept between operations. A kept processor is re-used
+ *          if the same JavaScript file (which has not been modified in the meantime) and the same settings are specified again.
  */
-void setTagInfo(const SetTagInfoArgs &args)
+static JavaScriptProcessor *initJavaScriptProcessor(const SetTagInfoArgs &args, std::unique_ptr<JavaScriptProcessor> &processor)
 {
-    CMD_UTILS_START_CONSOLE;
-
-    // check whether files have been specified
-    if (!args.filesArg.isPresent() || args.filesArg.values().empty()) {
-        std::cerr << Phrases::Error << "No files have been specified." << Phrases::EndFlush;
-        std::exit(EXIT_FAILURE);
+    if (!keptState) {
+        return (processor = std::make_unique<JavaScriptProcessor>(args)).get();
     }
-    if (args.outputFilesArg.isPresent() && args.outputFilesArg.values().size() != args.filesArg.values().size()) {
-        std::cerr << Phrases::Error << "The number of output files does not match the number of input files." << Phrases::EndFlush;
-        std::exit(EXIT_FAILURE);
+    auto key = std::string();
+    if (const auto *const jsPath = args.jsArg.firstValue()) {
+        auto error = std::error_code();
+        key = argsToString(jsPath, '\0', std::filesystem::last_write_time(makeNativePath(jsPath), error).time_since_epoch().count(), '\0');
     }
-
-    // get output files
-    auto &outputFiles = args.outputFilesArg.isPresent() ? args.outputFilesArg.values() : vector<const char *>();
-    auto currentOutputFile = outputFiles.cbegin(), noMoreOutputFiles = outputFiles.cend();
-
-    // parse field denotations and check whether there's an operation to be done (changing fields or some other settings)
-    auto fields = parseFieldDenotations(args.valuesArg, false);
-    if (fields.empty() && (!args.removeTargetArg.isPresent() || args.removeTargetArg.values().empty())
-        && (!args.addAttachmentArg.isPresent() || args.addAttachmentArg.values().empty())
-        && (!args.updateAttachmentArg.isPresent() || args.updateAttachmentArg.values().empty())
-        && (!args.removeAttachmentArg.isPresent() || args.removeAttachmentArg.values().empty())
-        && (!args.docTitleArg.isPresent() || args.docTitleArg.values().empty()) && !args.id3v1UsageArg.isPresent() && !args.id3v2UsageArg.isPresent()
-        && !args.id3v2VersionArg.isPresent() && !args.jsArg.isPresent()) {
-        if (!args.layoutOnlyArg.isPresent()) {
-            std::cerr << Phrases::Error << "No fields/attachments have been specified." << Phrases::End
-                      << "note: This is usually a mistake. Use --layout-only to prevent this error and apply file layout options only." << endl;
-            std::exit(EXIT_FAILURE);
+    if (args.jsSettingsArg.isPresent()) {
+        for (const auto *const setting : args.jsSettingsArg.values()) {
+            key.append(setting, std::strlen(setting) + 1);
         }
-    } else if (args.layoutOnlyArg.isPresent()) {
-        std::cerr << Phrases::Error << "Fields/attachments and --layout-only have been specified." << Phrases::End
-                  << "note: Don't use --layout-only if you actually want to alter tag information or attachments." << endl;
-        std::exit(EXIT_FAILURE);
     }
-
-    auto settings = TagCreationSettings();
-    settings.flags = TagCreationFlags::None;
-
-    // determine targets to remove
-    auto targetsToRemove = std::vector<TagTarget>();
-    for (size_t i = 0, max = args.removeTargetArg.occurrences(); i != max; ++i) {
-        auto &target = targetsToRemove.emplace_back();
-        for (const auto &targetDenotation : args.removeTargetArg.values(i)) {
-            if (!applyTargetConfiguration(target, targetDenotation)) {
-                std::cerr << Phrases::Error << "The given target specification \"" << targetDenotation << "\" is invalid." << Phrases::EndFlush;
-                std::exit(EXIT_FAILURE);
-            }
-        }
+    if (!keptJavaScriptProcessor || keptJavaScriptKey != key) {
+        keptJavaScriptProcessor.reset();
+        keptJavaScriptProcessor = std::make_unique<JavaScriptProcessor>(args);
+        keptJavaScriptKey = std::move(key);
     }
+    return keptJavaScriptProcessor.get();
+}
+#endif
 
-    // parse ID3v2 version
-    if (args.id3v2VersionArg.isPresent()) {
-        try {
+/*!
+ * \brief The SetTagInfoFile struct holds the state of a file processed by the "set"-operation.
+ * \remarks The output is only buffered in \a out and \a err when processing multiple files in parallel.
+ */
+struct SetTagInfoFile {
+    const char *path = nullptr;
+    const char *outputPath = nullptr;
+    std::vector<std::vector<FieldValue>> values;
+    std::string listedPath;
+    ManifestEntry manifestEntry;
+    std::optional<FieldPlan> manifestPlan;
+    std::optional<RewritePlan> rewritePlan;
+    std::uint64_t operationHash = 0;
+    bool journaled = false;
+    bool upToDate = false;
+    FileTimings timings;
+    Diagnostics diag;
+    std::ostringstream out;
+    std::ostringstream err;
+    int exitCode = EXIT_SUCCESS;
+    bool aborted = false;
+};
+
+/*!
+ * \brief The SetTagInfoWorker struct holds the objects a worker of the "set"-operation re-uses for all files it processes.
+ */
+struct SetTagInfoWorker {
+    explicit SetTagInfoWorker(
+        const SetTagInfoArgs &args, const TagCreationSettings &settings, bool logProgress, BatchProgress *batchProgress, std::size_t index);
+
+    MediaFileInfo fileInfo;
+    TagCreationSettings settings;
+    std::vector<Tag *> tags;
+    std::vector<std::pair<const FieldPlan *, std::size_t>> planEntries;
+    std::vector<std::tuple<const Tag *, TagType, std::uint8_t>> previousTags;
+    std::string backupDirectory;
+    std::uint64_t minPadding;
+    std::uint64_t maxPadding;
+    std::uint64_t preferredPadding;
+    AbortableProgressFeedback applyProgress;
+};
+
+SetTagInfoWorker::SetTagInfoWorker(
+    const SetTagInfoArgs &args, const TagCreationSettings &settings, bool logProgress, BatchProgress *batchProgress, std::size_t index)
+    : settings(settings)
+    , applyProgress(batchProgress ? batchProgress->feedback(index)
+              : logProgress       ? AbortableProgressFeedback(logNextStep, logStepPercentage)
+                                  : AbortableProgressFeedback())
+{
+    minPadding = parseUInt64(args.minPaddingArg, 0);
+    maxPadding = parseUInt64(args.maxPaddingArg, 0);
+    preferredPadding = parseUInt64(args.prefPaddingArg, 0);
+    fileInfo.setMinPadding(minPadding);
+    fileInfo.setMaxPadding(maxPadding);
+    fileInfo.setPreferredPadding(preferredPadding);
+    fileInfo.setTagPosition(parsePositionDenotation(args.tagPosArg, args.tagPosValueArg, ElementPosition::BeforeData));
+    fileInfo.setForceTagPosition(args.forceTagPosArg.isPresent());
+    fileInfo.setIndexPosition(parsePositionDenotation(args.indexPosArg, args.indexPosValueArg, ElementPosition::BeforeData));
+    fileInfo.setForceIndexPosition(args.forceIndexPosArg.isPresent());
+    fileInfo.setForceRewrite(args.forceRewriteArg.isPresent());
+    fileInfo.setWritingApplication(APP_NAME " v" APP_VERSION);
+    if (args.preserveMuxingAppArg.isPresent()) {
+        fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::PreserveMuxingApplication);
+    }
+    if (args.preserveWritingAppArg.isPresent()) {
+        fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::PreserveWritingApplication);
+    }
+    if (!args.preserveTotalFieldsArg.isPresent()) {
+        fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::ConvertTotalFields);
+    }
+
+    // set backup path
+    if (args.backupDirArg.isPresent()) {
+        backupDirectory = args.backupDirArg.values().front();
+    }
+}
+
+/*!
+ * \brief Prints an error about the manifest with the specified \a path and exits.
+ * \remarks Must be called within a catch-block.
+ */
+[[noreturn]] static void exitDueToManifestError(std::string_view path, std::size_t lineNumber)
+{
+    try {
+        throw;
+    } catch (const DenotationError &) {
+        std::cerr << "note: The invalid field denotation has been specified in line " << lineNumber << " of the manifest \"" << path << "\"."
+                  << endl;
+    } catch (const std::ios_base::failure &e) {
+        std::cerr << Phrases::Error << "An IO error occurred when reading the manifest \"" << path << "\": " << e.what() << Phrases::EndFlush;
+    } catch (const std::exception &e) {
+        std::cerr << Phrases::Error << "Unable to read the manifest \"" << path << "\": " << e.what() << Phrases::EndFlush;
+    }
+    std::exit(EXIT_FAILURE);
+}
+
+/*!
+ * \brief Prints how changes have been applied to the file of \a fileInfo which had the specified \a stamp before applying them.
+ * \remarks A file which has been rewritten has a different inode afterwards. Its backup is created via rename() if the backup
+ *          directory is on the same device and copied otherwise. Nothing is printed if the \a stamp is not known (e.g. on non-UNIX
+ *          platforms).
+ */
+static void printApplyMethod(std::ostream &out, const MediaFileInfo &fileInfo, bool isClone, const FileStamp &stamp)
+{
+    if (!fileInfo.saveFilePath().empty()) {
+        out << " - The output file has been written from scratch." << endl;
+        return;
+    }
+    auto error = std::error_code();
+    const auto current = FileStamp::read(fileInfo.path(), error);
+    if (error || !stamp.inode) {
+        return;
+    }
+    const auto *const subject = isClone ? "clone" : "file";
+    if (current.device == stamp.device && current.inode == stamp.inode) {
+        out << " - The " << subject << " has been modified in-place." << endl;
+        return;
+    }
+    auto backupDirectory = makeNativePath(fileInfo.path()).parent_path();
+    if (!fileInfo.backupDirectory().empty()) {
+        backupDirectory /= makeNativePath(fileInfo.backupDirectory());
+    }
+    if (backupDirectory.empty()) {
+        backupDirectory = ".";
+    }
+    const auto backupDirectoryStamp = FileStamp::read(backupDirectory.string(), error);
+    out << " - The " << subject << " has been rewritten; its backup has been created within \"" << backupDirectory.string() << "\" via "
+        << (!error && backupDirectoryStamp.device == stamp.device ? "rename" : "copy") << '.' << endl;
+}
+
+/*!
+ * \brief Implements the "set"-operation of the CLI.
+ * \remarks Files are processed in parallel if --jobs is specified. Nevertheless, the output is printed in the order the files have
+ *          been specified and values to be incremented are incremented in that order as well.
+ */
+void setTagInfo(const SetTagInfoArgs &args)
+{
+    CMD_UTILS_START_CONSOLE;
+
+    // check whether files have been specified
+    const auto useManifest = args.manifestArg.isPresent() || args.fromJsonArg.isPresent();
+    const auto &fileListArgs = args.fileListArgs;
+    const auto isListingFiles = fileListArgs.filesFromArg.isPresent() || fileListArgs.recursiveArg.isPresent();
+    if (args.manifestArg.isPresent() && args.fromJsonArg.isPresent()) {
+        std::cerr << Phrases::Error << "A manifest and --from-json have been specified." << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+    if (useManifest && (args.filesArg.isPresent() || isListingFiles || args.outputFilesArg.isPresent())) {
+        std::cerr << Phrases::Error
+                  << "Files have been specified via --files/--files-from/--recursive/--output-files and --manifest/--from-json." << Phrases::End
+                  << "note: Add all files to the manifest instead (the column \"output\" can be used to specify output files)." << endl;
+        std::exit(EXIT_FAILURE);
+    }
+    if (isListingFiles && args.outputFilesArg.isPresent()) {
+        std::cerr << Phrases::Error << "Output files can not be specified when reading files via --files-from/--recursive." << Phrases::End
+                  << "note: Use --manifest instead (the column \"output\" can be used to specify output files)." << endl;
+        std::exit(EXIT_FAILURE);
+    }
+    auto fileList = std::optional<FileList>();
+    if (!useManifest) {
+        openFileList(fileList, fileListArgs);
+    }
+    if (args.outputFilesArg.isPresent() && args.outputFilesArg.values().size() != args.filesArg.values().size()) {
+        std::cerr << Phrases::Error << "The number of output files does not match the number of input files." << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+
+    // get output files
+    auto &outputFiles = args.outputFilesArg.isPresent() ? args.outputFilesArg.values() : vector<const char *>();
+
+    // parse field denotations and check whether there's an operation to be done (changing fields or some other settings)
+    auto fields = parseFieldDenotations(args.valuesArg, false);
+    if (fields.empty() && !useManifest && (!args.removeTargetArg.isPresent() || args.removeTargetArg.values().empty())
+        && (!args.addAttachmentArg.isPresent() || args.addAttachmentArg.values().empty())
+        && (!args.updateAttachmentArg.isPresent() || args.updateAttachmentArg.values().empty())
+        && (!args.removeAttachmentArg.isPresent() || args.removeAttachmentArg.values().empty())
+        && (!args.docTitleArg.isPresent() || args.docTitleArg.values().empty()) && !args.id3v1UsageArg.isPresent() && !args.id3v2UsageArg.isPresent()
+        && !args.id3v2VersionArg.isPresent() && !args.jsArg.isPresent()) {
+        if (!args.layoutOnlyArg.isPresent()) {
+            std::cerr << Phrases::Error << "No fields/attachments have been specified." << Phrases::End
+                      << "note: This is usually a mistake. Use --layout-only to prevent this error and apply file layout options only." << endl;
+            std::exit(EXIT_FAILURE);
+        }
+    } else if (args.layoutOnlyArg.isPresent()) {
+        std::cerr << Phrases::Error << "Fields/attachments and --layout-only have been specified." << Phrases::End
+                  << "note: Don't use --layout-only if you actually want to alter tag information or attachments." << endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    auto settings = TagCreationSettings();
+    settings.flags = TagCreationFlags::None;
+
+    // determine targets to remove
+    auto targetsToRemove = std::vector<TagTarget>();
+    for (size_t i = 0, max = args.removeTargetArg.occurrences(); i != max; ++i) {
+        auto &target = targetsToRemove.emplace_back();
+        for (const auto &targetDenotation : args.removeTargetArg.values(i)) {
+            if (!applyTargetConfiguration(target, targetDenotation)) {
+                std::cerr << Phrases::Error << "The given target specification \"" << targetDenotation << "\" is invalid." << Phrases::EndFlush;
+                std::exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    // parse ID3v2 version
+    if (args.id3v2VersionArg.isPresent()) {
+        try {
             settings.id3v2MajorVersion = stringToNumber<std::uint8_t>(args.id3v2VersionArg.values().front());
             if (settings.id3v2MajorVersion < 1 || settings.id3v2MajorVersion > 4) {
                 throw ConversionException();
@@ -694,36 +1476,98 @@ void setTagInfo(const SetTagInfoArgs &args)
     settings.id3v1usage = parseUsageDenotation(args.id3v1UsageArg, TagUsage::KeepExisting);
     settings.id3v2usage = parseUsageDenotation(args.id3v2UsageArg, TagUsage::Always);
 
-    // setup media file info
-    auto fileInfo = MediaFileInfo();
-    auto tags = std::vector<Tag *>();
-    fileInfo.setMinPadding(parseUInt64(args.minPaddingArg, 0));
-    fileInfo.setMaxPadding(parseUInt64(args.maxPaddingArg, 0));
-    fileInfo.setPreferredPadding(parseUInt64(args.prefPaddingArg, 0));
-    fileInfo.setTagPosition(parsePositionDenotation(args.tagPosArg, args.tagPosValueArg, ElementPosition::BeforeData));
-    fileInfo.setForceTagPosition(args.forceTagPosArg.isPresent());
-    fileInfo.setIndexPosition(parsePositionDenotation(args.indexPosArg, args.indexPosValueArg, ElementPosition::BeforeData));
-    fileInfo.setForceIndexPosition(args.forceIndexPosArg.isPresent());
-    fileInfo.setForceRewrite(args.forceRewriteArg.isPresent());
-    fileInfo.setWritingApplication(APP_NAME " v" APP_VERSION);
-    if (args.preserveMuxingAppArg.isPresent()) {
-        fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::PreserveMuxingApplication);
+    // setup batch processing
+    const auto quiet = args.quietArg.isPresent();
+    const auto skipUnchanged = args.skipUnchangedArg.isPresent();
+    const auto planOnly = args.planArg.isPresent();
+    auto planTotals = RewritePlanTotals();
+    auto paddingAdvisor = std::optional<PaddingAdvisor>();
+    auto autoPadding = false;
+    if (args.paddingArg.isPresent()) {
+        const auto &values = args.paddingArg.values();
+        const auto mode = values.empty() ? "stats"sv : std::string_view(values.front());
+        if (mode == "auto"sv) {
+            autoPadding = true;
+        } else if (mode != "stats"sv) {
+            std::cerr << Phrases::Error << "The specified padding mode \"" << mode << "\" is invalid." << Phrases::End
+                      << "note: Valid modes are auto and stats." << endl;
+            std::exit(EXIT_FAILURE);
+        }
+        paddingAdvisor.emplace(parseMaxRewriteRate(args.paddingArg, 1));
     }
-    if (args.preserveWritingAppArg.isPresent()) {
-        fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::PreserveWritingApplication);
+    auto timings = std::optional<TimingsReport>();
+    if (args.timingsArg.isPresent()) {
+        timings.emplace(args.timingsArg);
     }
-    if (!args.preserveTotalFieldsArg.isPresent()) {
-        fileInfo.setFileHandlingFlags(fileInfo.fileHandlingFlags() | MediaFileHandlingFlags::ConvertTotalFields);
+    auto journal = std::optional<BatchJournal>();
+    auto operationHash = std::uint64_t();
+    if (args.journalArg.isPresent()) {
+        if (planOnly) {
+            std::cerr << Phrases::Error << "A journal has been specified but --plan does not modify any files." << Phrases::EndFlush;
+            std::exit(EXIT_FAILURE);
+        }
+        const char *const journalPath = args.journalArg.values().front();
+        try {
+            journal.emplace(journalPath);
+        } catch (const std::ios_base::failure &e) {
+            std::cerr << Phrases::Error << "Unable to open the journal \"" << journalPath << "\": " << e.what() << Phrases::EndFlush;
+            std::exit(EXIT_FAILURE);
+        }
     }
-
-    // set backup path
-    if (args.backupDirArg.isPresent()) {
-        fileInfo.setBackupDirectory(std::string(args.backupDirArg.values().front()));
+    auto openedStateDatabase = std::optional<StateDatabase>();
+    auto *stateDatabase = static_cast<StateDatabase *>(nullptr);
+    if (args.incrementalArg.isPresent()) {
+        if (planOnly) {
+            std::cerr << Phrases::Error << "A state database has been specified but --plan does not modify any files." << Phrases::EndFlush;
+            std::exit(EXIT_FAILURE);
+        }
+        stateDatabase = openStateDatabase(openedStateDatabase, args.incrementalArg);
+    }
+    if (journal || stateDatabase) {
+        // identify the requested operation by all arguments which influence how files are modified
+        operationHash = BatchJournal::hashArguments(args.setTagInfoArg,
+            { &args.filesArg, &fileListArgs.filesFromArg, &fileListArgs.nullArg, &fileListArgs.recursiveArg, &args.verboseArg, &args.pedanticArg,
+                &args.timingsArg, &args.progressArg, &args.quietArg, &args.jobsArg, &args.journalArg, &args.incrementalArg });
+
+        // take the contents of the script and of attached files into account (and not only their paths)
+        if (const auto *const jsPath = args.jsArg.firstValue()) {
+            operationHash = hashFileStamp(jsPath, operationHash);
+        }
+        for (const auto *const attachmentArg : { &args.addAttachmentArg, &args.updateAttachmentArg }) {
+            for (auto i = std::size_t(), occurrences = attachmentArg->occurrences(); i != occurrences; ++i) {
+                for (const auto *const value : attachmentArg->values(i)) {
+                    if (!std::strncmp(value, "path=", 5)) {
+                        operationHash = hashFileStamp(value + 5, operationHash);
+                    }
+                }
+            }
+        }
+    }
+    auto batch = BatchProcessor(parseJobCount(args.jobsArg));
+    auto batchProgress = std::optional<BatchProgress>();
+    if (args.progressArg.isPresent()) {
+        // the number of files is not known in advance when reading them from a manifest or a file list
+        batchProgress.emplace(fileList ? fileList->count() : 0, fileList ? fileList->totalSize() : 0, batch.jobs());
+    }
+    // buffer the output of each file when processing files in parallel or when showing the progress so it is not interleaved
+    const auto bufferOutput = batch.isParallel() || batchProgress.has_value();
+    auto files = std::vector<SetTagInfoFile>(batch.slotCount());
+    auto workers = std::vector<std::unique_ptr<SetTagInfoWorker>>();
+    workers.reserve(batch.jobs());
+    for (auto i = std::size_t(); i != batch.jobs(); ++i) {
+        workers.emplace_back(std::make_unique<SetTagInfoWorker>(
+            args, settings, !quiet && !bufferOutput, batchProgress ? &batchProgress.value() : nullptr, i));
     }
 
     // initialize JavaScript processing if --java-script argument is present
 #ifdef TAGEDITOR_USE_JSENGINE
-    auto js = args.jsArg.isPresent() ? std::make_unique<JavaScriptProcessor>(args) : std::unique_ptr<JavaScriptProcessor>();
+    if (args.jsArg.isPresent() && batch.isParallel()) {
+        std::cerr << Phrases::Error << "Processing files via JavaScript is not possible when using multiple jobs." << Phrases::End
+                  << "note: Don't specify --jobs or set it to 1 when using --script." << endl;
+        std::exit(EXIT_FAILURE);
+    }
+    auto ownJs = std::unique_ptr<JavaScriptProcessor>();
+    auto *const js = args.jsArg.isPresent() ? initJavaScriptProcessor(args, ownJs) : nullptr;
 #else
     if (args.jsArg.isPresent()) {
         std::cerr << Phrases::Error << "A JavaScript has been specified but support for this has been disabled at compile-time." << Phrases::EndFlush;
@@ -731,30 +1575,230 @@ void setTagInfo(const SetTagInfoArgs &args)
     }
 #endif
 
-    // iterate through all specified files
-    const auto quiet = args.quietArg.isPresent();
-    auto fileIndex = 0u;
-    static auto context = std::string("setting tags");
-    const auto continueWithNextFile = [&](Diagnostics &diag) {
-        printDiagMessages(diag, "Diagnostic messages:", args.verboseArg.isPresent(), &args.pedanticArg);
-        ++fileIndex;
-        if (currentOutputFile != noMoreOutputFiles) {
-            ++currentOutputFile;
+    // open manifest (the entries are read one after another while processing the files)
+    auto manifest = std::unique_ptr<ManifestReader>();
+    const char *const manifestPath = args.manifestArg.isPresent() ? args.manifestArg.values().front()
+        : args.fromJsonArg.isPresent()                             ? args.fromJsonArg.values().front()
+                                                                   : nullptr;
+    if (useManifest) {
+        try {
+            manifest = args.fromJsonArg.isPresent() ? std::make_unique<ManifestReader>(manifestPath, ManifestReader::Format::JsonExport)
+                                                    : std::make_unique<ManifestReader>(manifestPath);
+        } catch (const std::exception &) {
+            exitDueToManifestError(manifestPath, 1);
+        }
+    }
+
+    // compute plan to apply field denotations and cache files used as values (e.g. covers) so they are only read once
+    auto ownPlan = std::optional<FieldPlan>();
+    auto ownFileCache = std::optional<FileCache>();
+    const auto &plan = planFields(fields, args.valuesArg, ownPlan);
+    const auto altersTracks = !plan.trackEntries().empty();
+    auto &fileCache = keptState ? keptState->fileCache : ownFileCache.emplace();
+
+    // assigns the next file and the values relevant for it to the specified slot
+    const auto prepareFile = [&](std::size_t fileIndex, std::size_t slot) {
+        const char *const listedPath = fileList ? nextFile(*fileList) : nullptr;
+        if (fileList && !listedPath) {
+            return false;
         }
+        auto &file = files[slot];
+        if (manifest) {
+            file.manifestPlan.reset();
+            if (!manifest->read(file.manifestEntry)) {
+                return false;
+            }
+            file.path = file.manifestEntry.path.data();
+            file.outputPath = file.manifestEntry.outputPath.empty() ? nullptr : file.manifestEntry.outputPath.data();
+            file.manifestPlan.emplace(file.manifestEntry.fields);
+        } else {
+            file.path = file.listedPath.assign(listedPath).data();
+            file.outputPath = fileIndex < outputFiles.size() ? outputFiles[fileIndex] : nullptr;
+        }
+        file.rewritePlan.reset();
+        file.journaled = false;
+        file.upToDate = false;
+        file.timings = FileTimings(timings.has_value());
+        file.timings.reset(file.path);
+        file.diag.clear();
+        file.out.str(std::string());
+        file.err.str(std::string());
+        file.exitCode = EXIT_SUCCESS;
+        file.aborted = false;
+
+        // select the relevant values for the current file index (static values are the same for all files anyways)
+        file.values.resize(plan.entries().size());
+        for (auto entryIndex = std::size_t(); entryIndex != plan.entries().size(); ++entryIndex) {
+            const auto &entry = plan.entries()[entryIndex];
+            if (!entry.isDynamic) {
+                continue;
+            }
+            FieldValues &denotedValues = *entry.values;
+            std::vector<FieldValue *> &relevantDenotedValues = denotedValues.relevantValues;
+            relevantDenotedValues.clear();
+            unsigned int currentFileIndex = 0;
+            for (FieldValue &denotatedValue : denotedValues.allValues) {
+                if ((denotatedValue.fileIndex <= fileIndex) && (relevantDenotedValues.empty() || (denotatedValue.fileIndex >= currentFileIndex))) {
+                    if (currentFileIndex != denotatedValue.fileIndex) {
+                        currentFileIndex = denotatedValue.fileIndex;
+                        relevantDenotedValues.clear();
+                    }
+                    relevantDenotedValues.push_back(&denotatedValue);
+                }
+            }
+            // take a copy of the relevant values so they can be incremented for the next file right away
+            auto &values = file.values[entryIndex];
+            values.clear();
+            values.reserve(relevantDenotedValues.size());
+            for (FieldValue *relevantDenotedValue : relevantDenotedValues) {
+                values.emplace_back(*relevantDenotedValue);
+                if (!relevantDenotedValue->value.empty() && relevantDenotedValue->type == DenotationType::Increment) {
+                    relevantDenotedValue->value = incremented(relevantDenotedValue->value);
+                }
+            }
+        }
+
+        // take the values which are specific to the file into account when identifying the requested operation for the journal and the
+        // state database
+        if (journal || stateDatabase) {
+            file.operationHash = manifest ? BatchJournal::hash(manifest->line(), operationHash) : operationHash;
+            for (const auto &values : file.values) {
+                for (const auto &value : values) {
+                    file.operationHash = BatchJournal::hash(std::string_view(value.value.data(), value.value.size() + 1), file.operationHash);
+                    if (value.type == DenotationType::File && !value.value.empty()) {
+                        file.operationHash = hashFileStamp(
+                            filePathOfValue(value.value, splitFileValue(value.value, args.coverTypeDelimiterArg)), file.operationHash);
+                    }
+                }
+                file.operationHash = BatchJournal::hash("\n", file.operationHash);
+            }
+        }
+        return true;
     };
-    for (const char *file : args.filesArg.values()) {
-        auto diag = Diagnostics();
-        auto parsingProgress = AbortableProgressFeedback(); // FIXME: actually use the progress object
+
+    // applies the changes to the file in the specified slot (possibly from a worker thread)
+    static auto context = std::string("setting tags");
+    const auto processFile = [&](std::size_t workerIndex, std::size_t slot) {
+        auto &worker = *workers[workerIndex];
+        auto &fileInfo = worker.fileInfo;
+        auto &tags = worker.tags;
+        auto &file = files[slot];
+        auto &diag = file.diag;
+        auto &out = bufferOutput ? static_cast<std::ostream &>(file.out) : std::cout;
+        auto &err = bufferOutput ? static_cast<std::ostream &>(file.err) : std::cerr;
+        const char *const path = file.path;
+        // apply values from the command-line and from the manifest (the latter are applied last so they take precedence)
+        const FieldPlan *const plans[] = { &plan, file.manifestPlan.has_value() ? &file.manifestPlan.value() : nullptr };
+        auto &planEntries = worker.planEntries;
+        const auto relevantValues = [&file](const FieldPlan &entryPlan, std::size_t entryIndex) -> const std::vector<FieldValue> & {
+            const auto &entry = entryPlan.entries()[entryIndex];
+            return entry.isDynamic ? file.values[entryIndex] : entry.values->allValues;
+        };
+        auto parsingProgress = batchProgress ? batchProgress->feedback(workerIndex) : AbortableProgressFeedback();
+        // track whether the file is actually altered if --skip-unchanged is present; otherwise assume it is
+        // note: Changes which are not cheap to compare (e.g. attachments or changes done via JavaScript) are always considered changes.
+        auto hasChanges = !skipUnchanged || file.outputPath || args.layoutOnlyArg.isPresent() || args.forceRewriteArg.isPresent()
+            || args.addAttachmentArg.isPresent() || args.updateAttachmentArg.isPresent() || args.removeAttachmentArg.isPresent()
+            || args.removeExistingAttachmentsArg.isPresent() || args.jsArg.isPresent();
         try {
-            // parse tags and tracks (tracks are relevant because track meta-data such as language can be changed as well)
+            // parse tags and only parse tracks if track meta-data such as language is changed as well (attachments are only parsed
+            // when altering them; a script might do anything so everything is parsed in that case)
             if (!quiet) {
-                cout << TextAttribute::Bold << "Setting tag information for \"" << file << "\" ..." << Phrases::EndFlush;
+                out << TextAttribute::Bold << "Setting tag information for \"" << path << "\" ..." << Phrases::EndFlush;
             }
-            fileInfo.setPath(std::string(file));
+            // skip the file if it has not been changed since it has been processed via the same operation according to the state database
+            // (files saved to a different output file are always processed as the output file might have been changed)
+            if (stateDatabase && !file.outputPath) {
+                auto stampError = std::error_code();
+                const auto stamp = FileStamp::read(path, stampError);
+                if (!stampError && stateDatabase->lookup(file.operationHash, path, stamp)) {
+                    if (!quiet) {
+                        out << " - Skipping file because it has not been changed since it has been processed." << endl;
+                    }
+                    file.upToDate = true;
+                    return;
+                }
+            }
+            // skip the file if it has already been processed according to the journal; otherwise record that processing it starts
+            if (journal) {
+                const auto nativePath = std::filesystem::path(makeNativePath(path));
+                const auto record = journal->record(path);
+                auto stateError = std::error_code();
+                auto state = JournalFileState::read(nativePath, stateError);
+                if (!stateError && record.status == JournalRecord::Status::Finished && record.operationHash == file.operationHash
+                    && record.state == state) {
+                    if (!quiet) {
+                        out << " - Skipping file because it has already been processed according to the journal." << endl;
+                    }
+                    return;
+                }
+                if (record.status == JournalRecord::Status::Started) {
+                    // restore the original file if the previous run has been killed while rewriting the file (then the original file
+                    // is only left at the backup path; it is identified by having the size and modification time recorded initially)
+                    const auto backupPath = BatchJournal::backupFilePath(path, worker.backupDirectory);
+                    auto backupError = std::error_code();
+                    if (!file.outputPath && JournalFileState::read(backupPath, backupError) == record.state && !backupError) {
+                        std::filesystem::rename(backupPath, nativePath, backupError);
+                        if (backupError) {
+                            err << " - " << Phrases::Error << "Unable to restore the original file from the backup \"" << backupPath.string()
+                                << "\" left by an interrupted run: " << backupError.message() << Phrases::EndFlush;
+                            file.exitCode = EXIT_IO_FAILURE;
+                            return;
+                        }
+                        state = JournalFileState::read(nativePath, stateError);
+                        if (!quiet) {
+                            out << " - Restored the original file from the backup \"" << backupPath.string() << "\" left by an interrupted run."
+                                << endl;
+                        }
+                    } else if (!quiet) {
+                        out << " - Checking file again because an interrupted run has been processing it." << endl;
+                    }
+                }
+                journal->start(path, file.operationHash, state);
+                file.journaled = true;
+            }
+            // clone the file to the output path first if the filesystem supports reflinks; then the changes can be applied to the
+            // clone in-place which avoids a full rewrite if possible
+            // note: Other ways of copying are not used as they read and write the whole file (like writing the output file from
+            // scratch) and whether the file would be rewritten anyways is only known after parsing it.
+            auto copyMethod = FastCopyMethod::None;
+            if (file.outputPath && !planOnly && !args.jsArg.isPresent()) {
+                file.timings.start("copy");
+                copyMethod = cloneFile(path, file.outputPath);
+                if (!quiet && copyMethod != FastCopyMethod::None) {
+                    out << " - Copied file to \"" << file.outputPath << "\" via " << fastCopyMethodName(copyMethod) << '.' << endl;
+                }
+            }
+            fileInfo.setPath(std::string(copyMethod == FastCopyMethod::None ? path : file.outputPath));
+            fileInfo.setBackupDirectory(worker.backupDirectory);
+            file.timings.start("parse-container");
             fileInfo.parseContainerFormat(diag, parsingProgress);
+            if (batchProgress) {
+                batchProgress->startFile(workerIndex, fileInfo.size());
+            }
+            file.timings.start("parse-tags");
             fileInfo.parseTags(diag, parsingProgress);
-            fileInfo.parseTracks(diag, parsingProgress);
-            fileInfo.parseAttachments(diag, parsingProgress);
+            if (altersTracks || (file.manifestPlan.has_value() && !file.manifestPlan->trackEntries().empty()) || args.jsArg.isPresent()) {
+                file.timings.start("parse-tracks");
+                fileInfo.parseTracks(diag, parsingProgress);
+            }
+            if (args.jsArg.isPresent()) {
+                file.timings.start("parse-attachments");
+                fileInfo.parseAttachments(diag, parsingProgress);
+            }
+            file.timings.start("modify");
+
+            // remember existing tags to be able to tell whether tags have been removed, added or converted
+            if (!hasChanges) {
+                tags.clear();
+                fileInfo.tags(tags);
+                worker.previousTags.clear();
+                for (const auto *const tag : tags) {
+                    const auto tagType = tag->type();
+                    worker.previousTags.emplace_back(
+                        tag, tagType, tagType == TagType::Id3v2Tag ? static_cast<const Id3v2Tag *>(tag)->majorVersion() : std::uint8_t());
+                }
+            }
 
             // remove tags with the specified targets
             if (!targetsToRemove.empty()) {
@@ -763,58 +1807,58 @@ void setTagInfo(const SetTagInfoArgs &args)
                 for (auto *const tag : tags) {
                     if (find(targetsToRemove.cbegin(), targetsToRemove.cend(), tag->target()) != targetsToRemove.cend()) {
                         fileInfo.removeTag(tag);
-                    }
-                }
-            }
-
-            // select the relevant values for the current file index
-            for (auto &fieldDenotation : fields) {
-                FieldValues &denotedValues = fieldDenotation.second;
-                std::vector<FieldValue *> &relevantDenotedValues = denotedValues.relevantValues;
-                relevantDenotedValues.clear();
-                unsigned int currentFileIndex = 0;
-                for (FieldValue &denotatedValue : denotedValues.allValues) {
-                    if ((denotatedValue.fileIndex <= fileIndex)
-                        && (relevantDenotedValues.empty() || (denotatedValue.fileIndex >= currentFileIndex))) {
-                        if (currentFileIndex != denotatedValue.fileIndex) {
-                            currentFileIndex = denotatedValue.fileIndex;
-                            relevantDenotedValues.clear();
-                        }
-                        relevantDenotedValues.push_back(&denotatedValue);
+                        hasChanges = true;
                     }
                 }
             }
 
             // determine required targets
-            settings.requiredTargets.clear();
-            for (const auto &fieldDenotation : fields) {
-                const FieldScope &scope = fieldDenotation.first;
-                if (scope.isTrack() || !scope.exactTargetMatching) {
+            worker.settings.requiredTargets.clear();
+            for (const auto *const entryPlan : plans) {
+                if (!entryPlan) {
                     continue;
                 }
-                const std::vector<FieldValue *> &relevantDenotedValues = fieldDenotation.second.relevantValues;
-                auto hasNonEmptyValues = false;
-                for (const auto &value : relevantDenotedValues) {
-                    if (!value->value.empty()) {
-                        hasNonEmptyValues = true;
-                        break;
+                for (auto entryIndex = std::size_t(); entryIndex != entryPlan->entries().size(); ++entryIndex) {
+                    const auto *const scope = entryPlan->entries()[entryIndex].scope;
+                    if (scope->isTrack() || !scope->exactTargetMatching) {
+                        continue;
+                    }
+                    auto hasNonEmptyValues = false;
+                    for (const auto &value : relevantValues(*entryPlan, entryIndex)) {
+                        if (!value.value.empty()) {
+                            hasNonEmptyValues = true;
+                            break;
+                        }
+                    }
+                    if (hasNonEmptyValues
+                        && std::find(worker.settings.requiredTargets.cbegin(), worker.settings.requiredTargets.cend(), scope->tagTarget)
+                            == worker.settings.requiredTargets.cend()) {
+                        worker.settings.requiredTargets.emplace_back(scope->tagTarget);
                     }
-                }
-                if (hasNonEmptyValues
-                    && std::find(settings.requiredTargets.cbegin(), settings.requiredTargets.cend(), scope.tagTarget)
-                        == settings.requiredTargets.cend()) {
-                    settings.requiredTargets.emplace_back(scope.tagTarget);
                 }
             }
 
             // create new tags according to settings
-            fileInfo.createAppropriateTags(settings);
+            fileInfo.createAppropriateTags(worker.settings);
+            if (!hasChanges) {
+                tags.clear();
+                fileInfo.tags(tags);
+                hasChanges = tags.size() != worker.previousTags.size();
+                for (auto i = std::size_t(); !hasChanges && i != tags.size(); ++i) {
+                    const auto *const tag = tags[i];
+                    const auto tagType = tag->type();
+                    const auto &[previousTag, previousTagType, previousVersion] = worker.previousTags[i];
+                    hasChanges = tag != previousTag || tagType != previousTagType
+                        || (tagType == TagType::Id3v2Tag && static_cast<const Id3v2Tag *>(tag)->majorVersion() != previousVersion);
+                }
+            }
             auto container = fileInfo.container();
             if (args.docTitleArg.isPresent() && !args.docTitleArg.values().empty()) {
                 if (container && container->supportsTitle()) {
                     size_t segmentIndex = 0, segmentCount = container->titles().size();
                     for (const auto &newTitle : args.docTitleArg.values()) {
                         if (segmentIndex < segmentCount) {
+                            hasChanges |= container->titles()[segmentIndex] != newTitle;
                             container->setTitle(newTitle, segmentIndex);
                         } else {
                             diag.emplace_back(DiagLevel::Warning,
@@ -832,21 +1876,21 @@ void setTagInfo(const SetTagInfoArgs &args)
             // process tag fields via the specified JavaScript
 #ifdef TAGEDITOR_USE_JSENGINE
             if (js) {
+                file.timings.start("script");
                 const auto res = js->callMain(fileInfo, diag);
                 if (res.isError() || diag.has(DiagLevel::Fatal)) {
                     if (!quiet) {
-                        std::cout << " - Skipping file due to fatal error when executing JavaScript.\n";
+                        out << " - Skipping file due to fatal error when executing JavaScript.\n";
                     }
-                    continueWithNextFile(diag);
-                    continue;
+                    return;
                 }
                 if (!res.isUndefined() && !res.toBool()) {
                     if (!quiet) {
-                        std::cout << " - Skipping file because JavaScript returned a falsy value other than undefined.\n";
+                        out << " - Skipping file because JavaScript returned a falsy value other than undefined.\n";
                     }
-                    continueWithNextFile(diag);
-                    continue;
+                    return;
                 }
+                file.timings.start("modify");
             }
 #endif
 
@@ -861,12 +1905,10 @@ void setTagInfo(const SetTagInfoArgs &args)
                 for (auto *tag : tags) {
                     // clear current values if option is present
                     if (args.removeOtherFieldsArg.isPresent()) {
+                        hasChanges |= tag->fieldCount() != 0;
                         tag->removeAllFields();
                     }
-                    // determine required information for deciding whether specified values match the scope of the current tag
                     const auto tagType = tag->type();
-                    const bool targetSupported = tag->supportsTarget();
-                    const auto tagTarget = tag->target();
                     // determine the encoding to store text values
                     TagTextEncoding usedEncoding = denotedEncoding;
                     if (!tag->canEncodingBeUsed(denotedEncoding)) {
@@ -878,29 +1920,47 @@ void setTagInfo(const SetTagInfoArgs &args)
                                 context);
                         }
                     }
-                    // iterate through all denoted field values
-                    for (const auto &fieldDenotation : fields) {
-                        const FieldScope &denotedScope = fieldDenotation.first;
-                        // skip values which scope does not match the current tag
-                        if (denotedScope.isTrack() || !(denotedScope.tagType == TagType::Unspecified || (denotedScope.tagType & tagType))
-                            || !(!targetSupported || (tagType == TagType::OggVorbisComment && denotedScope.tagTarget.isEmpty())
-                                || (denotedScope.exactTargetMatching ? denotedScope.tagTarget == tagTarget
-                                                                     : denotedScope.tagTarget.matches(tagTarget)))) {
+                    // iterate through all denoted field values which scope matches the current tag
+                    planEntries.clear();
+                    for (const auto *const entryPlan : plans) {
+                        if (!entryPlan) {
                             continue;
                         }
+                        for (const auto entryIndex : entryPlan->tagEntries(*tag)) {
+                            planEntries.emplace_back(entryPlan, entryIndex);
+                        }
+                    }
+                    for (const auto &[entryPlan, entryIndex] : planEntries) {
+                        const auto &entry = entryPlan->entries()[entryIndex];
+                        const FieldScope &denotedScope = *entry.scope;
+                        const auto &relevantDenotedValues = relevantValues(*entryPlan, entryIndex);
                         // convert the values to TagValue
                         auto convertedValues = std::vector<TagValue>();
                         auto convertedId3v2CoverValues = std::vector<Id3v2Cover>();
-                        for (const FieldValue *relevantDenotedValue : fieldDenotation.second.relevantValues) {
+                        convertedValues.reserve(relevantDenotedValues.size());
+                        for (auto valueIndex = std::size_t(); valueIndex != relevantDenotedValues.size(); ++valueIndex) {
+                            const FieldValue &relevantDenotedValue = relevantDenotedValues[valueIndex];
                             // assign an empty TagValue to remove the field if denoted value is empty
-                            if (relevantDenotedValue->value.empty()) {
+                            if (relevantDenotedValue.value.empty()) {
                                 convertedValues.emplace_back();
                                 continue;
                             }
-                            // add text value
-                            if (relevantDenotedValue->type != DenotationType::File) {
+                            // add text value; use the value from the plan if it is the same for all files so it is only converted once
+                            if (relevantDenotedValue.type != DenotationType::File && !entry.isDynamic) {
+                                const auto &convertedValue = entryPlan->convertedValue(entryIndex, valueIndex, usedEncoding);
+                                if (convertedValue.value.has_value()) {
+                                    convertedValues.emplace_back(convertedValue.value.value());
+                                } else {
+                                    diag.emplace_back(DiagLevel::Critical,
+                                        argsToString("Unable to parse value specified for field \"", denotedScope.field.name(), "\": ",
+                                            convertedValue.error),
+                                        context);
+                                }
+                                continue;
+                            }
+                            if (relevantDenotedValue.type != DenotationType::File) {
                                 try {
-                                    convertedValues.emplace_back(relevantDenotedValue->value, TagTextEncoding::Utf8, usedEncoding);
+                                    convertedValues.emplace_back(relevantDenotedValue.value, TagTextEncoding::Utf8, usedEncoding);
                                 } catch (const ConversionException &e) {
                                     diag.emplace_back(DiagLevel::Critical,
                                         argsToString("Unable to parse value specified for field \"", denotedScope.field.name(), "\": ", e.what()),
@@ -909,31 +1969,20 @@ void setTagInfo(const SetTagInfoArgs &args)
                                 continue;
                             }
                             // add value from file
-                            const auto denotedValue = relevantDenotedValue->value;
+                            const auto &denotedValue = relevantDenotedValue.value;
                             const auto firstPartIsDriveLetter = denotedValue.size() >= 2 && denotedValue[1] == ':' ? 1u : 0u;
-                            const auto maxParts = std::size_t(3u + firstPartIsDriveLetter);
-                            const auto parts = splitStringSimple<std::vector<std::string_view>>(
-                                denotedValue, args.coverTypeDelimiterArg.firstValueOr(":"), static_cast<int>(maxParts));
-                            const auto path = parts.empty()
-                                ? std::string_view()
-                                : (firstPartIsDriveLetter ? std::string_view(denotedValue.data(), parts[0].size() + parts[1].size() + 1)
-                                                          : parts.front());
+                            const auto parts = splitFileValue(denotedValue, args.coverTypeDelimiterArg);
+                            const auto path = filePathOfValue(denotedValue, parts);
                             const auto fieldType = denotedScope.field.knownFieldForTag(tag, tagType);
                             const auto dataType = fieldType == KnownField::Cover ? TagDataType::Picture : TagDataType::Text;
                             try {
                                 // assume the file refers to a picture
                                 auto value = TagValue();
                                 if (!path.empty()) {
-                                    auto coverFileInfo = MediaFileInfo(path);
-                                    auto coverDiag = Diagnostics();
-                                    auto coverProgress = AbortableProgressFeedback(); // FIXME: actually use the progress object
-                                    coverFileInfo.open(true);
-                                    coverFileInfo.parseContainerFormat(coverDiag, coverProgress);
-                                    auto buff = make_unique<char[]>(coverFileInfo.size());
-                                    coverFileInfo.stream().seekg(static_cast<streamoff>(0));
-                                    coverFileInfo.stream().read(buff.get(), static_cast<streamoff>(coverFileInfo.size()));
-                                    value = TagValue(std::move(buff), coverFileInfo.size(), dataType, TagTextEncoding::Utf8);
-                                    value.setMimeType(coverFileInfo.mimeType());
+                                    // load the file only once even though it is usually assigned to multiple tags/files
+                                    const auto coverFile = fileCache.load(path);
+                                    value = TagValue(coverFile->data(), coverFile->size(), dataType, TagTextEncoding::Utf8);
+                                    value.setMimeType(coverFile->mimeType());
                                 }
                                 auto description = std::optional<std::string_view>();
                                 if (parts.size() > 2u + firstPartIsDriveLetter) {
@@ -974,9 +2023,13 @@ void setTagInfo(const SetTagInfoArgs &args)
                         }
                         // finally set/clear the values
                         try {
+                            const auto setsValues = !convertedValues.empty() || convertedId3v2CoverValues.empty();
+                            if (setsValues && !hasChanges) {
+                                const auto [currentValues, supported] = denotedScope.field.values(tag, tagType);
+                                hasChanges = supported && valuesDiffer(currentValues, convertedValues);
+                            }
                             // add error if field is not supported unless it is just ID3v1 and we are writing an ID3v2 tag as well
-                            if ((!convertedValues.empty() || convertedId3v2CoverValues.empty())
-                                && !denotedScope.field.setValues(tag, tagType, convertedValues)
+                            if (setsValues && !denotedScope.field.setValues(tag, tagType, convertedValues)
                                 && (tagType != TagType::Id3v1Tag || !willWriteAnId3v2Tag)) {
                                 diag.emplace_back(DiagLevel::Critical,
                                     argsToString(
@@ -990,10 +2043,12 @@ void setTagInfo(const SetTagInfoArgs &args)
                         if (!convertedId3v2CoverValues.empty()) {
                             switch (tagType) {
                             case TagType::Id3v2Tag:
+                                hasChanges = hasChanges || id3v2CoverValuesDiffer(static_cast<Id3v2Tag *>(tag), convertedId3v2CoverValues);
                                 setId3v2CoverValues(static_cast<Id3v2Tag *>(tag), std::move(convertedId3v2CoverValues));
                                 break;
                             case TagType::VorbisComment:
                             case TagType::OggVorbisComment:
+                                hasChanges = hasChanges || id3v2CoverValuesDiffer(static_cast<VorbisComment *>(tag), convertedId3v2CoverValues);
                                 setId3v2CoverValues(static_cast<VorbisComment *>(tag), std::move(convertedId3v2CoverValues));
                                 break;
                             default:;
@@ -1004,36 +2059,56 @@ void setTagInfo(const SetTagInfoArgs &args)
             }
 
             // alter tracks
+            planEntries.clear();
+            for (const auto *const entryPlan : plans) {
+                if (!entryPlan) {
+                    continue;
+                }
+                for (const auto entryIndex : entryPlan->trackEntries()) {
+                    planEntries.emplace_back(entryPlan, entryIndex);
+                }
+            }
             for (AbstractTrack *const track : fileInfo.tracks()) {
-                for (const auto &fieldDenotation : fields) {
+                for (const auto &[entryPlan, entryIndex] : planEntries) {
                     // skip empty values
-                    const auto &values = fieldDenotation.second.relevantValues;
+                    const auto &values = relevantValues(*entryPlan, entryIndex);
                     if (values.empty()) {
                         continue;
                     }
 
                     // skip values which scope does not match the current track
-                    const FieldScope &denotedScope = fieldDenotation.first;
+                    const FieldScope &denotedScope = *entryPlan->entries()[entryIndex].scope;
                     if (!denotedScope.allTracks
                         && find(denotedScope.trackIds.cbegin(), denotedScope.trackIds.cend(), track->id()) == denotedScope.trackIds.cend()) {
                         continue;
                     }
 
                     const FieldId &field = denotedScope.field;
-                    const string &value = values.front()->value;
+                    const string &value = values.front().value;
                     try {
                         if (field.denotes("name")) {
+                            hasChanges |= track->name() != value;
                             track->setName(value);
                         } else if (field.denotes("language")) {
+                            const auto &locale = track->locale();
+                            hasChanges |= locale.size() != 1 || locale.front() != value;
                             track->setLocale(Locale(std::string_view(value), LocaleFormat::Unknown));
                         } else if (field.denotes("tracknumber")) {
-                            track->setTrackNumber(stringToNumber<std::uint32_t>(value));
+                            const auto trackNumber = stringToNumber<std::uint32_t>(value);
+                            hasChanges |= track->trackNumber() != trackNumber;
+                            track->setTrackNumber(trackNumber);
                         } else if (field.denotes("enabled")) {
-                            track->setEnabled(stringToBool(value));
+                            const auto enabled = stringToBool(value);
+                            hasChanges |= track->isEnabled() != enabled;
+                            track->setEnabled(enabled);
                         } else if (field.denotes("forced")) {
-                            track->setForced(stringToBool(value));
+                            const auto forced = stringToBool(value);
+                            hasChanges |= track->isForced() != forced;
+                            track->setForced(forced);
                         } else if (field.denotes("default")) {
-                            track->setDefault(stringToBool(value));
+                            const auto isDefault = stringToBool(value);
+                            hasChanges |= track->isDefault() != isDefault;
+                            track->setDefault(isDefault);
                         } else {
                             diag.emplace_back(DiagLevel::Critical,
                                 argsToString("Denoted track property name \"", field.denotation(), "\" is invalid"),
@@ -1047,15 +2122,6 @@ void setTagInfo(const SetTagInfoArgs &args)
                 }
             }
 
-            // increment relevant values
-            for (auto &fieldDenotation : fields) {
-                for (FieldValue *relevantDenotedValue : fieldDenotation.second.relevantValues) {
-                    if (!relevantDenotedValue->value.empty() && relevantDenotedValue->type == DenotationType::Increment) {
-                        relevantDenotedValue->value = incremented(relevantDenotedValue->value);
-                    }
-                }
-            }
-
             // alter attachments
             if (args.addAttachmentArg.isPresent() || args.updateAttachmentArg.isPresent() || args.removeAttachmentArg.isPresent()
                 || args.removeExistingAttachmentsArg.isPresent()) {
@@ -1100,37 +2166,113 @@ void setTagInfo(const SetTagInfoArgs &args)
                 }
             }
 
+            // skip writing the file if nothing would be altered
+            if (!hasChanges) {
+                if (!quiet) {
+                    out << " - Skipping file because no changes are required." << endl;
+                }
+                return;
+            }
+
+            // parse tracks and attachments now if not done yet because writing container formats relies on them (otherwise they
+            // would not be preserved)
+            if (fileInfo.container() || fileInfo.containerFormat() == ContainerFormat::Flac) {
+                file.timings.start("parse-tracks");
+                fileInfo.parseTracks(diag, parsingProgress);
+                fileInfo.parseAttachments(diag, parsingProgress);
+            }
+
             // apply changes
             auto modificationDateError = std::error_code();
             auto modificationDate = std::filesystem::file_time_type();
             auto modifiedFilePath = std::filesystem::path();
-            fileInfo.setSaveFilePath(currentOutputFile != noMoreOutputFiles ? string(*currentOutputFile) : string());
+            fileInfo.setSaveFilePath(file.outputPath && copyMethod == FastCopyMethod::None ? string(file.outputPath) : string());
+
+            const auto altersAttachments = args.addAttachmentArg.isPresent() || args.updateAttachmentArg.isPresent()
+                || args.removeAttachmentArg.isPresent() || args.removeExistingAttachmentsArg.isPresent();
+
+            // use the padding suggested from the files processed so far and record the tag growth of this file if --padding is present
+            if (paddingAdvisor) {
+                file.timings.start("plan");
+                const auto format = fileInfo.containerFormatName();
+                const auto suggestion = autoPadding ? paddingAdvisor->suggestion(format) : PaddingAdvisor::Suggestion();
+                fileInfo.setMinPadding(suggestion.isValid ? suggestion.minPadding : worker.minPadding);
+                fileInfo.setMaxPadding(suggestion.isValid ? suggestion.maxPadding : worker.maxPadding);
+                fileInfo.setPreferredPadding(suggestion.isValid ? suggestion.preferredPadding : worker.preferredPadding);
+                const auto &plan = file.rewritePlan.emplace(planRewrite(fileInfo, altersAttachments, diag));
+                paddingAdvisor->addFile(format, plan.currentTagSize, plan.currentPadding);
+                paddingAdvisor->addGrowth(format, static_cast<std::int64_t>(plan.newTagSize) - static_cast<std::int64_t>(plan.currentTagSize));
+                if (suggestion.isValid && !quiet) {
+                    out << " - Using suggested padding: min. " << suggestion.minPadding << ", max. " << suggestion.maxPadding << ", preferred "
+                        << suggestion.preferredPadding << " byte" << endl;
+                }
+            }
+
+            // only predict how the changes would be applied if --plan is present
+            if (planOnly) {
+                file.timings.start("plan");
+                if (!file.rewritePlan.has_value()) {
+                    file.rewritePlan.emplace(planRewrite(fileInfo, altersAttachments, diag));
+                }
+                printRewritePlan(out, file.rewritePlan.value());
+                return;
+            }
+
             if (args.preserveModificationTimeArg.isPresent()) {
                 modifiedFilePath = makeNativePath(fileInfo.saveFilePath().empty() ? fileInfo.path() : fileInfo.saveFilePath());
                 modificationDate = std::filesystem::last_write_time(modifiedFilePath, modificationDateError);
             }
-            try {
-                // create handler for progress updates and aborting
-                auto applyProgress = quiet ? AbortableProgressFeedback() : AbortableProgressFeedback(logNextStep, logStepPercentage);
-                const auto handler = InterruptHandler(std::bind(&AbortableProgressFeedback::tryToAbort, std::ref(applyProgress)));
 
-                // apply changes
-                fileInfo.applyChanges(diag, applyProgress);
+            // put the backup of a copy which needs to be rewritten nevertheless into a temporary directory next to it (so creating
+            // the backup is just a rename) and remove it in any case afterwards (the input file has not been touched anyways)
+            auto copyBackupDirectory = std::filesystem::path();
+            if (copyMethod != FastCopyMethod::None) {
+                auto copyBackupDirectoryError = std::error_code();
+                copyBackupDirectory = makeNativePath(file.outputPath);
+                copyBackupDirectory += ".tmp";
+                if (std::filesystem::create_directory(copyBackupDirectory, copyBackupDirectoryError)) {
+                    fileInfo.setBackupDirectory(copyBackupDirectory.string());
+                } else {
+                    copyBackupDirectory.clear();
+                }
+            }
+            const auto removeCopyBackupDirectory = [&copyBackupDirectory] {
+                if (!copyBackupDirectory.empty()) {
+                    auto copyBackupDirectoryError = std::error_code();
+                    std::filesystem::remove_all(copyBackupDirectory, copyBackupDirectoryError);
+                }
+            };
+
+            // remember the identity of the file to tell whether it has been rewritten or modified in-place
+            auto stampError = std::error_code();
+            const auto stamp = !quiet && fileInfo.saveFilePath().empty() ? FileStamp::read(fileInfo.path(), stampError) : FileStamp();
+
+            try {
+                // apply changes (progress updates are only logged when processing files one after another)
+                file.timings.start("apply-changes");
+                fileInfo.applyChanges(diag, worker.applyProgress);
 
                 // notify about completion
                 finalizeLog();
                 if (!quiet) {
-                    cout << " - Changes have been applied." << endl;
+                    out << " - Changes have been applied." << endl;
+                    printApplyMethod(out, fileInfo, copyMethod != FastCopyMethod::None, stampError ? FileStamp() : stamp);
                 }
             } catch (const TagParser::OperationAbortedException &) {
                 finalizeLog();
-                cerr << Phrases::Warning << "The operation has been aborted." << Phrases::EndFlush;
+                removeCopyBackupDirectory();
+                file.aborted = true;
+                batch.abort();
                 return;
             } catch (const TagParser::Failure &) {
                 finalizeLog();
-                cerr << " - " << Phrases::Error << "Failed to apply changes." << Phrases::EndFlush;
-                exitCode = EXIT_PARSING_FAILURE;
+                err << " - " << Phrases::Error << "Failed to apply changes." << Phrases::EndFlush;
+                file.exitCode = EXIT_PARSING_FAILURE;
+            } catch (...) {
+                removeCopyBackupDirectory();
+                throw;
             }
+            removeCopyBackupDirectory();
             if (args.preserveModificationTimeArg.isPresent()) {
                 if (!modificationDateError) {
                     std::filesystem::last_write_time(modifiedFilePath, modificationDate, modificationDateError);
@@ -1141,20 +2283,291 @@ void setTagInfo(const SetTagInfoArgs &args)
             }
         } catch (const TagParser::Failure &) {
             finalizeLog();
-            cerr << " - " << Phrases::Error << "A parsing failure occurred when reading/writing the file \"" << file << "\"." << Phrases::EndFlush;
-            exitCode = EXIT_PARSING_FAILURE;
+            err << " - " << Phrases::Error << "A parsing failure occurred when reading/writing the file \"" << path << "\"." << Phrases::EndFlush;
+            file.exitCode = EXIT_PARSING_FAILURE;
         } catch (const std::ios_base::failure &e) {
             finalizeLog();
-            cerr << " - " << Phrases::Error << "An IO error occurred when reading/writing the file \"" << file << "\": " << e.what()
-                 << Phrases::EndFlush;
-            exitCode = EXIT_IO_FAILURE;
+            err << " - " << Phrases::Error << "An IO error occurred when reading/writing the file \"" << path << "\": " << e.what()
+                << Phrases::EndFlush;
+            file.exitCode = EXIT_IO_FAILURE;
+        }
+    };
+
+    // prints the buffered output and diagnostic messages of the file in the specified slot (always from the main thread in order)
+    const auto emitFile = [&](std::size_t slot) {
+        auto &file = files[slot];
+        const auto progressLock = batchProgress ? batchProgress->clearLine() : std::unique_lock<std::mutex>();
+        if (bufferOutput) {
+            std::cout << file.out.str() << std::flush;
+            std::cerr << file.err.str() << std::flush;
+        }
+        if (file.aborted) {
+            cerr << Phrases::Warning << "The operation has been aborted." << Phrases::EndFlush;
+            return;
+        }
+        if (file.exitCode != EXIT_SUCCESS) {
+            exitCode = file.exitCode;
+        }
+        if (file.rewritePlan.has_value()) {
+            planTotals.add(file.rewritePlan.value());
         }
-        continueWithNextFile(diag);
+        printDiagMessages(file.diag, "Diagnostic messages:", args.verboseArg.isPresent(), &args.pedanticArg);
+        if (timings) {
+            timings->add(file.timings);
+        }
+    };
+
+    // records that the file has been processed successfully so it is skipped when running the same operation again (possibly from a
+    // worker thread)
+    const auto recordFinishedFile = [&](SetTagInfoFile &file) {
+        if (file.upToDate || file.aborted || file.exitCode != EXIT_SUCCESS) {
+            return;
+        }
+        // store files only if there are no warnings (like in the "get"-operation) so the warnings are shown again next time
+        if (stateDatabase && !file.outputPath && !file.diag.has(DiagLevel::Warning)) {
+            auto stampError = std::error_code();
+            if (const auto stamp = FileStamp::read(file.path, stampError); !stampError) {
+                stateDatabase->store(file.operationHash, file.path, stamp, std::string_view());
+            }
+        }
+        // consider files with diagnostic messages which lead to a failing exit code as not finished (so they are processed again)
+        if (!file.journaled || file.diag.level() >= badExitLevel(&args.pedanticArg)) {
+            return;
+        }
+        auto stateError = std::error_code();
+        const auto state = JournalFileState::read(makeNativePath(file.path), stateError);
+        if (stateError) {
+            return;
+        }
+        try {
+            journal->finish(file.path, file.operationHash, state);
+        } catch (const std::ios_base::failure &e) {
+            (bufferOutput ? static_cast<std::ostream &>(file.err) : std::cerr)
+                << " - " << Phrases::Error << "Unable to update the journal: " << e.what() << Phrases::EndFlush;
+            file.exitCode = EXIT_IO_FAILURE;
+        }
+    };
+
+    // iterate through all specified files; abort ongoing processing of all workers when receiving a signal
+    const auto handler = InterruptHandler([&batch, &workers] {
+        batch.abort();
+        for (auto &worker : workers) {
+            worker->applyProgress.tryToAbort();
+        }
+    });
+    try {
+        // stop the timings on the worker thread as they measure the CPU time and the I/O of the thread
+        batch.run(
+            prepareFile,
+            [&](std::size_t workerIndex, std::size_t slot) {
+                processFile(workerIndex, slot);
+                recordFinishedFile(files[slot]);
+                files[slot].timings.stop();
+                if (batchProgress) {
+                    batchProgress->finishFile(workerIndex);
+                }
+            },
+            emitFile);
+    } catch (const std::exception &) {
+        if (!manifest) {
+            throw;
+        }
+        exitDueToManifestError(manifestPath, manifest->lineNumber());
+    }
+    if (batchProgress) {
+        batchProgress->finish();
+    }
+    if (stateDatabase) {
+        saveStateDatabase(*stateDatabase, args.incrementalArg);
+    }
+    if (planOnly) {
+        printRewritePlanTotals(std::cout, planTotals);
+    }
+    if (paddingAdvisor) {
+        paddingAdvisor->printReport(std::cout);
+        std::cout << std::flush;
+    }
+    if (timings) {
+        timings->printSummary();
     }
 }
 
+/*!
+ * \brief Writes the data of the specified \a attachment of \a fileInfo to \a outputStream.
+ * \remarks The data is written directly from the \a mapping of the file (if present) instead of copying it via a buffer.
+ */
+static void writeAttachmentData(
+    const AbstractAttachment &attachment, MediaFileInfo &fileInfo, const std::optional<FileMapping> &mapping, std::ostream &outputStream)
+{
+    const auto *const data = attachment.data();
+    if (!data) {
+        return;
+    }
+    if (mapping && &data->stream() == &static_cast<std::istream &>(fileInfo.stream())) {
+        const auto view = mapping->view(static_cast<std::uint64_t>(std::streamoff(data->startOffset())), data->size());
+        if (view.size() == data->size()) {
+            outputStream.write(view.data(), static_cast<std::streamsize>(view.size()));
+            return;
+        }
+    }
+    data->copyTo(outputStream);
+}
+
+/*!
+ * \brief Writes the data of the specified \a attachment of \a fileInfo to the file at \a path or to stdout if \a path is empty.
+ *
+ * If the data is stored within the file, it is copied within the kernel via copy_file_range() or sendfile() so it is not passed
+ * through a userspace buffer. Otherwise (or if the kernel can not copy the data) writeAttachmentData() is used.
+ *
+ * \returns Returns the method used to copy the data; FastCopyMethod::None means a regular copy has been made.
+ */
+static FastCopyMethod writeAttachment(
+    const AbstractAttachment &attachment, MediaFileInfo &fileInfo, const std::optional<FileMapping> &mapping, const std::string &path)
+{
+    const auto *const data = attachment.data();
+    if (data && &data->stream() == &static_cast<std::istream &>(fileInfo.stream())) {
+        const auto offset = static_cast<std::uint64_t>(std::streamoff(data->startOffset()));
+        auto method = FastCopyMethod::None;
+        if (path.empty()) {
+            cout.flush();
+            method = fastCopyRangeToStdout(fileInfo.path(), offset, data->size());
+        } else {
+            method = fastCopyRange(fileInfo.path(), offset, data->size(), path);
+        }
+        if (method != FastCopyMethod::None) {
+            return method;
+        }
+    }
+    if (path.empty()) {
+        writeAttachmentData(attachment, fileInfo, mapping, cout);
+        return FastCopyMethod::None;
+    }
+    auto outputFileStream = NativeFileStream();
+    outputFileStream.exceptions(ios_base::failbit | ios_base::badbit);
+    outputFileStream.open(path, ios_base::out | ios_base::binary | ios_base::trunc);
+    writeAttachmentData(attachment, fileInfo, mapping, outputFileStream);
+    outputFileStream.flush();
+    return FastCopyMethod::None;
+}
+
+/*!
+ * \brief Returns the SHA-256 of the data of the specified \a attachment of \a fileInfo as lower-case hex string.
+ * \remarks The data is read from the \a mapping of the file (if present) or in chunks from the stream it is stored in.
+ */
+static std::string attachmentDigest(const AbstractAttachment &attachment, MediaFileInfo &fileInfo, const std::optional<FileMapping> &mapping)
+{
+    auto sha256 = Sha256();
+    const auto *const data = attachment.data();
+    if (!data) {
+        return Sha256::toHex(sha256.finalize());
+    }
+    if (mapping && &data->stream() == &static_cast<std::istream &>(fileInfo.stream())) {
+        const auto view = mapping->view(static_cast<std::uint64_t>(std::streamoff(data->startOffset())), data->size());
+        if (view.size() == data->size()) {
+            sha256.update(view);
+            return Sha256::toHex(sha256.finalize());
+        }
+    }
+    auto &stream = data->stream();
+    auto buffer = std::make_unique<char[]>(0x10000);
+    stream.seekg(data->startOffset());
+    for (auto remaining = data->size(); remaining;) {
+        const auto chunkSize = std::min<std::uint64_t>(remaining, 0x10000);
+        stream.read(buffer.get(), static_cast<std::streamsize>(chunkSize));
+        sha256.update(buffer.get(), static_cast<std::size_t>(chunkSize));
+        remaining -= chunkSize;
+    }
+    return Sha256::toHex(sha256.finalize());
+}
+
+/*!
+ * \brief Returns a file name for the specified \a attachment which is not contained by \a usedNames.
+ * \remarks The name of the attachment is used if possible. Path separators are replaced and a number is appended if the
+ *          name is already used (e.g. by an attachment with the same name from another file).
+ */
+static std::string attachmentFileName(const AbstractAttachment &attachment, const std::unordered_set<std::string> &usedNames)
+{
+    auto name = attachment.name().empty() ? argsToString("attachment-", attachment.id()) : attachment.name();
+    std::replace(name.begin(), name.end(), '/', '_');
+    std::replace(name.begin(), name.end(), '\\', '_');
+    if (name.find_first_not_of('.') == std::string::npos) {
+        name.insert(0, "attachment");
+    }
+    if (name != "index.tsv" && usedNames.find(name) == usedNames.end()) {
+        return name;
+    }
+    const auto nameWithoutExtension = BasicFileInfo::pathWithoutExtension(name), extension = BasicFileInfo::extension(name);
+    for (auto number = 1u;; ++number) {
+        auto candidate = argsToString(nameWithoutExtension, '-', number, extension);
+        if (usedNames.find(candidate) == usedNames.end()) {
+            return candidate;
+        }
+    }
+}
+
+/*!
+ * \brief Stores the specified \a attachment of \a fileInfo in the directory of \a blobStore and adds an entry for it to the \a index.
+ *
+ * The attachment is stored under its name unless \a dedup is set. In that case it is stored content-addressed so identical
+ * attachments of many files (e.g. fonts) are only stored once. The path relative to the directory is added to \a storedPaths.
+ *
+ * \remarks IO errors are printed and set the exit code.
+ */
+static void storeAttachment(const AbstractAttachment &attachment, MediaFileInfo &fileInfo, const std::optional<FileMapping> &mapping,
+    BlobStore &blobStore, bool dedup, std::ostream &index, std::unordered_set<std::string> &storedPaths, FileTimings &fileTimings)
+{
+    fileTimings.start("write");
+    try {
+        auto relativePath = std::string();
+        if (dedup) {
+            const auto digest = attachmentDigest(attachment, fileInfo, mapping);
+            blobStore.store(digest, [&](const std::string &path) { writeAttachment(attachment, fileInfo, mapping, path); });
+            relativePath = BlobStore::relativePath(digest);
+        } else {
+            const auto &directory = blobStore.directory();
+            relativePath = attachmentFileName(attachment, storedPaths);
+            writeAttachment(attachment, fileInfo, mapping, argsToString(directory, directory.back() == '/' ? "" : "/", relativePath));
+        }
+        index << fileInfo.path() << '\t' << attachment.name() << '\t' << attachment.mimeType() << '\t'
+              << (attachment.data() ? attachment.data()->size() : 0) << '\t' << relativePath << '\n';
+        storedPaths.emplace(std::move(relativePath));
+    } catch (const std::system_error &e) {
+        cerr << Phrases::Error << "Unable to store attachment \"" << attachment.name() << "\" of \"" << fileInfo.path() << "\" in \""
+             << blobStore.directory() << "\": " << e.what() << Phrases::End;
+        exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
+    }
+}
+
+/*!
+ * \brief Stores the specified \a value of \a tag from \a file in \a blobStore and adds an entry for it to the \a index.
+ * \remarks The digest is added to \a storedDigests. IO errors are printed and set the exit code.
+ */
+static void storeValue(BlobStore &blobStore, const TagValue &value, const char *file, const Tag *tag, std::ostream &index,
+    std::unordered_set<std::string> &storedDigests, FileTimings &fileTimings)
+{
+    fileTimings.start("write");
+    try {
+        const auto digest = blobStore.store(std::string_view(value.dataPointer(), value.dataSize()));
+        index << file << '\t' << tag->typeName() << '\t' << value.mimeType() << '\t' << value.dataSize() << '\t' << BlobStore::relativePath(digest)
+              << '\n';
+        storedDigests.emplace(digest);
+    } catch (const std::system_error &e) {
+        cerr << Phrases::Error << "Unable to store value of \"" << file << "\" in \"" << blobStore.directory() << "\": " << e.what() << Phrases::End;
+        exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
+    }
+}
+
+/*!
+ * \brief Implements the "extract"-operation of the CLI.
+ * \remarks
+ * - Values and attachments are written to stdout or stored in the directory specified via --output-dir right after their file has
+ *   been parsed. Only if an output file or an index is specified, values are copied so they can be written after all files have been
+ *   read. Attachments are always written right away as only their location within the file is known.
+ * - Attachments are copied within the kernel if possible (see writeAttachment()).
+ */
 void extractField(const Argument &fieldArg, const Argument &attachmentArg, const Argument &inputFilesArg, const Argument &outputFileArg,
-    const Argument &indexArg, const Argument &verboseArg)
+    const Argument &outputDirArg, const Argument &dedupArg, const Argument &indexArg, const Argument &verboseArg, const Argument &timingsArg,
+    const Argument &progressArg, const Argument &mmapArg)
 {
     CMD_UTILS_START_CONSOLE;
 
@@ -1187,23 +2600,77 @@ void extractField(const Argument &fieldArg, const Argument &attachmentArg, const
         }
     }
 
+    // open blob store and index when storing values/attachments in an output directory
+    auto blobStore = std::optional<BlobStore>();
+    auto indexFile = NativeFileStream();
+    auto indexPath = std::string();
+    auto storedFiles = std::unordered_set<std::string>();
+    if (dedupArg.isPresent() && !outputDirArg.isPresent()) {
+        std::cerr << Phrases::Error << "Deduplication is only possible when specifying an output directory." << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+    if (outputDirArg.isPresent()) {
+        if (outputFileArg.isPresent() || indexArg.isPresent()) {
+            std::cerr << Phrases::Error << "An output directory can not be combined with an output file or an index." << Phrases::EndFlush;
+            std::exit(EXIT_FAILURE);
+        }
+        const auto directory = std::string_view(outputDirArg.values().front());
+        indexPath = argsToString(directory, directory.empty() || directory.back() == '/' ? "" : "/", "index.tsv");
+        try {
+            blobStore.emplace(directory);
+            std::filesystem::create_directories(makeNativePath(directory));
+            indexFile.exceptions(ios_base::failbit | ios_base::badbit);
+            indexFile.open(indexPath, ios_base::out | ios_base::trunc | ios_base::binary);
+            indexFile << (fieldDenotations.empty() ? "file\tattachment\tmime-type\tsize\tpath\n" : "file\ttag\tmime-type\tsize\tblob\n");
+        } catch (const std::system_error &e) {
+            std::cerr << Phrases::Error << "Unable to create the index \"" << indexPath << "\": " << e.what() << Phrases::EndFlush;
+            std::exit(EXIT_IO_FAILURE);
+        }
+    }
+
     // read values/attachments
+    auto timings = std::optional<TimingsReport>();
+    if (timingsArg.isPresent()) {
+        timings.emplace(timingsArg);
+    }
+    auto batchProgress = std::optional<BatchProgress>();
+    if (progressArg.isPresent()) {
+        batchProgress.emplace(inputFilesArg.values().size(), BatchProgress::totalSize(inputFilesArg.values()));
+    }
     auto inputFileInfo = MediaFileInfo();
-    auto values = std::vector<std::pair<const TagValue *, std::string>>();
-    auto attachments = std::vector<std::pair<const AbstractAttachment *, std::string>>();
+    auto mapping = std::optional<FileMapping>();
+    auto fileTimings = FileTimings(timings.has_value());
+    // values are only collected (and thus copied) if they can not be written right away (the MediaFileInfo is re-used for all files)
+    const auto collectValues = outputFileArg.isPresent() || index != noIndex;
+    auto values = std::vector<std::pair<TagValue, std::string>>();
+    auto valueCount = std::size_t();
+    auto attachments = std::vector<const AbstractAttachment *>();
     auto diag = Diagnostics();
     for (const char *file : inputFilesArg.values()) {
-        auto progress = AbortableProgressFeedback(); // FIXME: actually use the progress object
+        auto progress = batchProgress ? batchProgress->feedback(0) : AbortableProgressFeedback();
+        fileTimings.reset(file);
         try {
             // setup media file info
+            mapping.reset();
             inputFileInfo.setPath(std::string_view(file));
+            fileTimings.start("open");
             inputFileInfo.open(true);
+            if (mmapArg.isPresent()) {
+                mapping.emplace(inputFileInfo, AccessPattern::Random);
+            }
+            if (batchProgress) {
+                batchProgress->startFile(0, inputFileInfo.size());
+                batchProgress->clearLine();
+            }
 
             // extract either tag field or attachment
             if (!fieldDenotations.empty()) {
                 // extract tag field
-                (outputFileArg.isPresent() ? cout : cerr) << "Extracting field " << fieldArg.values().front() << " of \"" << file << "\" ..." << endl;
+                (outputFileArg.isPresent() || blobStore ? cout : cerr)
+                    << "Extracting field " << fieldArg.values().front() << " of \"" << file << "\" ..." << endl;
+                fileTimings.start("parse-container");
                 inputFileInfo.parseContainerFormat(diag, progress);
+                fileTimings.start("parse-tags");
                 inputFileInfo.parseTags(diag, progress);
                 auto tags = inputFileInfo.tags();
                 // iterate through all tags
@@ -1217,7 +2684,15 @@ void extractField(const Argument &fieldArg, const Argument &attachmentArg, const
                                 continue;
                             }
                             for (const TagValue *value : valuesForField.first) {
-                                values.emplace_back(value, joinStrings({ std::string(tag->typeName()), numberToString(values.size()) }, "-", true));
+                                if (blobStore) {
+                                    storeValue(*blobStore, *value, file, tag, indexFile, storedFiles, fileTimings);
+                                } else if (collectValues) {
+                                    values.emplace_back(
+                                        *value, joinStrings({ std::string(tag->typeName()), numberToString(valueCount) }, "-", true));
+                                } else {
+                                    cout.write(value->dataPointer(), static_cast<std::streamsize>(value->dataSize()));
+                                }
+                                ++valueCount;
                             }
                         } catch (const ConversionException &e) {
                             diag.emplace_back(DiagLevel::Critical,
@@ -1228,7 +2703,7 @@ void extractField(const Argument &fieldArg, const Argument &attachmentArg, const
                 }
             } else {
                 // extract attachment
-                auto &logStream = (outputFileArg.isPresent() ? cout : cerr);
+                auto &logStream = (outputFileArg.isPresent() || blobStore ? cout : cerr);
                 logStream << "Extracting attachment with ";
                 if (attachmentInfo.hasId) {
                     logStream << "ID " << attachmentInfo.id;
@@ -1237,34 +2712,92 @@ void extractField(const Argument &fieldArg, const Argument &attachmentArg, const
                 }
                 logStream << " of \"" << file << "\" ..." << endl;
 
+                fileTimings.start("parse-container");
                 inputFileInfo.parseContainerFormat(diag, progress);
+                fileTimings.start("parse-attachments");
                 inputFileInfo.parseAttachments(diag, progress);
 
-                // iterate through all attachments
+                // write matching attachments right away (the attachments are invalidated when the next file is opened)
+                attachments.clear();
                 for (const AbstractAttachment *attachment : inputFileInfo.attachments()) {
                     if ((attachmentInfo.hasId && attachment->id() == attachmentInfo.id) || (attachment->name() == attachmentInfo.name)) {
-                        attachments.emplace_back(attachment, joinStrings({ attachment->name(), numberToString(attachments.size()) }, "-", true));
+                        attachments.emplace_back(attachment);
+                    }
+                }
+                const auto useOutputFilePath = index != noIndex || (inputFilesArg.values().size() == 1 && attachments.size() == 1);
+                for (const auto *const attachment : attachments) {
+                    const auto attachmentIndex = valueCount++;
+                    if (index != noIndex && index != attachmentIndex) {
+                        continue;
+                    }
+                    if (blobStore) {
+                        storeAttachment(
+                            *attachment, inputFileInfo, mapping, *blobStore, dedupArg.isPresent(), indexFile, storedFiles, fileTimings);
+                        continue;
+                    }
+                    auto path = std::string();
+                    if (outputFileArg.isPresent()) {
+                        const auto *const outputFilePath = outputFileArg.values().front();
+                        path = useOutputFilePath ? std::string(outputFilePath)
+                                                 : joinStrings({ BasicFileInfo::pathWithoutExtension(outputFilePath), "-",
+                                                     joinStrings({ attachment->name(), numberToString(attachmentIndex) }, "-", true),
+                                                     BasicFileInfo::extension(outputFilePath) });
+                    }
+                    fileTimings.start("write");
+                    try {
+                        writeAttachment(*attachment, inputFileInfo, mapping, path);
+                        if (!path.empty()) {
+                            cout << "Value has been saved to \"" << path << "\"." << endl;
+                        }
+                    } catch (const std::ios_base::failure &e) {
+                        cerr << Phrases::Error << "An IO error occurred when writing the file \"" << (path.empty() ? "stdout" : path)
+                             << "\": " << e.what() << Phrases::End;
+                        exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
                     }
                 }
             }
         } catch (const TagParser::Failure &) {
+            if (batchProgress) {
+                batchProgress->clearLine();
+            }
             cerr << Phrases::Error << "A parsing failure occurred when reading the file \"" << file << "\"." << Phrases::End;
             exitCode = EXIT_PARSING_FAILURE;
         } catch (const std::ios_base::failure &e) {
+            if (batchProgress) {
+                batchProgress->clearLine();
+            }
             cerr << Phrases::Error << "An IO error occurred when reading the file \"" << file << "\": " << e.what() << Phrases::End;
             exitCode = EXIT_IO_FAILURE;
         }
+        if (timings) {
+            timings->add(fileTimings);
+        }
+        if (batchProgress) {
+            batchProgress->finishFile(0);
+        }
+    }
+    if (batchProgress) {
+        batchProgress->finish();
     }
 
-    // write values/attachments
+    // write values/attachments (the timings of writing are recorded per output file)
     if (!fieldDenotations.empty()) {
-        if (values.empty()) {
+        if (!valueCount) {
             cerr << Phrases::Error << "None of the specified files has a (supported) " << fieldArg.values().front() << " field." << Phrases::End;
             exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_FAILURE;
         } else if (index != noIndex && index >= values.size()) {
             cerr << Phrases::Error << "The specified index is out of range as the specified files/fields have only " << values.size() << " values."
                  << Phrases::End;
             exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_FAILURE;
+        } else if (blobStore) {
+            try {
+                indexFile.flush();
+            } catch (const std::ios_base::failure &e) {
+                cerr << Phrases::Error << "An IO error occurred when writing the index \"" << indexPath << "\": " << e.what() << Phrases::End;
+                exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
+            }
+            cout << "Stored " << valueCount << " values as " << storedFiles.size() << " distinct files in \"" << blobStore->directory()
+                 << "\"; the index has been saved to \"" << indexPath << "\"." << endl;
         } else if (outputFileArg.isPresent()) {
             if (index != noIndex) {
                 if (index) {
@@ -1282,125 +2815,373 @@ void extractField(const Argument &fieldArg, const Argument &attachmentArg, const
                 outputFileStream.exceptions(ios_base::failbit | ios_base::badbit);
                 auto path = values.size() > 1 ? joinStrings({ outputFilePathWithoutExtension, "-", value.second, outputFileExtension })
                                               : outputFileArg.values().front();
+                fileTimings.reset(path);
+                fileTimings.start("write");
                 try {
                     outputFileStream.open(path, ios_base::out | ios_base::binary);
-                    outputFileStream.write(value.first->dataPointer(), static_cast<std::streamsize>(value.first->dataSize()));
+                    outputFileStream.write(value.first.dataPointer(), static_cast<std::streamsize>(value.first.dataSize()));
                     outputFileStream.flush();
+                    fileTimings.stop();
                     cout << "Value has been saved to \"" << path << "\"." << endl;
                 } catch (const std::ios_base::failure &e) {
                     cerr << Phrases::Error << "An IO error occurred when writing the file \"" << path << "\": " << e.what() << Phrases::End;
                     exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
                 }
+                if (timings) {
+                    timings->add(fileTimings);
+                }
             }
         } else {
-            // write data to stdout if no output file has been specified
+            // write data to stdout if no output file has been specified (values have only been collected if an index is specified)
             for (const auto &value : values) {
-                cout.write(value.first->dataPointer(), static_cast<std::streamsize>(value.first->dataSize()));
+                cout.write(value.first.dataPointer(), static_cast<std::streamsize>(value.first.dataSize()));
             }
         }
     } else {
-        if (attachments.empty()) {
+        if (!valueCount) {
             cerr << Phrases::Error << "None of the specified files has a (supported) attachment with the specified ID/name." << Phrases::End;
             exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_FAILURE;
-        } else if (index != noIndex && index >= values.size()) {
-            cerr << Phrases::Error << "The specified index is out of range as the specified files have only " << attachments.size() << " attachments."
+        } else if (index != noIndex && index >= valueCount) {
+            cerr << Phrases::Error << "The specified index is out of range as the specified files have only " << valueCount << " attachments."
                  << Phrases::End;
             exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_FAILURE;
-        } else if (outputFileArg.isPresent()) {
-            if (index != noIndex) {
-                if (index) {
-                    attachments[index].swap(attachments.front());
-                }
-                attachments.resize(1);
-            }
-            auto outputFilePathWithoutExtension = std::string(), outputFileExtension = std::string();
-            if (attachments.size() > 1) {
-                outputFilePathWithoutExtension = BasicFileInfo::pathWithoutExtension(outputFileArg.values().front());
-                outputFileExtension = BasicFileInfo::extension(outputFileArg.values().front());
-            }
-            for (const auto &attachment : attachments) {
-                auto outputFileStream = NativeFileStream();
-                outputFileStream.exceptions(ios_base::failbit | ios_base::badbit);
-                auto path = attachments.size() > 1 ? joinStrings({ outputFilePathWithoutExtension, "-", attachment.second, outputFileExtension })
-                                                   : outputFileArg.values().front();
-                try {
-                    outputFileStream.open(path, ios_base::out | ios_base::binary);
-                    attachment.first->data()->copyTo(outputFileStream);
-                    outputFileStream.flush();
-                    cout << "Value has been saved to \"" << path << "\"." << endl;
-                } catch (const std::ios_base::failure &e) {
-                    cerr << Phrases::Error << "An IO error occurred when writing the file \"" << path << "\": " << e.what() << Phrases::EndFlush;
-                    exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
-                }
-            }
-        } else {
-            for (const auto &attachment : attachments) {
-                attachment.first->data()->copyTo(cout);
+        } else if (blobStore) {
+            try {
+                indexFile.flush();
+            } catch (const std::ios_base::failure &e) {
+                cerr << Phrases::Error << "An IO error occurred when writing the index \"" << indexPath << "\": " << e.what() << Phrases::End;
+                exitCode = exitCode != EXIT_SUCCESS ? exitCode : EXIT_IO_FAILURE;
             }
+            cout << "Stored " << valueCount << " attachments as " << storedFiles.size() << " distinct files in \"" << blobStore->directory()
+                 << "\"; the index has been saved to \"" << indexPath << "\"." << endl;
         }
     }
 
     printDiagMessages(diag, "Diagnostic messages:", verboseArg.isPresent());
+    if (timings) {
+        timings->printSummary();
+    }
 }
 
-void exportToJson(const ArgumentOccurrence &, const Argument &filesArg, const Argument &prettyArg)
+#ifdef TAGEDITOR_JSON_EXPORT
+/*!
+ * \brief The ExportFile struct holds the state of a file processed by the "export"-operation.
+ */
+struct ExportFile {
+    std::string path;
+    FileStamp stamp;
+    std::error_code stampError;
+    std::optional<std::string_view> cachedJson;
+    std::string json;
+    std::string error;
+    FileTimings timings;
+    Diagnostics diag;
+    int exitCode = EXIT_SUCCESS;
+};
+
+/*!
+ * \brief The ExportWorker struct holds the objects a worker of the "export"-operation re-uses for all files it processes.
+ * \remarks The JSON values of a file are allocated from a pool which is cleared after each file so the memory usage does not
+ *          grow with the number of files. The pool keeps its initial buffer so usual files do not lead to allocations.
+ */
+struct ExportWorker {
+    static constexpr std::size_t initialPoolSize = 64 * 1024;
+
+    ExportWorker();
+
+    MediaFileInfo fileInfo;
+    std::unique_ptr<char[]> poolBuffer;
+    RAPIDJSON_NAMESPACE::Document::AllocatorType allocator;
+    RAPIDJSON_NAMESPACE::StringBuffer buffer;
+};
+
+ExportWorker::ExportWorker()
+    : poolBuffer(std::make_unique<char[]>(initialPoolSize))
+    , allocator(poolBuffer.get(), initialPoolSize)
+{
+}
+
+/*!
+ * \brief Adds the diagnostic messages from \a diag which are at least warnings as "diagnostics" to the specified \a fileValue.
+ * \remarks Nothing is added if there are no such messages.
+ */
+static void addDiagMessages(RAPIDJSON_NAMESPACE::Value &fileValue, const Diagnostics &diag, RAPIDJSON_NAMESPACE::Document::AllocatorType &allocator)
+{
+    const auto stringValue = [&allocator](const std::string &string) {
+        return RAPIDJSON_NAMESPACE::Value(string.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(string.size()), allocator);
+    };
+    auto messages = RAPIDJSON_NAMESPACE::Value(RAPIDJSON_NAMESPACE::kArrayType);
+    for (const auto &message : diag) {
+        if (message.level() < DiagLevel::Warning) {
+            continue;
+        }
+        auto messageValue = RAPIDJSON_NAMESPACE::Value(RAPIDJSON_NAMESPACE::kObjectType);
+        messageValue.AddMember("level", RAPIDJSON_NAMESPACE::StringRef(DiagMessage::levelName(message.level())), allocator);
+        messageValue.AddMember("context", stringValue(message.context()), allocator);
+        messageValue.AddMember("message", stringValue(message.message()), allocator);
+        messages.PushBack(messageValue, allocator);
+    }
+    if (!messages.Empty()) {
+        fileValue.AddMember("diagnostics", messages, allocator);
+    }
+}
+#endif
+
+void exportToJson(const ArgumentOccurrence &, const FileListArgs &fileListArgs, const Argument &prettyArg, const Argument &ndjsonArg,
+    const Argument &blobsArg, const Argument &jobsArg, const Argument &timingsArg, const Argument &progressArg, const Argument &incrementalArg,
+    const Argument &mmapArg)
 {
     CMD_UTILS_START_CONSOLE;
 
 #ifdef TAGEDITOR_JSON_EXPORT
     // check whether files have been specified
-    if (!filesArg.isPresent() || filesArg.values().empty()) {
-        std::cerr << Phrases::Error << "No files have been specified." << Phrases::End;
+    auto fileList = std::optional<FileList>();
+    openFileList(fileList, fileListArgs);
+    const auto pretty = prettyArg.isPresent(), lineDelimited = ndjsonArg.isPresent();
+    if (pretty && lineDelimited) {
+        cerr << Phrases::Error << "Pretty-printing is not possible when printing one JSON object per line." << Phrases::EndFlush;
         std::exit(EXIT_FAILURE);
     }
+    auto blobStore = std::optional<BlobStore>();
+    if (blobsArg.isPresent()) {
+        if (blobsArg.values().empty()) {
+            cerr << Phrases::Error << "No blob directory has been specified." << Phrases::End
+                 << "note: Specify \"hash-only\" to only print the digests of binary values." << endl;
+            std::exit(EXIT_FAILURE);
+        }
+        const auto blobDirectory = std::string_view(blobsArg.values().front());
+        blobStore.emplace(blobDirectory == "hash-only" ? std::string_view() : blobDirectory);
+    }
 
-    RAPIDJSON_NAMESPACE::Document document(RAPIDJSON_NAMESPACE::kArrayType);
-    std::vector<Json::FileInfo> jsonData;
-    MediaFileInfo fileInfo;
+    auto batch = BatchProcessor(parseJobCount(jobsArg));
+    auto timings = std::optional<TimingsReport>();
+    if (timingsArg.isPresent()) {
+        timings.emplace(timingsArg);
+    }
+    auto batchProgress = std::optional<BatchProgress>();
+    if (progressArg.isPresent()) {
+        batchProgress.emplace(fileList->count(), fileList->totalSize(), batch.jobs());
+    }
+    auto openedStateDatabase = std::optional<StateDatabase>();
+    auto *stateDatabase = static_cast<StateDatabase *>(nullptr);
+    auto operationHash = std::uint64_t();
+    if (incrementalArg.isPresent()) {
+        stateDatabase = openStateDatabase(openedStateDatabase, incrementalArg);
+        operationHash = hashIncrementalArguments("export", { &blobsArg });
+    }
+    auto files = std::vector<ExportFile>(batch.slotCount());
+    auto workers = std::vector<std::unique_ptr<ExportWorker>>();
+    workers.reserve(batch.jobs());
+    for (auto i = std::size_t(); i != batch.jobs(); ++i) {
+        workers.emplace_back(std::make_unique<ExportWorker>());
+    }
 
-    // gather tags for each file
-    Diagnostics diag; // FIXME: actually use diag object
-    AbortableProgressFeedback progress; // FIXME: actually use the progress object
-    for (const char *file : filesArg.values()) {
-        try {
-            // parse tags
-            fileInfo.setPath(std::string(file));
-            fileInfo.open(true);
-            fileInfo.parseContainerFormat(diag, progress);
-            fileInfo.parseTags(diag, progress);
-            fileInfo.parseTracks(diag, progress);
-            jsonData.emplace_back(fileInfo, document.GetAllocator());
-        } catch (const TagParser::Failure &) {
-            cerr << Phrases::Error << "A parsing failure occurred when reading the file \"" << file << "\"." << Phrases::EndFlush;
-            exitCode = EXIT_PARSING_FAILURE;
-        } catch (const std::ios_base::failure &e) {
-            cerr << Phrases::Error << "An IO error occurred when reading the file \"" << file << "\": " << e.what() << Phrases::EndFlush;
-            exitCode = EXIT_IO_FAILURE;
+    // assigns the next file to the specified slot
+    const auto prepareFile = [&](std::size_t, std::size_t slot) {
+        const char *const path = nextFile(*fileList);
+        if (!path) {
+            return false;
         }
-    }
+        auto &file = files[slot];
+        file.path.assign(path);
+        file.cachedJson.reset();
+        file.json.clear();
+        file.error.clear();
+        file.timings = FileTimings(timings.has_value());
+        file.timings.reset(file.path);
+        file.diag.clear();
+        file.exitCode = EXIT_SUCCESS;
+        return true;
+    };
 
-    // TODO: serialize diag messages
+    // converts the file in the specified slot to JSON (possibly from a worker thread)
+    const auto processFile = [&](std::size_t workerIndex, std::size_t slot) {
+        auto &worker = *workers[workerIndex];
+        auto &fileInfo = worker.fileInfo;
+        auto &file = files[slot];
+        auto progress = batchProgress ? batchProgress->feedback(workerIndex) : AbortableProgressFeedback();
+
+        // use the JSON object from the last run if the file has not been changed since then
+        if (stateDatabase) {
+            file.stampError.clear();
+            file.stamp = FileStamp::read(file.path, file.stampError);
+            file.cachedJson = !file.stampError ? stateDatabase->lookup(operationHash, file.path, file.stamp) : std::nullopt;
+            if (file.cachedJson && !pretty) {
+                file.json.assign(file.cachedJson->data(), file.cachedJson->size());
+                return;
+            }
+        }
 
-    // print the gathered data as JSON document
-    ReflectiveRapidJSON::JsonReflector::push(jsonData, document, document.GetAllocator());
-    RAPIDJSON_NAMESPACE::OStreamWrapper osw(cout);
-    if (prettyArg.isPresent()) {
-        RAPIDJSON_NAMESPACE::PrettyWriter<RAPIDJSON_NAMESPACE::OStreamWrapper> writer(osw);
-        document.Accept(writer);
-    } else {
-        RAPIDJSON_NAMESPACE::Writer<RAPIDJSON_NAMESPACE::OStreamWrapper> writer(osw);
-        document.Accept(writer);
+        auto fileValue = RAPIDJSON_NAMESPACE::Value();
+        auto cachedDocument = RAPIDJSON_NAMESPACE::Document(&worker.allocator);
+        if (file.cachedJson) {
+            cachedDocument.Parse(file.cachedJson->data(), file.cachedJson->size());
+            if (!cachedDocument.HasParseError() && cachedDocument.IsObject()) {
+                fileValue = static_cast<RAPIDJSON_NAMESPACE::Value &>(cachedDocument);
+            } else {
+                file.cachedJson.reset();
+            }
+        }
+        if (!file.cachedJson) {
+            try {
+                // parse tags and tracks
+                fileInfo.setPath(file.path);
+                file.timings.start("open");
+                fileInfo.open(true);
+                auto mapping = std::optional<FileMapping>();
+                if (mmapArg.isPresent()) {
+                    mapping.emplace(fileInfo, AccessPattern::Random);
+                }
+                if (batchProgress) {
+                    batchProgress->startFile(workerIndex, fileInfo.size());
+                }
+                file.timings.start("parse-container");
+                fileInfo.parseContainerFormat(file.diag, progress);
+                file.timings.start("parse-tags");
+                fileInfo.parseTags(file.diag, progress);
+                file.timings.start("parse-tracks");
+                fileInfo.parseTracks(file.diag, progress);
+                file.timings.start("convert");
+                ReflectiveRapidJSON::JsonReflector::push(
+                    Json::FileInfo(fileInfo, worker.allocator, blobStore ? &blobStore.value() : nullptr), fileValue, worker.allocator);
+                addDiagMessages(fileValue, file.diag, worker.allocator);
+            } catch (const TagParser::Failure &) {
+                file.error = argsToString("A parsing failure occurred when reading the file \"", file.path, "\".");
+                file.exitCode = EXIT_PARSING_FAILURE;
+            } catch (const std::ios_base::failure &e) {
+                file.error = argsToString("An IO error occurred when reading the file \"", file.path, "\": ", e.what());
+                file.exitCode = EXIT_IO_FAILURE;
+            }
+        }
+
+        // serialize the JSON object right away so the pool can be cleared
+        if (file.exitCode == EXIT_SUCCESS) {
+            auto &buffer = worker.buffer;
+            if (stateDatabase && !file.stampError && !file.cachedJson) {
+                buffer.Clear();
+                auto writer = RAPIDJSON_NAMESPACE::Writer<RAPIDJSON_NAMESPACE::StringBuffer>(buffer);
+                fileValue.Accept(writer);
+                stateDatabase->store(operationHash, file.path, file.stamp, std::string_view(buffer.GetString(), buffer.GetSize()));
+            }
+            buffer.Clear();
+            if (pretty) {
+                // indent the object as it is an element of the array
+                auto writer = RAPIDJSON_NAMESPACE::PrettyWriter<RAPIDJSON_NAMESPACE::StringBuffer>(buffer);
+                fileValue.Accept(writer);
+                file.json.reserve(buffer.GetSize() * 5 / 4);
+                file.json += "    ";
+                for (const auto c : std::string_view(buffer.GetString(), buffer.GetSize())) {
+                    file.json += c;
+                    if (c == '\n') {
+                        file.json += "    ";
+                    }
+                }
+            } else {
+                auto writer = RAPIDJSON_NAMESPACE::Writer<RAPIDJSON_NAMESPACE::StringBuffer>(buffer);
+                fileValue.Accept(writer);
+                file.json.assign(buffer.GetString(), buffer.GetSize());
+            }
+        }
+        worker.allocator.Clear();
+    };
+
+    // prints the JSON object of the file in the specified slot as soon as it is the next one in order
+    auto emittedFiles = std::size_t();
+    const auto emitFile = [&](std::size_t slot) {
+        auto &file = files[slot];
+        const auto progressLock = batchProgress ? batchProgress->clearLine() : std::unique_lock<std::mutex>();
+        if (file.exitCode != EXIT_SUCCESS) {
+            cerr << Phrases::Error << file.error << Phrases::EndFlush;
+            printDiagMessages(file.diag, "Diagnostic messages:", false);
+            exitCode = file.exitCode;
+        } else if (lineDelimited) {
+            cout << file.json << '\n' << flush;
+        } else {
+            cout << (emittedFiles++ ? "," : "") << (pretty ? "\n" : "") << file.json << flush;
+        }
+        if (timings) {
+            timings->add(file.timings);
+        }
+    };
+
+    // process files, printing the array of all files unless printing one object per line
+    if (!lineDelimited) {
+        cout << '[';
+    }
+    const auto handler = InterruptHandler([&batch] { batch.abort(); });
+    batch.run(
+        prepareFile,
+        [&](std::size_t workerIndex, std::size_t slot) {
+            processFile(workerIndex, slot);
+            files[slot].timings.stop();
+            if (batchProgress) {
+                batchProgress->finishFile(workerIndex);
+            }
+        },
+        emitFile);
+    if (!lineDelimited) {
+        cout << (pretty && emittedFiles ? "\n]" : "]") << endl;
+    }
+    if (batchProgress) {
+        batchProgress->finish();
+    }
+    if (stateDatabase) {
+        saveStateDatabase(*stateDatabase, incrementalArg);
+    }
+    if (timings) {
+        timings->printSummary();
     }
-    cout << endl;
 
 #else
-    CPP_UTILITIES_UNUSED(filesArg);
+    CPP_UTILITIES_UNUSED(fileListArgs);
     CPP_UTILITIES_UNUSED(prettyArg);
+    CPP_UTILITIES_UNUSED(ndjsonArg);
+    CPP_UTILITIES_UNUSED(blobsArg);
+    CPP_UTILITIES_UNUSED(jobsArg);
+    CPP_UTILITIES_UNUSED(timingsArg);
+    CPP_UTILITIES_UNUSED(progressArg);
+    CPP_UTILITIES_UNUSED(incrementalArg);
+    CPP_UTILITIES_UNUSED(mmapArg);
     cerr << Phrases::Error << "JSON export has not been enabled when building the tag editor." << Phrases::EndFlush;
     exitCode = EXIT_FAILURE;
 #endif
 }
 
+void serve(ArgumentParser &parser, const Argument &socketArg, const Argument &jobsArg)
+{
+    CMD_UTILS_START_CONSOLE;
+
+    const auto *const socketPath = socketArg.firstValue();
+    if (!socketPath || !*socketPath) {
+        std::cerr << Phrases::Error << "No socket has been specified." << Phrases::EndFlush;
+        std::exit(EXIT_FAILURE);
+    }
+    const auto jobs = parseJobCount(jobsArg, 0);
+    try {
+        std::cout << "Serving requests via \"" << socketPath << "\" (processing up to " << jobs << " requests in parallel) ..." << endl;
+        serveRequests(parser, socketPath, jobs);
+    } catch (const std::exception &e) {
+        std::cerr << Phrases::Error << "Unable to serve requests via \"" << socketPath << "\": " << e.what() << Phrases::EndFlush;
+        exitCode = EXIT_FAILURE;
+    }
+}
+
+/*!
+ * \brief Enables or disables keeping state between operations invoked within the same process.
+ * \remarks
+ * - This is used by processes serving requests so they don't need to redo work for each request. The kept state consists of cached
+ *   files (e.g. covers), the plan computed for the specified fields, the opened state database and the loaded JavaScript.
+ * - Disabling releases the kept state.
+ */
+void keepStateBetweenOperations(bool keep)
+{
+#ifdef TAGEDITOR_USE_JSENGINE
+    keptJavaScriptProcessor.reset();
+    keptJavaScriptKey.clear();
+#endif
+    keptState = keep ? std::make_unique<KeptState>() : std::unique_ptr<KeptState>();
+}
+
 void applyGeneralConfig(const Argument &timeSapnFormatArg)
 {
     timeSpanOutputFormat = parseTimeSpanOutputFormat(timeSapnFormatArg, TimeSpanOutputFormat::WithMeasures);
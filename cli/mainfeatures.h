@@ -12,11 +12,27 @@ class Argument;
 
 namespace Cli {
 
+struct FileListArgs {
+    FileListArgs(CppUtilities::Argument &filesArg);
+    CppUtilities::Argument &filesArg;
+    CppUtilities::ConfigValueArgument nullArg;
+    CppUtilities::ConfigValueArgument filesFromArg;
+    CppUtilities::ConfigValueArgument extensionsArg;
+    CppUtilities::ConfigValueArgument sortByInodeArg;
+    CppUtilities::ConfigValueArgument recursiveArg;
+    CppUtilities::ConfigValueArgument prefetchArg;
+};
+
 struct SetTagInfoArgs {
-    SetTagInfoArgs(CppUtilities::Argument &filesArg, CppUtilities::Argument &verboseArg, CppUtilities::Argument &pedanticArg);
+    SetTagInfoArgs(FileListArgs &fileListArgs, CppUtilities::Argument &verboseArg, CppUtilities::Argument &pedanticArg,
+        CppUtilities::Argument &timingsArg, CppUtilities::Argument &progressArg, CppUtilities::Argument &incrementalArg);
+    FileListArgs &fileListArgs;
     CppUtilities::Argument &filesArg;
     CppUtilities::Argument &verboseArg;
     CppUtilities::Argument &pedanticArg;
+    CppUtilities::Argument &timingsArg;
+    CppUtilities::Argument &progressArg;
+    CppUtilities::Argument &incrementalArg;
     CppUtilities::ConfigValueArgument quietArg;
     CppUtilities::ConfigValueArgument docTitleArg;
     CppUtilities::ConfigValueArgument removeOtherFieldsArg;
@@ -36,6 +52,7 @@ struct SetTagInfoArgs {
     CppUtilities::ConfigValueArgument minPaddingArg;
     CppUtilities::ConfigValueArgument maxPaddingArg;
     CppUtilities::ConfigValueArgument prefPaddingArg;
+    CppUtilities::ConfigValueArgument paddingArg;
     CppUtilities::ConfigValueArgument tagPosValueArg;
     CppUtilities::ConfigValueArgument forceTagPosArg;
     CppUtilities::ConfigValueArgument tagPosArg;
@@ -54,24 +71,43 @@ struct SetTagInfoArgs {
     CppUtilities::ConfigValueArgument jsArg;
     CppUtilities::ConfigValueArgument jsSettingsArg;
     CppUtilities::ConfigValueArgument coverTypeDelimiterArg;
+    CppUtilities::ConfigValueArgument jobsArg;
+    CppUtilities::ConfigValueArgument manifestArg;
+    CppUtilities::ConfigValueArgument fromJsonArg;
+    CppUtilities::ConfigValueArgument skipUnchangedArg;
+    CppUtilities::ConfigValueArgument planArg;
+    CppUtilities::ConfigValueArgument journalArg;
     CppUtilities::OperationArgument setTagInfoArg;
 };
 
 extern const char *const fieldNames;
 extern const char *const fieldNamesForSet;
 extern int exitCode;
+void keepStateBetweenOperations(bool keep);
 void applyGeneralConfig(const CppUtilities::Argument &timeSapnFormatArg);
 void printFieldNames(const CppUtilities::ArgumentOccurrence &occurrence);
-void displayFileInfo(const CppUtilities::ArgumentOccurrence &, const CppUtilities::Argument &filesArg, const CppUtilities::Argument &verboseArg,
-    const CppUtilities::Argument &pedanticArg, const CppUtilities::Argument &validateArg);
+void displayFileInfo(const CppUtilities::ArgumentOccurrence &, const FileListArgs &fileListArgs, const CppUtilities::Argument &verboseArg,
+    const CppUtilities::Argument &pedanticArg, const CppUtilities::Argument &validateArg, const CppUtilities::Argument &paddingStatsArg,
+    const CppUtilities::Argument &timingsArg, const CppUtilities::Argument &progressArg, const CppUtilities::Argument &mmapArg);
 void generateFileInfo(const CppUtilities::ArgumentOccurrence &, const CppUtilities::Argument &inputFileArg,
     const CppUtilities::Argument &outputFileArg, const CppUtilities::Argument &validateArg);
-void displayTagInfo(const CppUtilities::Argument &fieldsArg, const CppUtilities::Argument &showUnsupportedArg, const CppUtilities::Argument &filesArg,
-    const CppUtilities::Argument &verboseArg, const CppUtilities::Argument &pedanticArg);
+void verifyFiles(const CppUtilities::ArgumentOccurrence &, const FileListArgs &fileListArgs, const CppUtilities::Argument &jobsArg,
+    const CppUtilities::Argument &readAheadArg, const CppUtilities::Argument &verboseArg, const CppUtilities::Argument &timingsArg,
+    const CppUtilities::Argument &progressArg, const CppUtilities::Argument &mmapArg);
+void displayTagInfo(const CppUtilities::Argument &fieldsArg, const CppUtilities::Argument &showUnsupportedArg,
+    const CppUtilities::Argument &formatArg, const CppUtilities::Argument &perTagArg, const FileListArgs &fileListArgs,
+    const CppUtilities::Argument &verboseArg, const CppUtilities::Argument &pedanticArg, const CppUtilities::Argument &timingsArg,
+    const CppUtilities::Argument &progressArg, const CppUtilities::Argument &incrementalArg, const CppUtilities::Argument &mmapArg);
 void setTagInfo(const Cli::SetTagInfoArgs &args);
 void extractField(const CppUtilities::Argument &fieldArg, const CppUtilities::Argument &attachmentArg, const CppUtilities::Argument &inputFilesArg,
-    const CppUtilities::Argument &outputFileArg, const CppUtilities::Argument &indexArg, const CppUtilities::Argument &verboseArg);
-void exportToJson(const CppUtilities::ArgumentOccurrence &, const CppUtilities::Argument &filesArg, const CppUtilities::Argument &prettyArg);
+    const CppUtilities::Argument &outputFileArg, const CppUtilities::Argument &outputDirArg, const CppUtilities::Argument &dedupArg,
+    const CppUtilities::Argument &indexArg, const CppUtilities::Argument &verboseArg, const CppUtilities::Argument &timingsArg,
+    const CppUtilities::Argument &progressArg, const CppUtilities::Argument &mmapArg);
+void exportToJson(const CppUtilities::ArgumentOccurrence &, const FileListArgs &fileListArgs, const CppUtilities::Argument &prettyArg,
+    const CppUtilities::Argument &ndjsonArg, const CppUtilities::Argument &blobsArg, const CppUtilities::Argument &jobsArg,
+    const CppUtilities::Argument &timingsArg, const CppUtilities::Argument &progressArg, const CppUtilities::Argument &incrementalArg,
+    const CppUtilities::Argument &mmapArg);
+void serve(CppUtilities::ArgumentParser &parser, const CppUtilities::Argument &socketArg, const CppUtilities::Argument &jobsArg);
 
 } // namespace Cli
 
@@ -0,0 +1,764 @@
+#include "./manifest.h"
+
+#include <tagparser/id3/id3v1tag.h>
+#include <tagparser/id3/id3v2tag.h>
+#include <tagparser/matroska/matroskatag.h>
+#include <tagparser/mp4/mp4tag.h>
+#include <tagparser/vorbis/vorbiscomment.h>
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
+
+#ifdef TAGEDITOR_JSON_EXPORT
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+#endif
+
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace TagParser;
+
+namespace Cli {
+
+/// \brief The index used for the column containing the path of the file to be modified.
+static constexpr auto fileColumn = std::numeric_limits<std::size_t>::max();
+/// \brief The index used for the column containing the path of the output file.
+static constexpr auto outputColumn = std::numeric_limits<std::size_t>::max() - 1;
+/// \brief The size of the chunks the JSON export format is read in.
+static constexpr auto jsonExportChunkSize = std::size_t(64 * 1024);
+
+/// \cond
+static ManifestReader::Format formatFromExtension(std::string_view path)
+{
+    if (endsWith(path, ".ndjson") || endsWith(path, ".jsonl")) {
+        return ManifestReader::Format::NdJson;
+    } else if (!endsWith(path, ".tsv")) {
+        throw std::runtime_error("unable to determine format; the file extension must be .tsv, .ndjson or .jsonl");
+    }
+    return ManifestReader::Format::Tsv;
+}
+
+static std::string unescapeTsvValue(std::string_view value)
+{
+    auto unescaped = std::string();
+    unescaped.reserve(value.size());
+    for (auto i = value.begin(), end = value.end(); i != end; ++i) {
+        if (*i != '\\' || i + 1 == end) {
+            unescaped += *i;
+            continue;
+        }
+        switch (*++i) {
+        case '\\':
+            unescaped += '\\';
+            break;
+        case 't':
+            unescaped += '\t';
+            break;
+        case 'n':
+            unescaped += '\n';
+            break;
+        case 'r':
+            unescaped += '\r';
+            break;
+        default:
+            // preserve unknown escape sequences as-is
+            unescaped += '\\';
+            unescaped += *i;
+        }
+    }
+    return unescaped;
+}
+/// \endcond
+
+/*!
+ * \class ManifestReader
+ * \brief The ManifestReader class reads the files and values to be set via the "set"-operation from a manifest file.
+ *
+ * The manifest is read line by line so memory usage does not depend on the number of files. Two formats are supported:
+ * - TSV (*.tsv): The first line contains the column names. All other lines contain the values separated by tabs. An empty
+ *   value means the field is not altered. Backslashes, tabs and line breaks within values are escaped via a backslash (as
+ *   in the TSV output of other operations, e.g. "\\t"). Line breaks might be CR-LF.
+ * - NDJSON (*.ndjson, *.jsonl): Each line contains a JSON object which maps column names to values. A value might be a
+ *   string, a number, a boolean, an array of these (to specify multiple values) or null (to not alter the field). An empty
+ *   string means the field is removed.
+ *
+ * The column "file" contains the path of the file to be modified and the optional column "output" the path of the file to
+ * save changes to. All other column names are field denotations using the same syntax as the "set"-operation without the
+ * "=value"-part, e.g. "title", "cover" or "target-level=30 title". Specifying the same column multiple times allows setting
+ * multiple values.
+ *
+ * Additionally, the output of the "export"-operation can be read (Format::JsonExport, used by "--from-json"). It is either
+ * an array of objects following the Cli::Json::FileInfo schema or one such object per line. The input is read in chunks
+ * and split into records; each record is then parsed via a SAX reader so only a single record is held in memory at a time.
+ * The file is located via "path" (the path the file has been opened with when exporting it) or via "fileName" (relative to the
+ * current working directory) if "path" is not present (e.g. in exports of older versions). The values of each
+ * tag are applied to tags of the same format and target. Pictures and binary values can not be imported; fields containing
+ * them are not altered.
+ */
+
+/*!
+ * \brief Opens the manifest file with the specified \a path and reads the header in case of TSV.
+ * \remarks The format is determined by the file extension.
+ * \throws Throws std::ios_base::failure when an IO error occurs, DenotationError if a column name is invalid and
+ *         std::runtime_error on other errors.
+ */
+ManifestReader::ManifestReader(std::string_view path)
+    : ManifestReader(path, formatFromExtension(path))
+{
+}
+
+/*!
+ * \brief Opens the manifest file with the specified \a path and \a format and reads the header in case of TSV.
+ * \remarks The JSON export format is read from std::cin if \a path is "-".
+ * \throws Throws the same exceptions as the constructor determining the format by the file extension.
+ */
+ManifestReader::ManifestReader(std::string_view path, Format format)
+    : m_path(path)
+    , m_format(format)
+    , m_input(&m_file)
+    , m_lineNumber(0)
+    , m_inputLineNumber(1)
+    , m_bufferOffset(0)
+    , m_bufferSize(0)
+{
+#ifndef TAGEDITOR_JSON_EXPORT
+    if (m_format != Format::Tsv) {
+        throw std::runtime_error("support for JSON has been disabled at compile-time");
+    }
+#endif
+    if (m_format == Format::JsonExport) {
+        m_buffer.resize(jsonExportChunkSize);
+        if (m_path == "-") {
+            m_input = &std::cin;
+            return;
+        }
+    }
+
+    m_file.exceptions(ios_base::failbit | ios_base::badbit);
+    m_file.open(m_path, ios_base::in | ios_base::binary);
+    m_file.exceptions(ios_base::badbit);
+    if (m_format != Format::Tsv) {
+        return;
+    }
+
+    // read header
+    if (!readLine()) {
+        throw std::runtime_error("the header is missing");
+    }
+    auto hasFileColumn = false;
+    for (const auto escapedName : splitStringSimple<std::vector<std::string_view>>(m_line, "\t")) {
+        const auto name = unescapeTsvValue(escapedName);
+        if (name == "file") {
+            m_tsvColumns.emplace_back(fileColumn);
+            hasFileColumn = true;
+        } else if (name == "output") {
+            m_tsvColumns.emplace_back(outputColumn);
+        } else {
+            m_tsvColumns.emplace_back(columnIndex(name));
+        }
+    }
+    if (!hasFileColumn) {
+        throw std::runtime_error("the header does not contain the column \"file\"");
+    }
+}
+
+/*!
+ * \brief Reads the next entry into \a entry.
+ * \returns Returns whether an entry could be read; returns false if the end of the file has been reached.
+ * \throws Throws the same exceptions as the constructor.
+ */
+bool ManifestReader::read(ManifestEntry &entry)
+{
+    entry.path.clear();
+    entry.outputPath.clear();
+    entry.fields.clear();
+    if (m_format == Format::JsonExport) {
+        if (!readJsonExportRecord(entry)) {
+            return false;
+        }
+    } else {
+        do {
+            if (!readLine()) {
+                return false;
+            }
+        } while (m_line.empty());
+        if (m_format == Format::Tsv) {
+            readTsvLine(entry);
+        } else {
+            readJsonLine(entry);
+        }
+    }
+    if (entry.path.empty()) {
+        throw std::runtime_error(argsToString("no file has been specified in line ", m_lineNumber));
+    }
+
+    // all values apply to the file of this entry; incrementing values makes no sense within a single entry
+    for (auto &[scope, values] : entry.fields) {
+        for (auto &value : values.allValues) {
+            value.fileIndex = 0;
+            if (value.type == DenotationType::Increment) {
+                value.type = DenotationType::Normal;
+            }
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Reads the next line into m_line removing a trailing carriage return.
+ */
+bool ManifestReader::readLine()
+{
+    if (!std::getline(*m_input, m_line)) {
+        return false;
+    }
+    if (!m_line.empty() && m_line.back() == '\r') {
+        m_line.pop_back();
+    }
+    ++m_lineNumber;
+    return true;
+}
+
+/*!
+ * \brief Reads the values of the current TSV line into \a entry unescaping them.
+ */
+void ManifestReader::readTsvLine(ManifestEntry &entry)
+{
+    const auto values = splitStringSimple<std::vector<std::string_view>>(m_line, "\t");
+    if (values.size() > m_tsvColumns.size()) {
+        throw std::runtime_error(argsToString("line ", m_lineNumber, " has more values than there are columns"));
+    }
+    for (auto i = std::size_t(); i != values.size(); ++i) {
+        const auto value = unescapeTsvValue(values[i]);
+        switch (const auto columnIndex = m_tsvColumns[i]) {
+        case fileColumn:
+            entry.path = value;
+            break;
+        case outputColumn:
+            entry.outputPath = value;
+            break;
+        default:
+            if (!value.empty()) {
+                addValue(entry, m_columns[columnIndex], value);
+            }
+        }
+    }
+}
+
+#ifdef TAGEDITOR_JSON_EXPORT
+void ManifestReader::readJsonLine(ManifestEntry &entry)
+{
+    auto doc = RAPIDJSON_NAMESPACE::Document();
+    doc.Parse(m_line.data(), m_line.size());
+    if (doc.HasParseError()) {
+        throw std::runtime_error(argsToString("unable to parse line ", m_lineNumber, ": ", RAPIDJSON_NAMESPACE::GetParseError_En(doc.GetParseError()),
+            " (at offset ", doc.GetErrorOffset(), ')'));
+    }
+    if (!doc.IsObject()) {
+        throw std::runtime_error(argsToString("line ", m_lineNumber, " does not contain a JSON object"));
+    }
+    for (const auto &member : doc.GetObject()) {
+        const auto name = std::string_view(member.name.GetString(), member.name.GetStringLength());
+        const auto isPath = name == "file" || name == "output";
+        const auto addJsonValue = [&](const RAPIDJSON_NAMESPACE::Value &value) {
+            auto stringValue = std::string();
+            if (value.IsString()) {
+                stringValue.assign(value.GetString(), value.GetStringLength());
+            } else if (value.IsInt64()) {
+                stringValue = numberToString(value.GetInt64());
+            } else if (value.IsUint64()) {
+                stringValue = numberToString(value.GetUint64());
+            } else if (value.IsNumber()) {
+                auto stream = std::ostringstream();
+                stream << value.GetDouble();
+                stringValue = stream.str();
+            } else if (value.IsBool()) {
+                stringValue = value.GetBool() ? "true" : "false";
+            } else {
+                throw std::runtime_error(argsToString("the value for \"", name, "\" in line ", m_lineNumber, " has an invalid type"));
+            }
+            if (name == "file") {
+                entry.path = std::move(stringValue);
+            } else if (name == "output") {
+                entry.outputPath = std::move(stringValue);
+            } else {
+                addValue(entry, m_columns[columnIndex(name)], stringValue);
+            }
+        };
+        if (member.value.IsNull()) {
+            continue;
+        } else if (member.value.IsArray() && !isPath) {
+            for (const auto &value : member.value.GetArray()) {
+                addJsonValue(value);
+            }
+        } else {
+            addJsonValue(member.value);
+        }
+    }
+}
+
+/// \cond
+static TagType tagTypeFromName(std::string_view name)
+{
+    if (name == Id3v1Tag::tagName) {
+        return TagType::Id3v1Tag;
+    } else if (name == Id3v2Tag::tagName) {
+        return TagType::Id3v2Tag;
+    } else if (name == Mp4Tag::tagName) {
+        return TagType::Mp4Tag;
+    } else if (name == MatroskaTag::tagName) {
+        return TagType::MatroskaTag;
+    } else if (name == VorbisComment::tagName) {
+        return TagType::VorbisComment | TagType::OggVorbisComment;
+    }
+    return TagType::Unspecified;
+}
+
+/*!
+ * \brief The JsonExportHandler struct assigns the values of a record of the JSON export to a ManifestEntry via SAX events.
+ */
+struct JsonExportHandler : public RAPIDJSON_NAMESPACE::BaseReaderHandler<RAPIDJSON_NAMESPACE::UTF8<>, JsonExportHandler> {
+    enum class Context { File, Tags, Tag, Target, TargetIds, Fields, Values, Value, Position, Ignored };
+    struct Field {
+        FieldId id;
+        std::vector<std::string> values;
+        bool skipped = false;
+    };
+
+    explicit JsonExportHandler(ManifestEntry &entry, std::size_t lineNumber);
+    bool StartObject();
+    bool EndObject(RAPIDJSON_NAMESPACE::SizeType);
+    bool StartArray();
+    bool EndArray(RAPIDJSON_NAMESPACE::SizeType);
+    bool Key(const char *str, RAPIDJSON_NAMESPACE::SizeType length, bool);
+    bool String(const char *str, RAPIDJSON_NAMESPACE::SizeType length, bool);
+    bool Int(int value);
+    bool Uint(unsigned int value);
+    bool Int64(std::int64_t value);
+    bool Uint64(std::uint64_t value);
+    bool Double(double value);
+    bool Bool(bool value);
+    bool Null();
+
+private:
+    bool setValue(std::string_view value);
+    void addTagFields();
+
+    ManifestEntry &m_entry;
+    std::size_t m_lineNumber;
+    std::vector<Context> m_contexts;
+    std::string m_key;
+    bool m_hasExplicitPath;
+    TagType m_tagType;
+    TagTarget m_tagTarget;
+    TagTarget::IdContainerType *m_ids;
+    std::vector<Field> m_fields;
+    std::string m_kind;
+    std::string m_value;
+    bool m_hasValue;
+    std::uint64_t m_position;
+    std::uint64_t m_total;
+};
+
+JsonExportHandler::JsonExportHandler(ManifestEntry &entry, std::size_t lineNumber)
+    : m_entry(entry)
+    , m_lineNumber(lineNumber)
+    , m_hasExplicitPath(false)
+    , m_tagType(TagType::Unspecified)
+    , m_ids(nullptr)
+    , m_hasValue(false)
+    , m_position(0)
+    , m_total(0)
+{
+}
+
+bool JsonExportHandler::StartObject()
+{
+    auto context = Context::Ignored;
+    if (m_contexts.empty()) {
+        context = Context::File;
+    } else {
+        switch (m_contexts.back()) {
+        case Context::Tags:
+            context = Context::Tag;
+            m_tagType = TagType::Unspecified;
+            m_tagTarget.clear();
+            m_fields.clear();
+            break;
+        case Context::Tag:
+            context = m_key == "target" ? Context::Target : m_key == "fields" ? Context::Fields : Context::Ignored;
+            break;
+        case Context::Values:
+            context = Context::Value;
+            m_kind.clear();
+            m_value.clear();
+            m_hasValue = false;
+            break;
+        case Context::Value:
+            if (m_key == "value") {
+                context = Context::Position;
+                m_position = m_total = 0;
+            }
+            break;
+        default:;
+        }
+    }
+    m_contexts.emplace_back(context);
+    return true;
+}
+
+bool JsonExportHandler::EndObject(RAPIDJSON_NAMESPACE::SizeType)
+{
+    const auto context = m_contexts.back();
+    m_contexts.pop_back();
+    switch (context) {
+    case Context::Tag:
+        addTagFields();
+        break;
+    case Context::Value:
+        // pictures and binary values are only exported as Base64 or digest; keep the field as-is rather than losing them
+        if (m_kind == "picture" || m_kind == "binary" || m_kind == "error") {
+            m_fields.back().skipped = true;
+        } else if (m_hasValue) {
+            m_fields.back().values.emplace_back(std::move(m_value));
+        }
+        break;
+    case Context::Position:
+        m_value = m_total ? argsToString(m_position, '/', m_total) : numberToString(m_position);
+        m_hasValue = true;
+        break;
+    default:;
+    }
+    return true;
+}
+
+bool JsonExportHandler::StartArray()
+{
+    auto context = Context::Ignored;
+    switch (m_contexts.empty() ? Context::Ignored : m_contexts.back()) {
+    case Context::File:
+        if (m_key == "tags") {
+            context = Context::Tags;
+        }
+        break;
+    case Context::Target:
+        m_ids = m_key == "tracks" ? &m_tagTarget.tracks()
+            : m_key == "chapters"  ? &m_tagTarget.chapters()
+            : m_key == "editions"  ? &m_tagTarget.editions()
+            : m_key == "attachments" ? &m_tagTarget.attachments()
+                                     : nullptr;
+        if (m_ids) {
+            context = Context::TargetIds;
+        }
+        break;
+    case Context::Fields:
+        try {
+            m_fields.emplace_back(Field{ FieldId::fromTagDenotation(m_key), {}, false });
+        } catch (const ConversionException &) {
+            throw std::runtime_error(argsToString("the field \"", m_key, "\" of the record in line ", m_lineNumber, " is unknown"));
+        }
+        context = Context::Values;
+        break;
+    default:;
+    }
+    m_contexts.emplace_back(context);
+    return true;
+}
+
+bool JsonExportHandler::EndArray(RAPIDJSON_NAMESPACE::SizeType)
+{
+    m_contexts.pop_back();
+    return true;
+}
+
+bool JsonExportHandler::Key(const char *str, RAPIDJSON_NAMESPACE::SizeType length, bool)
+{
+    m_key.assign(str, length);
+    return true;
+}
+
+bool JsonExportHandler::String(const char *str, RAPIDJSON_NAMESPACE::SizeType length, bool)
+{
+    const auto value = std::string_view(str, length);
+    switch (m_contexts.back()) {
+    case Context::File:
+        if (m_key == "path") {
+            m_entry.path = value;
+            m_hasExplicitPath = true;
+        } else if (m_key == "fileName" && !m_hasExplicitPath) {
+            m_entry.path = value;
+        }
+        break;
+    case Context::Tag:
+        if (m_key == "format") {
+            m_tagType = tagTypeFromName(value);
+        }
+        break;
+    case Context::Target:
+        if (m_key == "levelName") {
+            m_tagTarget.setLevelName(std::string(value));
+        }
+        break;
+    case Context::Value:
+        if (m_key == "kind") {
+            m_kind = value;
+        } else {
+            setValue(value);
+        }
+        break;
+    default:;
+    }
+    return true;
+}
+
+bool JsonExportHandler::Int(int value)
+{
+    return Int64(value);
+}
+
+bool JsonExportHandler::Uint(unsigned int value)
+{
+    return Uint64(value);
+}
+
+bool JsonExportHandler::Int64(std::int64_t value)
+{
+    return value >= 0 ? Uint64(static_cast<std::uint64_t>(value)) : setValue(numberToString(value));
+}
+
+bool JsonExportHandler::Uint64(std::uint64_t value)
+{
+    switch (m_contexts.back()) {
+    case Context::Target:
+        if (m_key == "level") {
+            m_tagTarget.setLevel(value);
+        }
+        break;
+    case Context::TargetIds:
+        m_ids->emplace_back(value);
+        break;
+    case Context::Position:
+        if (m_key == "position") {
+            m_position = value;
+        } else if (m_key == "total") {
+            m_total = value;
+        }
+        break;
+    default:
+        setValue(numberToString(value));
+    }
+    return true;
+}
+
+bool JsonExportHandler::Double(double value)
+{
+    auto stream = std::ostringstream();
+    stream << value;
+    return setValue(stream.str());
+}
+
+bool JsonExportHandler::Bool(bool value)
+{
+    return setValue(value ? "true" : "false");
+}
+
+bool JsonExportHandler::Null()
+{
+    return true;
+}
+
+/*!
+ * \brief Assigns the specified \a value if it is the value of a tag value object.
+ */
+bool JsonExportHandler::setValue(std::string_view value)
+{
+    if (m_contexts.back() == Context::Value && m_key == "value") {
+        m_value = value;
+        m_hasValue = true;
+    }
+    return true;
+}
+
+/*!
+ * \brief Adds the fields of the current tag to the entry scoping them to the format and target of the tag.
+ */
+void JsonExportHandler::addTagFields()
+{
+    for (auto &field : m_fields) {
+        if (field.skipped || field.values.empty()) {
+            continue;
+        }
+        auto scope = FieldScope(KnownField::Invalid, m_tagType, m_tagTarget);
+        scope.field = std::move(field.id);
+        auto &values = m_entry.fields[std::move(scope)].allValues;
+        for (auto &value : field.values) {
+            values.emplace_back(DenotationType::Normal, 0, value);
+        }
+    }
+}
+/// \endcond
+
+/*!
+ * \brief Reads the next record of the JSON export into \a entry.
+ * \returns Returns whether a record could be read; returns false if the end of the input has been reached.
+ * \remarks The input is only split into records here (which just requires tracking the nesting level and strings); the record is
+ *          then parsed via a SAX reader so no DOM is built.
+ */
+bool ManifestReader::readJsonExportRecord(ManifestEntry &entry)
+{
+    auto depth = std::size_t();
+    auto inString = false, escaped = false;
+    m_line.clear();
+    for (;;) {
+        if (m_bufferOffset == m_bufferSize) {
+            m_input->read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_bufferOffset = 0;
+            m_bufferSize = static_cast<std::size_t>(m_input->gcount());
+            if (!m_bufferSize) {
+                if (depth) {
+                    throw std::runtime_error(argsToString("the record in line ", m_lineNumber, " is incomplete"));
+                }
+                return false;
+            }
+        }
+        auto recordStart = depth ? m_bufferOffset : std::string::npos;
+        for (; m_bufferOffset != m_bufferSize; ++m_bufferOffset) {
+            const auto c = m_buffer[m_bufferOffset];
+            if (c == '\n') {
+                ++m_inputLineNumber;
+            }
+            if (!depth) {
+                // skip the array the records are contained in and separators between records
+                switch (c) {
+                case '{':
+                    m_lineNumber = m_inputLineNumber;
+                    depth = 1;
+                    recordStart = m_bufferOffset;
+                    continue;
+                case '[':
+                case ']':
+                case ',':
+                case ' ':
+                case '\t':
+                case '\r':
+                case '\n':
+                    continue;
+                default:
+                    throw std::runtime_error(argsToString("line ", m_inputLineNumber, " contains \"", c, "\" where a JSON object is expected"));
+                }
+            }
+            if (inString) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    inString = false;
+                }
+                continue;
+            }
+            switch (c) {
+            case '"':
+                inString = true;
+                break;
+            case '{':
+            case '[':
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                --depth;
+                break;
+            default:;
+            }
+            if (!depth) {
+                break;
+            }
+        }
+        if (m_bufferOffset == m_bufferSize) {
+            if (recordStart != std::string::npos) {
+                m_line.append(m_buffer, recordStart, m_bufferSize - recordStart);
+            }
+            continue;
+        }
+        m_line.append(m_buffer, recordStart, ++m_bufferOffset - recordStart);
+        break;
+    }
+
+    auto reader = RAPIDJSON_NAMESPACE::Reader();
+    auto stream = RAPIDJSON_NAMESPACE::StringStream(m_line.data());
+    auto handler = JsonExportHandler(entry, m_lineNumber);
+    if (!reader.Parse(stream, handler)) {
+        throw std::runtime_error(argsToString("unable to parse the record in line ", m_lineNumber, ": ",
+            RAPIDJSON_NAMESPACE::GetParseError_En(reader.GetParseErrorCode()), " (at offset ", reader.GetErrorOffset(), ')'));
+    }
+    return true;
+}
+#else
+void ManifestReader::readJsonLine(ManifestEntry &)
+{
+}
+
+bool ManifestReader::readJsonExportRecord(ManifestEntry &)
+{
+    return false;
+}
+#endif
+
+/*!
+ * \brief Adds the specified \a value for the specified \a column to \a entry.
+ */
+void ManifestReader::addValue(ManifestEntry &entry, const Column &column, std::string_view value)
+{
+    m_denotation.clear();
+    for (auto i = column.denotation.cbegin(), last = column.denotation.cend() - 1; i != last; ++i) {
+        m_denotation.emplace_back(*i);
+    }
+    m_value.assign(column.denotation.back());
+    m_value += '=';
+    m_value += value;
+    m_denotation.emplace_back(m_value);
+    parseFieldDenotations(m_denotation, false, entry.fields);
+}
+
+/*!
+ * \brief Returns the index of the column with the specified \a name, parsing its denotation if not done yet.
+ */
+std::size_t ManifestReader::columnIndex(std::string_view name)
+{
+    for (auto i = std::size_t(); i != m_columns.size(); ++i) {
+        if (m_columns[i].name == name) {
+            return i;
+        }
+    }
+    auto &column = m_columns.emplace_back();
+    column.name = name;
+    for (const auto part : splitStringSimple<std::vector<std::string_view>>(name, " ")) {
+        if (!part.empty()) {
+            column.denotation.emplace_back(part);
+        }
+    }
+    if (column.denotation.empty()) {
+        m_columns.pop_back();
+        throw std::runtime_error(argsToString("the column name in line ", m_lineNumber, " is empty"));
+    }
+    // validate the denotation right away
+    auto fields = FieldDenotations();
+    m_denotation.assign(column.denotation.cbegin(), column.denotation.cend());
+    m_denotation.back() = m_value.assign(column.denotation.back()).append("=");
+    try {
+        parseFieldDenotations(m_denotation, false, fields);
+    } catch (...) {
+        m_columns.pop_back();
+        throw;
+    }
+    return m_columns.size() - 1;
+}
+
+} // namespace Cli
@@ -0,0 +1,88 @@
+#ifndef CLI_MANIFEST
+#define CLI_MANIFEST
+
+#include "./helper.h"
+
+#include <c++utilities/io/nativefilestream.h>
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Cli {
+
+struct ManifestEntry {
+    std::string path;
+    std::string outputPath;
+    FieldDenotations fields;
+};
+
+class ManifestReader {
+public:
+    enum class Format { Tsv, NdJson, JsonExport };
+
+    explicit ManifestReader(std::string_view path);
+    explicit ManifestReader(std::string_view path, Format format);
+    bool read(ManifestEntry &entry);
+    Format format() const;
+    const std::string &line() const;
+    std::size_t lineNumber() const;
+
+private:
+    struct Column {
+        std::string name;
+        std::vector<std::string> denotation;
+    };
+
+    bool readLine();
+    void readTsvLine(ManifestEntry &entry);
+    void readJsonLine(ManifestEntry &entry);
+    bool readJsonExportRecord(ManifestEntry &entry);
+    void addValue(ManifestEntry &entry, const Column &column, std::string_view value);
+    std::size_t columnIndex(std::string_view name);
+
+    std::string m_path;
+    Format m_format;
+    CppUtilities::NativeFileStream m_file;
+    std::istream *m_input;
+    std::string m_line;
+    std::size_t m_lineNumber;
+    std::size_t m_inputLineNumber;
+    std::string m_buffer;
+    std::size_t m_bufferOffset;
+    std::size_t m_bufferSize;
+    std::vector<std::size_t> m_tsvColumns;
+    std::vector<Column> m_columns;
+    std::vector<std::string_view> m_denotation;
+    std::string m_value;
+};
+
+/*!
+ * \brief Returns the format of the manifest (determined by the file extension unless specified explicitly).
+ */
+inline ManifestReader::Format ManifestReader::format() const
+{
+    return m_format;
+}
+
+/*!
+ * \brief Returns the line (or the record in case of the JSON export format) read last as-is.
+ */
+inline const std::string &ManifestReader::line() const
+{
+    return m_line;
+}
+
+/*!
+ * \brief Returns the number of the line read last (or the line the record read last starts at).
+ */
+inline std::size_t ManifestReader::lineNumber() const
+{
+    return m_lineNumber;
+}
+
+} // namespace Cli
+
+#endif // CLI_MANIFEST
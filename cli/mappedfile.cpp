@@ -0,0 +1,167 @@
+#include "./mappedfile.h"
+
+#include <tagparser/basicfileinfo.h>
+
+#include <c++utilities/application/global.h>
+#include <c++utilities/io/nativefilestream.h>
+
+#ifdef PLATFORM_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <ios>
+#include <limits>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace TagParser;
+
+namespace Cli {
+
+/*!
+ * \class MappedStreamBuffer
+ * \brief The MappedStreamBuffer class is a read-only stream buffer over a memory-mapped file.
+ *
+ * The whole mapping is exposed as get area so reading never leads to a syscall and seeking just moves the get pointer. Like
+ * with file buffers, it is possible to seek beyond the end; reading from there fails.
+ */
+
+/*!
+ * \brief Constructs a buffer for the specified \a size bytes of \a data.
+ */
+MappedStreamBuffer::MappedStreamBuffer(const char *data, std::size_t size)
+    : m_size(size)
+    , m_pastEnd(0)
+{
+    auto *const begin = const_cast<char *>(data);
+    setg(begin, begin, begin + size);
+}
+
+std::streamsize MappedStreamBuffer::showmanyc()
+{
+    return gptr() < egptr() ? static_cast<std::streamsize>(egptr() - gptr()) : -1;
+}
+
+MappedStreamBuffer::pos_type MappedStreamBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::in)) {
+        return pos_type(off_type(-1));
+    }
+    auto base = off_type();
+    switch (dir) {
+    case std::ios_base::beg:
+        break;
+    case std::ios_base::cur:
+        base = static_cast<off_type>(gptr() - eback()) + static_cast<off_type>(m_pastEnd);
+        break;
+    case std::ios_base::end:
+        base = static_cast<off_type>(m_size);
+        break;
+    default:
+        return pos_type(off_type(-1));
+    }
+    const auto target = base + off;
+    if (target < 0) {
+        return pos_type(off_type(-1));
+    }
+    if (static_cast<std::uint64_t>(target) <= m_size) {
+        setg(eback(), eback() + target, egptr());
+        m_pastEnd = 0;
+    } else {
+        setg(eback(), egptr(), egptr());
+        m_pastEnd = static_cast<std::uint64_t>(target) - m_size;
+    }
+    return pos_type(target);
+}
+
+MappedStreamBuffer::pos_type MappedStreamBuffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+/*!
+ * \class FileMapping
+ * \brief The FileMapping class maps a file opened via a BasicFileInfo object read-only into memory while it is alive.
+ *
+ * The stream of the file info is switched to a MappedStreamBuffer so the parser reads directly from the mapping instead of
+ * issuing a read() for each buffer refill. The original buffer is restored on destruction, so the FileMapping must be
+ * destroyed before the file info is closed or re-opened. The kernel is told whether the file will be accessed randomly (e.g.
+ * to parse headers and tags) or sequentially (e.g. to validate the whole file).
+ *
+ * If the file can not be mapped (e.g. because it is empty or mapping is not supported on the platform) the file is read as
+ * usual.
+ * \remarks The file must not be truncated while being mapped.
+ */
+
+/*!
+ * \brief Maps the file opened via \a fileInfo and switches its stream to read from the mapping.
+ */
+FileMapping::FileMapping(BasicFileInfo &fileInfo, AccessPattern accessPattern)
+    : m_fileInfo(fileInfo)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_originalBuffer(nullptr)
+{
+#ifdef PLATFORM_UNIX
+    const auto size = fileInfo.size();
+    if (!size || size > std::numeric_limits<std::size_t>::max()) {
+        return;
+    }
+    const auto fd = ::open(fileInfo.path().data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    struct stat stats = {};
+    auto *const data = !::fstat(fd, &stats) && static_cast<std::uint64_t>(stats.st_size) == size
+        ? ::mmap(nullptr, static_cast<std::size_t>(size), PROT_READ, MAP_SHARED, fd, 0)
+        : MAP_FAILED;
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return;
+    }
+    m_data = static_cast<char *>(data);
+    m_size = static_cast<std::size_t>(size);
+    ::madvise(m_data, m_size, accessPattern == AccessPattern::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    m_buffer.emplace(m_data, m_size);
+    m_originalBuffer = static_cast<std::ios &>(fileInfo.stream()).rdbuf(&*m_buffer);
+#else
+    CPP_UTILITIES_UNUSED(accessPattern);
+#endif
+}
+
+/*!
+ * \brief Restores the original buffer of the stream and unmaps the file.
+ */
+FileMapping::~FileMapping()
+{
+    if (!m_buffer) {
+        return;
+    }
+    static_cast<std::ios &>(m_fileInfo.stream()).rdbuf(m_originalBuffer);
+#ifdef PLATFORM_UNIX
+    ::munmap(m_data, m_size);
+#endif
+}
+
+/*!
+ * \brief Returns the specified range of the mapped file without copying it.
+ * \returns Returns an empty view if the file is not mapped or the range exceeds the file.
+ * \remarks The kernel is told that the range will be needed soon.
+ */
+std::string_view FileMapping::view(std::uint64_t offset, std::uint64_t size) const
+{
+    if (!m_buffer || offset > m_size || size > m_size - offset) {
+        return std::string_view();
+    }
+#ifdef PLATFORM_UNIX
+    static const auto pageSize = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+    const auto alignedOffset = offset - offset % pageSize;
+    ::madvise(m_data + alignedOffset, static_cast<std::size_t>(offset + size - alignedOffset), MADV_WILLNEED);
+#endif
+    return std::string_view(m_data + offset, static_cast<std::size_t>(size));
+}
+
+} // namespace Cli
@@ -0,0 +1,60 @@
+#ifndef CLI_MAPPED_FILE
+#define CLI_MAPPED_FILE
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <streambuf>
+#include <string_view>
+
+namespace TagParser {
+class BasicFileInfo;
+}
+
+namespace Cli {
+
+class MappedStreamBuffer : public std::streambuf {
+public:
+    explicit MappedStreamBuffer(const char *data, std::size_t size);
+
+protected:
+    std::streamsize showmanyc() override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+    std::uint64_t m_size;
+    std::uint64_t m_pastEnd;
+};
+
+enum class AccessPattern { Random, Sequential };
+
+class FileMapping {
+public:
+    explicit FileMapping(TagParser::BasicFileInfo &fileInfo, AccessPattern accessPattern);
+    ~FileMapping();
+    FileMapping(const FileMapping &) = delete;
+    FileMapping &operator=(const FileMapping &) = delete;
+
+    bool isMapped() const;
+    std::string_view view(std::uint64_t offset, std::uint64_t size) const;
+
+private:
+    TagParser::BasicFileInfo &m_fileInfo;
+    char *m_data;
+    std::size_t m_size;
+    std::streambuf *m_originalBuffer;
+    std::optional<MappedStreamBuffer> m_buffer;
+};
+
+/*!
+ * \brief Returns whether the file could be mapped; if not, the file is read as usual.
+ */
+inline bool FileMapping::isMapped() const
+{
+    return m_buffer.has_value();
+}
+
+} // namespace Cli
+
+#endif // CLI_MAPPED_FILE
@@ -0,0 +1,239 @@
+#include "./paddingadvisor.h"
+
+#include <c++utilities/application/argumentparser.h>
+#include <c++utilities/conversion/conversionexception.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/ansiescapecodes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+
+namespace Cli {
+
+/*!
+ * \class SizeHistogram
+ * \brief The SizeHistogram class counts sizes within logarithmic buckets.
+ *
+ * Each power of two is divided into 8 buckets so quantiles are accurate within 12.5 % while the memory usage does not
+ * depend on the number of sizes added.
+ */
+
+/*!
+ * \brief Adds the specified \a size to the histogram.
+ */
+void SizeHistogram::add(std::uint64_t size)
+{
+    ++m_buckets[bucketIndex(size)];
+    ++m_count;
+}
+
+/*!
+ * \brief Returns the smallest size which is greater than or equal to the portion \a q of all sizes added.
+ * \remarks The upper bound of the relevant bucket is returned so the quantile is never underestimated.
+ */
+std::uint64_t SizeHistogram::quantile(double q) const
+{
+    if (!m_count) {
+        return 0;
+    }
+    const auto target = std::clamp<std::uint64_t>(static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(m_count))), 1, m_count);
+    auto cumulativeCount = std::uint64_t();
+    for (auto i = std::size_t(); i != bucketCount; ++i) {
+        if ((cumulativeCount += m_buckets[i]) >= target) {
+            return bucketUpperBound(i);
+        }
+    }
+    return bucketUpperBound(bucketCount - 1);
+}
+
+/*!
+ * \brief Prints the number of sizes per power of two.
+ */
+void SizeHistogram::print(std::ostream &out) const
+{
+    for (auto group = std::size_t(); group != bucketCount >> subBucketBits; ++group) {
+        auto count = std::uint64_t();
+        for (auto i = group << subBucketBits, end = (group + 1) << subBucketBits; i != end; ++i) {
+            count += m_buckets[i];
+        }
+        if (count) {
+            out << "     < " << dataSizeToString(bucketUpperBound(((group + 1) << subBucketBits) - 1) + 1) << ": " << count << '\n';
+        }
+    }
+}
+
+std::size_t SizeHistogram::bucketIndex(std::uint64_t size)
+{
+    constexpr auto subBucketCount = std::uint64_t(1) << subBucketBits;
+    if (size < subBucketCount) {
+        return static_cast<std::size_t>(size);
+    }
+    auto msb = 0u;
+    for (auto remainingBits = size; remainingBits >>= 1;) {
+        ++msb;
+    }
+    const auto subBucket = (size >> (msb - subBucketBits)) & (subBucketCount - 1);
+    return static_cast<std::size_t>(((msb - subBucketBits + 1) << subBucketBits) + subBucket);
+}
+
+std::uint64_t SizeHistogram::bucketUpperBound(std::size_t index)
+{
+    constexpr auto subBucketCount = std::size_t(1) << subBucketBits;
+    if (index < subBucketCount) {
+        return index;
+    }
+    const auto shift = (index >> subBucketBits) - 1;
+    const auto subBucket = static_cast<std::uint64_t>(index & (subBucketCount - 1));
+    return ((subBucketCount + subBucket + 1) << shift) - 1;
+}
+
+/*!
+ * \class PaddingAdvisor
+ * \brief The PaddingAdvisor class gathers tag sizes and padding of many files to suggest padding values per container format.
+ *
+ * The suggested preferred padding is the growth of tags that is not exceeded by the specified portion of files (the max.
+ * rewrite rate). If the growth has been recorded from actual changes (see addGrowth()) it is used directly. Otherwise it is
+ * estimated as the difference between the median tag size and the tag size which is only exceeded by that portion of files.
+ *
+ * The suggested maximum padding is the larger value of twice the preferred padding and the padding most existing files
+ * already have; so the maximum padding does not cause more rewrites than the rate either. No minimum padding is suggested
+ * as it only causes rewrites.
+ *
+ * The advisor may be used from multiple threads at the same time.
+ */
+
+/*!
+ * \brief Constructs a new advisor which suggests padding values keeping the rate of rewrites below \a maxRewriteRate.
+ */
+PaddingAdvisor::PaddingAdvisor(double maxRewriteRate)
+    : m_maxRewriteRate(maxRewriteRate)
+{
+}
+
+/*!
+ * \brief Adds the specified \a tagSize and \a padding of a file with the specified container \a format.
+ */
+void PaddingAdvisor::addFile(std::string_view format, std::uint64_t tagSize, std::uint64_t padding)
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    auto i = m_formats.find(format);
+    if (i == m_formats.end()) {
+        i = m_formats.emplace(std::string(format), FormatStatistics()).first;
+    }
+    i->second.tagSizes.add(tagSize);
+    i->second.paddings.add(padding);
+}
+
+/*!
+ * \brief Adds the \a growth of the tags of a file with the specified container \a format caused by changes.
+ * \remarks A negative growth (tags became smaller) is counted as no growth.
+ */
+void PaddingAdvisor::addGrowth(std::string_view format, std::int64_t growth)
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    auto i = m_formats.find(format);
+    if (i == m_formats.end()) {
+        i = m_formats.emplace(std::string(format), FormatStatistics()).first;
+    }
+    i->second.growths.add(growth > 0 ? static_cast<std::uint64_t>(growth) : 0);
+}
+
+/*!
+ * \brief Returns the suggested padding values for the specified container \a format.
+ * \remarks The suggestion is only valid if at least minSampleCount files of the format have been added.
+ */
+PaddingAdvisor::Suggestion PaddingAdvisor::suggestion(std::string_view format) const
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    const auto i = m_formats.find(format);
+    return i != m_formats.end() ? suggestion(i->second) : Suggestion();
+}
+
+PaddingAdvisor::Suggestion PaddingAdvisor::suggestion(const FormatStatistics &statistics) const
+{
+    auto suggestion = Suggestion();
+    if (statistics.tagSizes.count() < minSampleCount) {
+        return suggestion;
+    }
+    constexpr auto granularity = std::uint64_t(512);
+    const auto roundUp = [](std::uint64_t size) { return (size + granularity - 1) / granularity * granularity; };
+    const auto q = 1.0 - m_maxRewriteRate;
+    auto growth = std::uint64_t();
+    if (statistics.growths.count() >= minSampleCount) {
+        growth = statistics.growths.quantile(q);
+    } else if (const auto tagSize = statistics.tagSizes.quantile(q), medianTagSize = statistics.tagSizes.quantile(0.5); tagSize > medianTagSize) {
+        growth = tagSize - medianTagSize;
+    }
+    suggestion.isValid = true;
+    suggestion.preferredPadding = roundUp(growth);
+    suggestion.maxPadding = std::max(suggestion.preferredPadding * 2, roundUp(statistics.paddings.quantile(q)));
+    return suggestion;
+}
+
+/*!
+ * \brief Prints histograms and suggestions for all container formats.
+ */
+void PaddingAdvisor::printReport(std::ostream &out) const
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    out << TextAttribute::Bold << "Padding statistics" << TextAttribute::Reset << " (suggestions keep the expected rate of rewrites below "
+        << m_maxRewriteRate * 100.0 << " %):\n";
+    if (m_formats.empty()) {
+        out << " - No files have been analyzed.\n";
+        return;
+    }
+    const auto q = 1.0 - m_maxRewriteRate;
+    const auto printSizes = [&out, q](std::string_view label, const SizeHistogram &sizes) {
+        out << "   " << label << " (median/" << q * 100.0 << " %): " << dataSizeToString(sizes.quantile(0.5)) << " / "
+            << dataSizeToString(sizes.quantile(q)) << '\n';
+    };
+    for (const auto &[format, statistics] : m_formats) {
+        out << " - " << TextAttribute::Bold << format << TextAttribute::Reset << ": " << statistics.tagSizes.count() << " files\n";
+        printSizes("Tag size", statistics.tagSizes);
+        printSizes("Padding", statistics.paddings);
+        if (statistics.growths.count()) {
+            printSizes("Growth of tags", statistics.growths);
+        }
+        out << "   Tag sizes:\n";
+        statistics.tagSizes.print(out);
+        out << "   Paddings:\n";
+        statistics.paddings.print(out);
+        if (const auto s = suggestion(statistics); s.isValid) {
+            out << "   Suggestion: --min-padding " << s.minPadding << " --max-padding " << s.maxPadding << " --preferred-padding "
+                << s.preferredPadding << '\n';
+        } else {
+            out << "   Suggestion: not enough files (at least " << minSampleCount << " files are required)\n";
+        }
+    }
+}
+
+/*!
+ * \brief Parses the max. rewrite rate specified in percent as value with the specified \a valueIndex of \a arg.
+ * \returns Returns the rate as fraction or PaddingAdvisor::defaultMaxRewriteRate if no value has been specified.
+ */
+double parseMaxRewriteRate(const Argument &arg, std::size_t valueIndex)
+{
+    if (!arg.isPresent() || arg.values().size() <= valueIndex) {
+        return PaddingAdvisor::defaultMaxRewriteRate;
+    }
+    const char *const value = arg.values()[valueIndex];
+    try {
+        const auto percent = stringToNumber<unsigned int>(value);
+        if (percent < 1 || percent > 99) {
+            throw ConversionException();
+        }
+        return percent / 100.0;
+    } catch (const ConversionException &) {
+        std::cerr << Phrases::Error << "The specified rewrite rate \"" << value << "\" is invalid." << Phrases::End
+                  << "note: Specify a percentage between 1 and 99." << endl;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+} // namespace Cli
@@ -0,0 +1,80 @@
+#ifndef CLI_PADDING_ADVISOR
+#define CLI_PADDING_ADVISOR
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace CppUtilities {
+class Argument;
+}
+
+namespace Cli {
+
+class SizeHistogram {
+public:
+    void add(std::uint64_t size);
+    std::uint64_t count() const;
+    std::uint64_t quantile(double q) const;
+    void print(std::ostream &out) const;
+
+private:
+    static constexpr unsigned int subBucketBits = 3;
+    static constexpr std::size_t bucketCount = 64 << subBucketBits;
+
+    static std::size_t bucketIndex(std::uint64_t size);
+    static std::uint64_t bucketUpperBound(std::size_t index);
+
+    std::array<std::uint64_t, bucketCount> m_buckets = {};
+    std::uint64_t m_count = 0;
+};
+
+/*!
+ * \brief Returns the number of sizes added to the histogram.
+ */
+inline std::uint64_t SizeHistogram::count() const
+{
+    return m_count;
+}
+
+class PaddingAdvisor {
+public:
+    struct Suggestion {
+        bool isValid = false;
+        std::uint64_t minPadding = 0;
+        std::uint64_t maxPadding = 0;
+        std::uint64_t preferredPadding = 0;
+    };
+    static constexpr std::uint64_t minSampleCount = 16;
+    static constexpr double defaultMaxRewriteRate = 0.05;
+
+    explicit PaddingAdvisor(double maxRewriteRate = defaultMaxRewriteRate);
+    void addFile(std::string_view format, std::uint64_t tagSize, std::uint64_t padding);
+    void addGrowth(std::string_view format, std::int64_t growth);
+    Suggestion suggestion(std::string_view format) const;
+    void printReport(std::ostream &out) const;
+
+private:
+    struct FormatStatistics {
+        SizeHistogram tagSizes;
+        SizeHistogram paddings;
+        SizeHistogram growths;
+    };
+
+    Suggestion suggestion(const FormatStatistics &statistics) const;
+
+    double m_maxRewriteRate;
+    mutable std::mutex m_mutex;
+    std::map<std::string, FormatStatistics, std::less<>> m_formats;
+};
+
+double parseMaxRewriteRate(const CppUtilities::Argument &arg, std::size_t valueIndex);
+
+} // namespace Cli
+
+#endif // CLI_PADDING_ADVISOR
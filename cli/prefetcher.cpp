@@ -0,0 +1,195 @@
+#include "./prefetcher.h"
+
+#include <c++utilities/io/nativefilestream.h>
+
+#ifdef PLATFORM_UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <ios>
+#include <memory>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace Cli {
+
+/// \cond
+#if defined(PLATFORM_UNIX) && defined(POSIX_FADV_WILLNEED)
+constexpr auto maxTopLevelAtoms = std::uint64_t(64);
+
+static std::uint64_t readBigEndian(const unsigned char *bytes, std::size_t size)
+{
+    auto value = std::uint64_t();
+    for (auto i = std::size_t(); i != size; ++i) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+/*!
+ * \brief Prefetches the "moov" atom of the MP4 file with the specified \a fd; it might be located anywhere in the file.
+ * \remarks Only reads the headers of the top-level atoms so this is cheap even if the "mdat" atom comes first.
+ */
+static void prefetchMp4MovieAtom(int fd, std::uint64_t fileSize)
+{
+    unsigned char header[16];
+    for (auto offset = std::uint64_t(), i = std::uint64_t(); offset + 8 <= fileSize && i != maxTopLevelAtoms; ++i) {
+        if (::pread(fd, header, sizeof(header), static_cast<off_t>(offset)) < 16) {
+            return;
+        }
+        auto size = readBigEndian(header, 4);
+        if (size == 1) {
+            size = readBigEndian(header + 8, 8);
+        } else if (size == 0) {
+            size = fileSize - offset;
+        }
+        if (size < 8 || size > fileSize - offset) {
+            return;
+        }
+        if (!std::memcmp(header + 4, "moov", 4)) {
+            ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(size), POSIX_FADV_WILLNEED);
+            return;
+        }
+        offset += size;
+    }
+}
+#endif
+/// \endcond
+
+/*!
+ * \class Prefetcher
+ * \brief The Prefetcher class prefetches the parts of files which are usually read when parsing them.
+ *
+ * It is used by the read-only operations to hide the latency of opening files and seeking within them (e.g. on rotating disks
+ * or network file systems) by preparing the next files while the current file is being parsed. Worker threads open the files
+ * in the order they have been added and ask the kernel to read the beginning and the end of each file in the background via
+ * posix_fadvise(). The end is relevant because ID3v1 and APE tags are located there and Matroska files usually have their tags
+ * after the clusters. For MP4 files the top-level atoms are skipped to prefetch the "moov" atom as it might be located at the
+ * end of the file as well. Without posix_fadvise() the beginning and the end are read explicitly.
+ *
+ * Jobs for files which are already being processed are skipped (see skipUntil()) so a slow prefetcher never delays processing.
+ */
+
+/*!
+ * \brief Starts \a threadCount worker threads.
+ */
+Prefetcher::Prefetcher(std::size_t threadCount)
+    : m_nextIndex(0)
+    , m_aborted(false)
+{
+    m_threads.reserve(threadCount);
+    for (; threadCount; --threadCount) {
+        m_threads.emplace_back(&Prefetcher::work, this);
+    }
+}
+
+/*!
+ * \brief Discards pending jobs and waits for the worker threads to finish.
+ */
+Prefetcher::~Prefetcher()
+{
+    {
+        auto lock = std::unique_lock(m_mutex);
+        m_aborted = true;
+    }
+    m_jobsChanged.notify_all();
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+/*!
+ * \brief Adds the file with the specified \a path to be prefetched; \a index denotes the position of the file in the batch.
+ */
+void Prefetcher::prefetch(std::string &&path, std::size_t index)
+{
+    {
+        auto lock = std::unique_lock(m_mutex);
+        m_jobs.emplace_back(Job{ std::move(path), index });
+    }
+    m_jobsChanged.notify_one();
+}
+
+/*!
+ * \brief Discards jobs for files before the specified \a index because those files are already being processed.
+ */
+void Prefetcher::skipUntil(std::size_t index)
+{
+    auto lock = std::unique_lock(m_mutex);
+    m_nextIndex = std::max(m_nextIndex, index);
+    while (!m_jobs.empty() && m_jobs.front().index < m_nextIndex) {
+        m_jobs.pop_front();
+    }
+}
+
+/*!
+ * \brief Prefetches jobs until the prefetcher is destroyed.
+ */
+void Prefetcher::work()
+{
+    auto lock = std::unique_lock(m_mutex);
+    for (;;) {
+        m_jobsChanged.wait(lock, [this] { return m_aborted || !m_jobs.empty(); });
+        if (m_aborted) {
+            return;
+        }
+        const auto job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        if (job.index < m_nextIndex) {
+            continue;
+        }
+        lock.unlock();
+        prefetchFile(job.path);
+        lock.lock();
+    }
+}
+
+/*!
+ * \brief Prefetches the beginning and the end of the file with the specified \a path (and the "moov" atom of MP4 files).
+ * \remarks Errors are ignored; they will be reported when actually opening the file.
+ */
+void Prefetcher::prefetchFile(const std::string &path)
+{
+#if defined(PLATFORM_UNIX) && defined(POSIX_FADV_WILLNEED)
+    const auto fd = ::open(path.data(), O_RDONLY | O_CLOEXEC | O_NOCTTY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat stats = {};
+    if (!::fstat(fd, &stats) && S_ISREG(stats.st_mode)) {
+        const auto fileSize = static_cast<std::uint64_t>(stats.st_size);
+        ::posix_fadvise(fd, 0, static_cast<off_t>(std::min(headSize, fileSize)), POSIX_FADV_WILLNEED);
+        if (fileSize > headSize) {
+            const auto tailOffset = std::max(headSize, fileSize - std::min(tailSize, fileSize));
+            ::posix_fadvise(fd, static_cast<off_t>(tailOffset), static_cast<off_t>(fileSize - tailOffset), POSIX_FADV_WILLNEED);
+        }
+        char type[8];
+        if (::pread(fd, type, sizeof(type), 0) == sizeof(type) && !std::memcmp(type + 4, "ftyp", 4)) {
+            prefetchMp4MovieAtom(fd, fileSize);
+        }
+    }
+    ::close(fd);
+#else
+    auto file = NativeFileStream();
+    file.open(path, std::ios_base::in | std::ios_base::binary);
+    if (!file) {
+        return;
+    }
+    const auto buffer = std::make_unique<char[]>(static_cast<std::size_t>(std::max(headSize, tailSize)));
+    file.read(buffer.get(), static_cast<std::streamsize>(headSize));
+    file.clear();
+    file.seekg(0, std::ios_base::end);
+    const auto fileSize = static_cast<std::uint64_t>(file.tellg());
+    if (fileSize > headSize) {
+        file.seekg(static_cast<std::streamoff>(std::max(headSize, fileSize - std::min(tailSize, fileSize))));
+        file.read(buffer.get(), static_cast<std::streamsize>(tailSize));
+    }
+#endif
+}
+
+} // namespace Cli
@@ -0,0 +1,47 @@
+#ifndef CLI_PREFETCHER
+#define CLI_PREFETCHER
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Cli {
+
+class Prefetcher {
+public:
+    explicit Prefetcher(std::size_t threadCount);
+    ~Prefetcher();
+    Prefetcher(const Prefetcher &) = delete;
+    Prefetcher &operator=(const Prefetcher &) = delete;
+
+    void prefetch(std::string &&path, std::size_t index);
+    void skipUntil(std::size_t index);
+    static void prefetchFile(const std::string &path);
+
+    static constexpr std::uint64_t headSize = 256 * 1024;
+    static constexpr std::uint64_t tailSize = 256 * 1024;
+
+private:
+    struct Job {
+        std::string path;
+        std::size_t index;
+    };
+
+    void work();
+
+    std::mutex m_mutex;
+    std::condition_variable m_jobsChanged;
+    std::deque<Job> m_jobs;
+    std::size_t m_nextIndex;
+    bool m_aborted;
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace Cli
+
+#endif // CLI_PREFETCHER
@@ -0,0 +1,237 @@
+#include "./readscheduler.h"
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/io/nativefilestream.h>
+#include <c++utilities/io/path.h>
+
+#ifdef PLATFORM_UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <ios>
+#include <memory>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace Cli {
+
+/*!
+ * \class ReadScheduler
+ * \brief The ReadScheduler class reads files one after another from start to end on a single thread so the disk keeps streaming.
+ *
+ * It is used by the "verify"-operation which parses many files in parallel. Letting each worker read its file on its own would
+ * make the disk seek between the files. Instead the files are read sequentially in large chunks in the order they have been
+ * added and workers only start parsing a file once it has been read (so parsing is served from the page cache). Reading the
+ * whole file also reveals files which can not be read (e.g. due to bad sectors) even if parsing would not touch the affected part.
+ *
+ * The budget limits how many bytes of files which have been read but not released yet may be cached so the read-ahead does not
+ * evict the files being parsed. A file larger than the budget is still read as a whole (then parsing it might not be served from
+ * the cache entirely). Once released, the pages of a file are dropped from the cache via posix_fadvise() (if supported) as they
+ * are not going to be needed again.
+ */
+
+/*!
+ * \brief Starts the thread reading the files; at most \a budget bytes of files which have not been released are kept in flight.
+ */
+ReadScheduler::ReadScheduler(std::uint64_t budget)
+    : m_firstIndex(0)
+    , m_nextToRead(0)
+    , m_budget(budget ? budget : 1)
+    , m_bytesInFlight(0)
+    , m_bytesRead(0)
+    , m_aborted(false)
+    , m_thread(&ReadScheduler::work, this)
+{
+}
+
+/*!
+ * \brief Stops reading and waits for the thread to finish.
+ */
+ReadScheduler::~ReadScheduler()
+{
+    {
+        auto lock = std::unique_lock(m_mutex);
+        m_aborted.store(true);
+    }
+    m_stateChanged.notify_all();
+    m_thread.join();
+#ifdef PLATFORM_UNIX
+    for (const auto &job : m_jobs) {
+        if (job.fd >= 0) {
+            ::close(job.fd);
+        }
+    }
+#endif
+}
+
+/*!
+ * \brief Adds the file with the specified \a path to be read; \a index denotes the position of the file in the batch.
+ * \remarks Files must be added in order (starting with index 0) and each file must be released via release() eventually.
+ */
+void ReadScheduler::add(std::string &&path, std::size_t index)
+{
+    {
+        auto lock = std::unique_lock(m_mutex);
+        m_jobs.emplace_back(Job{ std::move(path), index, JobState::Queued, 0, std::string(), -1 });
+    }
+    m_stateChanged.notify_all();
+}
+
+/*!
+ * \brief Waits until the file with the specified \a index has been read.
+ * \returns Returns an error message if the file could not be read completely; otherwise an empty string.
+ */
+std::string ReadScheduler::waitUntilRead(std::size_t index)
+{
+    auto lock = std::unique_lock(m_mutex);
+    auto &job = this->job(index);
+    m_stateChanged.wait(lock, [this, &job] { return job.state == JobState::Read || m_aborted.load(); });
+    return job.error;
+}
+
+/*!
+ * \brief Releases the file with the specified \a index so its part of the budget is available for the next files.
+ */
+void ReadScheduler::release(std::size_t index)
+{
+    {
+        auto lock = std::unique_lock(m_mutex);
+        auto &job = this->job(index);
+#ifdef PLATFORM_UNIX
+        if (job.fd >= 0) {
+#ifdef POSIX_FADV_DONTNEED
+            ::posix_fadvise(job.fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+            ::close(job.fd);
+            job.fd = -1;
+        }
+#endif
+        m_bytesInFlight -= job.accountedSize;
+        job.state = JobState::Released;
+        for (; !m_jobs.empty() && m_jobs.front().state == JobState::Released; ++m_firstIndex) {
+            m_jobs.pop_front();
+        }
+    }
+    m_stateChanged.notify_all();
+}
+
+/*!
+ * \brief Returns the number of bytes read so far.
+ */
+std::uint64_t ReadScheduler::bytesRead() const
+{
+    auto lock = std::unique_lock(m_mutex);
+    return m_bytesRead;
+}
+
+/*!
+ * \brief Returns the job for the file with the specified \a index.
+ * \remarks Must be called with the mutex locked.
+ */
+ReadScheduler::Job &ReadScheduler::job(std::size_t index)
+{
+    return m_jobs[index - m_firstIndex];
+}
+
+/*!
+ * \brief Reads the files in the order they have been added until the scheduler is destroyed.
+ */
+void ReadScheduler::work()
+{
+    const auto buffer = std::make_unique<char[]>(chunkSize);
+    auto lock = std::unique_lock(m_mutex);
+    for (;;) {
+        m_stateChanged.wait(lock, [this] { return m_aborted.load() || m_nextToRead < m_firstIndex + m_jobs.size(); });
+        if (m_aborted.load()) {
+            return;
+        }
+        auto &job = this->job(m_nextToRead++);
+        job.state = JobState::Reading;
+        readFile(job, lock, buffer.get());
+        job.state = JobState::Read;
+        m_stateChanged.notify_all();
+    }
+}
+
+/*!
+ * \brief Waits until the file of the specified \a job with the specified \a size fits into the budget and accounts for it.
+ * \remarks Must be called with the mutex locked via \a lock. If nothing is in flight, the file is accounted for regardless of its size.
+ */
+void ReadScheduler::waitForBudget(Job &job, std::uint64_t size, std::unique_lock<std::mutex> &lock)
+{
+    job.accountedSize = std::min(size, m_budget);
+    m_stateChanged.wait(lock, [this, &job] { return m_aborted.load() || !m_bytesInFlight || m_bytesInFlight + job.accountedSize <= m_budget; });
+    m_bytesInFlight += job.accountedSize;
+}
+
+/*!
+ * \brief Reads the file of the specified \a job from start to end once its size fits into the budget.
+ * \remarks Must be called with the mutex locked via \a lock; it is unlocked while opening and reading the file.
+ */
+void ReadScheduler::readFile(Job &job, std::unique_lock<std::mutex> &lock, char *buffer)
+{
+    auto bytesRead = std::uint64_t();
+#ifdef PLATFORM_UNIX
+    lock.unlock();
+    const auto fd = ::open(job.path.data(), O_RDONLY | O_CLOEXEC | O_NOCTTY);
+    const auto openError = errno;
+    struct stat stats = {};
+    const auto size = fd >= 0 && !::fstat(fd, &stats) ? static_cast<std::uint64_t>(stats.st_size) : std::uint64_t();
+    lock.lock();
+    if (fd < 0) {
+        job.error = argsToString("unable to open the file: ", std::strerror(openError));
+        return;
+    }
+    job.fd = fd;
+    waitForBudget(job, size, lock);
+    lock.unlock();
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    while (!m_aborted.load()) {
+        const auto res = ::read(fd, buffer, chunkSize);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            job.error = argsToString("unable to read the file at offset ", bytesRead, ": ", std::strerror(errno));
+            break;
+        }
+        if (!res) {
+            break;
+        }
+        bytesRead += static_cast<std::uint64_t>(res);
+    }
+    lock.lock();
+#else
+    auto sizeError = std::error_code();
+    const auto size = std::filesystem::file_size(makeNativePath(job.path), sizeError);
+    waitForBudget(job, sizeError ? std::uint64_t() : static_cast<std::uint64_t>(size), lock);
+    lock.unlock();
+    try {
+        auto file = NativeFileStream();
+        file.exceptions(std::ios_base::badbit);
+        file.open(job.path, std::ios_base::in | std::ios_base::binary);
+        if (!file) {
+            throw std::ios_base::failure("unable to open the file");
+        }
+        while (!m_aborted.load() && file) {
+            file.read(buffer, static_cast<std::streamsize>(chunkSize));
+            bytesRead += static_cast<std::uint64_t>(file.gcount());
+        }
+    } catch (const std::ios_base::failure &e) {
+        job.error = argsToString("unable to read the file at offset ", bytesRead, ": ", e.what());
+    }
+    lock.lock();
+#endif
+    m_bytesRead += bytesRead;
+}
+
+} // namespace Cli
@@ -0,0 +1,60 @@
+#ifndef CLI_READ_SCHEDULER
+#define CLI_READ_SCHEDULER
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Cli {
+
+class ReadScheduler {
+public:
+    explicit ReadScheduler(std::uint64_t budget);
+    ~ReadScheduler();
+    ReadScheduler(const ReadScheduler &) = delete;
+    ReadScheduler &operator=(const ReadScheduler &) = delete;
+
+    void add(std::string &&path, std::size_t index);
+    std::string waitUntilRead(std::size_t index);
+    void release(std::size_t index);
+    std::uint64_t bytesRead() const;
+
+    static constexpr std::uint64_t defaultBudget = 1024 * 1024 * 1024;
+    static constexpr std::size_t chunkSize = 4 * 1024 * 1024;
+
+private:
+    enum class JobState { Queued, Reading, Read, Released };
+    struct Job {
+        std::string path;
+        std::size_t index;
+        JobState state = JobState::Queued;
+        std::uint64_t accountedSize = 0;
+        std::string error;
+        int fd = -1;
+    };
+
+    Job &job(std::size_t index);
+    void work();
+    void waitForBudget(Job &job, std::uint64_t size, std::unique_lock<std::mutex> &lock);
+    void readFile(Job &job, std::unique_lock<std::mutex> &lock, char *buffer);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_stateChanged;
+    std::deque<Job> m_jobs;
+    std::size_t m_firstIndex;
+    std::size_t m_nextToRead;
+    std::uint64_t m_budget;
+    std::uint64_t m_bytesInFlight;
+    std::uint64_t m_bytesRead;
+    std::atomic_bool m_aborted;
+    std::thread m_thread;
+};
+
+} // namespace Cli
+
+#endif // CLI_READ_SCHEDULER
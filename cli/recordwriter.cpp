@@ -0,0 +1,319 @@
+#include "./recordwriter.h"
+
+#include <tagparser/tag.h>
+#include <tagparser/tagvalue.h>
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/ansiescapecodes.h>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+using namespace TagParser;
+
+namespace Cli {
+
+/// \cond
+constexpr auto hexDigits = std::string_view("0123456789abcdef");
+constexpr auto valueSeparator = std::string_view("; ");
+
+static std::string formatValue(const TagValue &value)
+{
+    switch (value.type()) {
+    case TagDataType::Binary:
+    case TagDataType::Picture:
+        return argsToString(
+            !value.mimeType().empty() ? std::string_view(value.mimeType()) : std::string_view("data"), ", ", value.dataSize(), " bytes");
+    default:
+        return value.toDisplayString();
+    }
+}
+/// \endcond
+
+/*!
+ * \class RecordWriter
+ * \brief The RecordWriter class writes the tag information of files as machine-readable records.
+ *
+ * It is used by the "get"-operation if an output format is specified. Each record starts with the path of the file (and the
+ * name of the tag if there is a record per tag) followed by a column for each field. If there is a record per file, the values
+ * of the first tag containing the field are used. Missing values are written as empty column (TSV/CSV) or null (NDJSON) and
+ * multiple values are separated by "; " (TSV/CSV) or written as array (NDJSON).
+ *
+ * The records of a file are composed in a buffer which is re-used for all files and pre-sized to the size of the largest output
+ * so far. That way the output of a file is written via a single call and needs no re-allocation in the usual case.
+ */
+
+/*!
+ * \brief Constructs a new writer for the specified \a format and \a columns.
+ */
+RecordWriter::RecordWriter(RecordFormat format, bool recordPerTag, std::vector<FieldScope> &&columns)
+    : m_format(format)
+    , m_recordPerTag(recordPerTag)
+    , m_columns(std::move(columns))
+    , m_values(m_columns.size())
+    , m_expectedSize(0)
+{
+    m_names.reserve(m_columns.size() + 2);
+    m_names.emplace_back("path");
+    if (m_recordPerTag) {
+        m_names.emplace_back("tag");
+    }
+    for (const auto &column : m_columns) {
+        m_names.emplace_back(column.field.name());
+    }
+}
+
+/*!
+ * \brief Parses the format \a denotation ("tsv", "csv" or "ndjson").
+ * \returns Returns whether the denotation is valid.
+ */
+bool RecordWriter::parseFormat(std::string_view denotation, RecordFormat &format)
+{
+    if (denotation == "tsv") {
+        format = RecordFormat::Tsv;
+    } else if (denotation == "csv") {
+        format = RecordFormat::Csv;
+    } else if (denotation == "ndjson") {
+        format = RecordFormat::Ndjson;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Writes the header line containing the column names; NDJSON has no header line.
+ */
+void RecordWriter::writeHeader(std::ostream &out)
+{
+    if (m_format == RecordFormat::Ndjson) {
+        return;
+    }
+    m_buffer.clear();
+    for (auto i = std::size_t(); i != m_names.size(); ++i) {
+        if (i) {
+            m_buffer += m_format == RecordFormat::Tsv ? '\t' : ',';
+        }
+        appendString(m_names[i]);
+    }
+    m_buffer += '\n';
+    out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+}
+
+/*!
+ * \brief Writes the record(s) for the file with the specified \a path and \a tags to \a out.
+ * \remarks If there is a record per tag and the file has no tags, nothing is written.
+ */
+void RecordWriter::writeFile(std::ostream &out, std::string_view path, const std::vector<Tag *> &tags)
+{
+    m_buffer.clear();
+    m_buffer.reserve(m_expectedSize);
+    if (m_recordPerTag) {
+        for (const auto *const tag : tags) {
+            collectValues(tag, false);
+            appendRecord(path, tag);
+        }
+    } else {
+        for (auto &values : m_values) {
+            values.clear();
+        }
+        for (const auto *const tag : tags) {
+            collectValues(tag, true);
+        }
+        appendRecord(path, nullptr);
+    }
+    m_expectedSize = std::max(m_expectedSize, m_buffer.size());
+    out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+}
+
+/*!
+ * \brief Assigns the values of \a tag to the columns; columns which already have values are skipped if \a keepPresentValues is set.
+ * \remarks Values which can not be converted to a string are skipped and reported via std::cerr.
+ */
+void RecordWriter::collectValues(const Tag *tag, bool keepPresentValues)
+{
+    const auto tagType = tag->type();
+    for (auto i = std::size_t(); i != m_columns.size(); ++i) {
+        auto &values = m_values[i];
+        if (keepPresentValues && !values.empty()) {
+            continue;
+        }
+        values.clear();
+        const auto &scope = m_columns[i];
+        if (scope.tagType != TagType::Unspecified && (scope.tagType | tagType) == TagType::Unspecified) {
+            continue;
+        }
+        try {
+            const auto fieldValues = scope.field.values(tag, tagType);
+            if (!fieldValues.second) {
+                continue;
+            }
+            for (const auto *const value : fieldValues.first) {
+                if (!value->isEmpty()) {
+                    values.emplace_back(formatValue(*value));
+                }
+            }
+        } catch (const ConversionException &e) {
+            values.clear();
+            cerr << Phrases::Warning << "Unable to convert value of \"" << scope.field.name() << "\" to string: " << e.what()
+                 << Phrases::EndFlush;
+        }
+    }
+}
+
+/*!
+ * \brief Appends a record with the values assigned to the columns to the buffer.
+ */
+void RecordWriter::appendRecord(std::string_view path, const Tag *tag)
+{
+    auto index = std::size_t();
+    if (m_format == RecordFormat::Ndjson) {
+        m_buffer += '{';
+    }
+    appendKey(index++);
+    appendString(path);
+    if (m_recordPerTag) {
+        appendKey(index++);
+        appendString(tagName(tag));
+    }
+    for (const auto &values : m_values) {
+        appendKey(index++);
+        appendValues(values);
+    }
+    if (m_format == RecordFormat::Ndjson) {
+        m_buffer += '}';
+    }
+    m_buffer += '\n';
+}
+
+/*!
+ * \brief Appends the separator and, in case of NDJSON, the name of the column with the specified \a index to the buffer.
+ */
+void RecordWriter::appendKey(std::size_t index)
+{
+    if (index) {
+        m_buffer += m_format == RecordFormat::Tsv ? '\t' : ',';
+    }
+    if (m_format == RecordFormat::Ndjson) {
+        appendString(m_names[index]);
+        m_buffer += ':';
+    }
+}
+
+/*!
+ * \brief Appends the specified \a value to the buffer escaping it as needed for the format.
+ *
+ * - TSV: backslashes, tabs and line breaks are escaped via a backslash.
+ * - CSV: the value is enclosed in double-quotes if it contains a comma, a double-quote or a line break (see RFC 4180).
+ * - NDJSON: the value is written as JSON string.
+ */
+void RecordWriter::appendString(std::string_view value)
+{
+    switch (m_format) {
+    case RecordFormat::Tsv:
+        for (const auto c : value) {
+            switch (c) {
+            case '\\':
+                m_buffer += "\\\\";
+                break;
+            case '\t':
+                m_buffer += "\\t";
+                break;
+            case '\n':
+                m_buffer += "\\n";
+                break;
+            case '\r':
+                m_buffer += "\\r";
+                break;
+            default:
+                m_buffer += c;
+            }
+        }
+        break;
+    case RecordFormat::Csv:
+        if (value.find_first_of(",\"\n\r") == std::string_view::npos) {
+            m_buffer += value;
+            break;
+        }
+        m_buffer += '"';
+        for (const auto c : value) {
+            if (c == '"') {
+                m_buffer += '"';
+            }
+            m_buffer += c;
+        }
+        m_buffer += '"';
+        break;
+    case RecordFormat::Ndjson:
+        m_buffer += '"';
+        for (const auto c : value) {
+            switch (c) {
+            case '"':
+                m_buffer += "\\\"";
+                break;
+            case '\\':
+                m_buffer += "\\\\";
+                break;
+            case '\n':
+                m_buffer += "\\n";
+                break;
+            case '\r':
+                m_buffer += "\\r";
+                break;
+            case '\t':
+                m_buffer += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    m_buffer += "\\u00";
+                    m_buffer += hexDigits[static_cast<unsigned char>(c) >> 4];
+                    m_buffer += hexDigits[static_cast<unsigned char>(c) & 0xF];
+                } else {
+                    m_buffer += c;
+                }
+            }
+        }
+        m_buffer += '"';
+        break;
+    }
+}
+
+/*!
+ * \brief Appends the specified \a values of a column to the buffer.
+ */
+void RecordWriter::appendValues(const std::vector<std::string> &values)
+{
+    if (m_format == RecordFormat::Ndjson) {
+        if (values.empty()) {
+            m_buffer += "null";
+            return;
+        }
+        m_buffer += '[';
+        for (auto i = values.cbegin(), end = values.cend(); i != end; ++i) {
+            if (i != values.cbegin()) {
+                m_buffer += ',';
+            }
+            appendString(*i);
+        }
+        m_buffer += ']';
+        return;
+    }
+    if (values.size() == 1) {
+        appendString(values.front());
+        return;
+    }
+    m_joinedValues.clear();
+    for (auto i = values.cbegin(), end = values.cend(); i != end; ++i) {
+        if (i != values.cbegin()) {
+            m_joinedValues += valueSeparator;
+        }
+        m_joinedValues += *i;
+    }
+    appendString(m_joinedValues);
+}
+
+} // namespace Cli
@@ -0,0 +1,43 @@
+#ifndef CLI_RECORD_WRITER
+#define CLI_RECORD_WRITER
+
+#include "./helper.h"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Cli {
+
+enum class RecordFormat { Tsv, Csv, Ndjson };
+
+class RecordWriter {
+public:
+    explicit RecordWriter(RecordFormat format, bool recordPerTag, std::vector<FieldScope> &&columns);
+
+    static bool parseFormat(std::string_view denotation, RecordFormat &format);
+    void writeHeader(std::ostream &out);
+    void writeFile(std::ostream &out, std::string_view path, const std::vector<TagParser::Tag *> &tags);
+
+private:
+    void collectValues(const TagParser::Tag *tag, bool keepPresentValues);
+    void appendRecord(std::string_view path, const TagParser::Tag *tag);
+    void appendKey(std::size_t index);
+    void appendString(std::string_view value);
+    void appendValues(const std::vector<std::string> &values);
+
+    RecordFormat m_format;
+    bool m_recordPerTag;
+    std::vector<FieldScope> m_columns;
+    std::vector<std::string> m_names;
+    std::vector<std::vector<std::string>> m_values;
+    std::string m_buffer;
+    std::string m_joinedValues;
+    std::size_t m_expectedSize;
+};
+
+} // namespace Cli
+
+#endif // CLI_RECORD_WRITER
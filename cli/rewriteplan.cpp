@@ -0,0 +1,197 @@
+#include "./rewriteplan.h"
+
+#include <tagparser/abstractcontainer.h>
+#include <tagparser/id3/id3v2tag.h>
+#include <tagparser/matroska/matroskatag.h>
+#include <tagparser/mediafileinfo.h>
+#include <tagparser/mp4/mp4tag.h>
+#include <tagparser/tag.h>
+#include <tagparser/vorbis/vorbiscomment.h>
+
+#include <c++utilities/conversion/stringconversion.h>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace TagParser;
+
+namespace Cli {
+
+/*!
+ * \class RewritePlan
+ * \brief The RewritePlan struct holds the prediction of how changes would be applied to a file.
+ *
+ * The prediction mirrors the rules tagparser uses to decide between applying changes in-place (consuming or freeing
+ * padding) and rewriting the entire file. It is only an estimation; e.g. the size of elements like the Matroska "SeekHead"
+ * and the alignment of Ogg pages are not taken into account.
+ */
+
+/*!
+ * \brief Adds the specified \a plan to the totals.
+ */
+void RewritePlanTotals::add(const RewritePlan &plan)
+{
+    if (plan.isRewrite()) {
+        ++rewriteCount;
+        bytesToRewrite += plan.bytesToWrite;
+    } else {
+        ++inPlaceCount;
+    }
+    bytesToWrite += plan.bytesToWrite;
+}
+
+/*!
+ * \brief Returns the size the specified \a tag would have when serialized (excluding padding).
+ * \remarks Tag formats which can not be serialized in memory are assumed to keep their current size.
+ */
+static std::uint64_t requiredTagSize(Tag *tag, ContainerFormat containerFormat, Diagnostics &diag)
+{
+    switch (tag->type()) {
+    case TagType::Id3v1Tag:
+        return 128;
+    case TagType::Id3v2Tag:
+        return static_cast<Id3v2Tag *>(tag)->prepareMaking(diag).requiredSize();
+    case TagType::MatroskaTag:
+        return static_cast<MatroskaTag *>(tag)->prepareMaking(diag).requiredSize();
+    case TagType::Mp4Tag:
+        return static_cast<Mp4Tag *>(tag)->prepareMaking(diag).requiredSize();
+    case TagType::VorbisComment:
+    case TagType::OggVorbisComment: {
+        auto buffer = std::stringstream(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+        static_cast<VorbisComment *>(tag)->make(buffer,
+            containerFormat == ContainerFormat::Flac ? VorbisCommentFlags::NoSignature | VorbisCommentFlags::NoFramingByte | VorbisCommentFlags::NoCovers
+                                                     : VorbisCommentFlags::None,
+            diag);
+        return static_cast<std::uint64_t>(buffer.tellp());
+    }
+    default:
+        return tag->size();
+    }
+}
+
+/*!
+ * \brief Returns the size the tags of the specified \a fileInfo currently occupy within the file.
+ * \remarks Padding and ID3v1 tags are not taken into account. Tags which have not been written yet have a size of zero.
+ */
+std::uint64_t currentTagSize(const MediaFileInfo &fileInfo)
+{
+    auto size = std::uint64_t();
+    auto tags = std::vector<Tag *>();
+    fileInfo.tags(tags);
+    for (const auto *const tag : tags) {
+        switch (tag->type()) {
+        case TagType::Id3v1Tag:
+            break;
+        case TagType::Id3v2Tag:
+            size += tag->size() - std::min<std::uint64_t>(static_cast<const Id3v2Tag *>(tag)->paddingSize(), tag->size());
+            break;
+        default:
+            size += tag->size();
+        }
+    }
+    return size;
+}
+
+/*!
+ * \brief Predicts how the changes made to the specified \a fileInfo would be applied without actually applying them.
+ * \remarks
+ * - The tags are serialized in memory to determine their new size. The file itself is not altered.
+ * - Altering attachments is assumed to require a full rewrite.
+ * \throws Throws TagParser::Failure or a derived exception when a tag can not be serialized.
+ */
+RewritePlan planRewrite(MediaFileInfo &fileInfo, bool altersAttachments, Diagnostics &diag)
+{
+    auto plan = RewritePlan();
+    plan.fileSize = fileInfo.size();
+    plan.currentPadding = fileInfo.paddingSize();
+    plan.currentTagSize = currentTagSize(fileInfo);
+
+    // determine the new size of the tags; ID3v1 tags are always written at the end and don't use padding
+    const auto containerFormat = fileInfo.containerFormat();
+    auto id3v1Size = std::uint64_t();
+    auto tags = std::vector<Tag *>();
+    fileInfo.tags(tags);
+    for (auto *const tag : tags) {
+        const auto tagSize = requiredTagSize(tag, containerFormat, diag);
+        if (tag->type() == TagType::Id3v1Tag) {
+            id3v1Size += tagSize;
+            continue;
+        }
+        plan.newTagSize += tagSize;
+    }
+
+    // determine whether the entire file needs to be rewritten
+    const auto *const container = fileInfo.container();
+    const auto currentTagPosition = container ? container->determineTagPosition(diag) : ElementPosition::Keep;
+    const auto currentIndexPosition = container ? container->determineIndexPosition(diag) : ElementPosition::Keep;
+    const auto positionMismatches = [](bool force, ElementPosition preferred, ElementPosition current) {
+        return force && preferred != ElementPosition::Keep && current != ElementPosition::Keep && preferred != current;
+    };
+    const auto availableSize = plan.currentTagSize + plan.currentPadding;
+    if (fileInfo.isForcingRewrite()) {
+        plan.rewriteReason = "a rewrite is forced";
+    } else if (!fileInfo.saveFilePath().empty()) {
+        plan.rewriteReason = "the changes are saved to a different file";
+    } else if (containerFormat == ContainerFormat::Ogg) {
+        plan.rewriteReason = "Ogg files are always rewritten";
+    } else if (altersAttachments) {
+        plan.rewriteReason = "attachments are altered";
+    } else if (positionMismatches(fileInfo.forceTagPosition(), fileInfo.tagPosition(), currentTagPosition)) {
+        plan.rewriteReason = "the tag position is forced";
+    } else if (positionMismatches(fileInfo.forceIndexPosition(), fileInfo.indexPosition(), currentIndexPosition)) {
+        plan.rewriteReason = "the index position is forced";
+    } else if (currentTagPosition == ElementPosition::AfterData) {
+        // tags at the end of the file can grow without moving the media data
+        plan.newPadding = plan.newTagSize <= availableSize ? availableSize - plan.newTagSize : 0;
+    } else if (plan.newTagSize > availableSize) {
+        plan.rewriteReason = "the padding is insufficient";
+    } else if ((plan.newPadding = availableSize - plan.newTagSize) < fileInfo.minPadding()) {
+        plan.rewriteReason = "the remaining padding would fall below the minimum padding";
+    } else if (plan.newPadding > fileInfo.maxPadding()) {
+        plan.rewriteReason = "the remaining padding would exceed the maximum padding";
+    }
+
+    // estimate the number of bytes to be written
+    if (plan.isRewrite()) {
+        plan.newPadding = std::max(fileInfo.minPadding(), std::min(fileInfo.preferredPadding(), fileInfo.maxPadding()));
+        plan.bytesToWrite = plan.fileSize - std::min(plan.fileSize, availableSize) + plan.newTagSize + plan.newPadding;
+    } else {
+        plan.bytesToWrite = plan.newTagSize + plan.newPadding;
+    }
+    plan.bytesToWrite += id3v1Size;
+    return plan;
+}
+
+/*!
+ * \brief Prints the specified \a plan for a single file.
+ */
+void printRewritePlan(std::ostream &out, const RewritePlan &plan)
+{
+    if (plan.isRewrite()) {
+        out << " - Plan: The entire file would be rewritten because " << plan.rewriteReason << ".\n";
+    } else {
+        out << " - Plan: The changes would be applied in-place.\n";
+    }
+    out << "   Tag size: " << dataSizeToString(plan.currentTagSize, true) << " -> " << dataSizeToString(plan.newTagSize, true) << '\n';
+    out << "   Padding: " << dataSizeToString(plan.currentPadding, true) << " -> " << dataSizeToString(plan.newPadding, true);
+    if (!plan.isRewrite() && plan.newPadding < plan.currentPadding) {
+        out << " (" << dataSizeToString(plan.currentPadding - plan.newPadding, true) << " consumed)";
+    }
+    out << "\n   Bytes to be written: " << dataSizeToString(plan.bytesToWrite, true) << '\n';
+}
+
+/*!
+ * \brief Prints the specified \a totals of all files.
+ */
+void printRewritePlanTotals(std::ostream &out, const RewritePlanTotals &totals)
+{
+    out << "Plan for all files:\n";
+    out << " - Files changed in-place: " << totals.inPlaceCount << '\n';
+    out << " - Files rewritten entirely: " << totals.rewriteCount << " (" << dataSizeToString(totals.bytesToRewrite, true) << ")\n";
+    out << " - Bytes to be written: " << dataSizeToString(totals.bytesToWrite, true) << '\n';
+}
+
+} // namespace Cli
@@ -0,0 +1,53 @@
+#ifndef CLI_REWRITE_PLAN
+#define CLI_REWRITE_PLAN
+
+#include <tagparser/diagnostics.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace TagParser {
+class MediaFileInfo;
+}
+
+namespace Cli {
+
+struct RewritePlan {
+    bool isRewrite() const;
+
+    std::uint64_t fileSize = 0;
+    std::uint64_t currentTagSize = 0;
+    std::uint64_t newTagSize = 0;
+    std::uint64_t currentPadding = 0;
+    std::uint64_t newPadding = 0;
+    std::uint64_t bytesToWrite = 0;
+    std::string_view rewriteReason;
+};
+
+/*!
+ * \brief Returns whether the entire file would be rewritten.
+ */
+inline bool RewritePlan::isRewrite() const
+{
+    return !rewriteReason.empty();
+}
+
+struct RewritePlanTotals {
+    void add(const RewritePlan &plan);
+
+    std::size_t inPlaceCount = 0;
+    std::size_t rewriteCount = 0;
+    std::uint64_t bytesToWrite = 0;
+    std::uint64_t bytesToRewrite = 0;
+};
+
+std::uint64_t currentTagSize(const TagParser::MediaFileInfo &fileInfo);
+RewritePlan planRewrite(TagParser::MediaFileInfo &fileInfo, bool altersAttachments, TagParser::Diagnostics &diag);
+void printRewritePlan(std::ostream &out, const RewritePlan &plan);
+void printRewritePlanTotals(std::ostream &out, const RewritePlanTotals &totals);
+
+} // namespace Cli
+
+#endif // CLI_REWRITE_PLAN
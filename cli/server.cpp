@@ -0,0 +1,1103 @@
+#include "./server.h"
+#include "./helper.h"
+#include "./mainfeatures.h"
+
+#include "resources/config.h"
+
+#include <tagparser/diagnostics.h>
+
+#include <c++utilities/application/argumentparser.h>
+#include <c++utilities/conversion/binaryconversion.h>
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/ansiescapecodes.h>
+
+#ifdef TAGEDITOR_JSON_EXPORT
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#endif
+
+#ifdef PLATFORM_UNIX
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+using namespace TagParser;
+
+namespace Cli {
+
+#if defined(PLATFORM_UNIX) && defined(TAGEDITOR_JSON_EXPORT)
+
+/// \cond
+namespace {
+
+constexpr auto maxMessageSize = std::uint32_t(64 * 1024 * 1024);
+int signalPipe[2] = { -1, -1 };
+int diagRecordFd = -1;
+
+std::system_error systemError(const char *what)
+{
+    return std::system_error(errno, std::generic_category(), what);
+}
+
+void handleSignal(int signal)
+{
+    const auto savedErrno = errno;
+    const auto signalNumber = static_cast<char>(signal);
+    [[maybe_unused]] const auto written = ::write(signalPipe[1], &signalNumber, 1);
+    errno = savedErrno;
+}
+
+void makeNonBlocking(int fd)
+{
+    if (::fcntl(fd, F_SETFD, FD_CLOEXEC) || ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK)) {
+        throw systemError("unable to configure file descriptor");
+    }
+}
+
+bool readAll(int fd, char *buffer, std::size_t size)
+{
+    while (size) {
+        const auto bytesRead = ::read(fd, buffer, size);
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead <= 0) {
+            return false;
+        }
+        buffer += bytesRead;
+        size -= static_cast<std::size_t>(bytesRead);
+    }
+    return true;
+}
+
+bool writeAll(int fd, std::string_view data)
+{
+    while (!data.empty()) {
+        const auto written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+}
+
+/*!
+ * \brief Creates an anonymous temporary file to capture the output of a request.
+ */
+int createTemporaryFile()
+{
+    auto path = (std::filesystem::temp_directory_path() / PROJECT_NAME "-serve-XXXXXX").string();
+    const auto fd = ::mkstemp(path.data());
+    if (fd < 0) {
+        throw systemError("unable to create temporary file");
+    }
+    ::unlink(path.data());
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+std::string readTemporaryFile(int fd)
+{
+    auto contents = std::string();
+    struct stat stats = {};
+    if (::fstat(fd, &stats) || ::lseek(fd, 0, SEEK_SET) < 0) {
+        return contents;
+    }
+    contents.resize(static_cast<std::size_t>(stats.st_size));
+    auto size = std::size_t();
+    while (size < contents.size()) {
+        const auto bytesRead = ::read(fd, contents.data() + size, contents.size() - size);
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead <= 0) {
+            break;
+        }
+        size += static_cast<std::size_t>(bytesRead);
+    }
+    contents.resize(size);
+    return contents;
+}
+
+/*!
+ * \brief Appends the specified \a data prefixed with its size to \a buffer.
+ */
+void appendSized(std::string &buffer, std::string_view data)
+{
+    char size[4];
+    LE::getBytes(static_cast<std::uint32_t>(data.size()), size);
+    buffer.append(size, sizeof(size));
+    buffer += data;
+}
+
+/*!
+ * \brief Removes data prefixed with its size (as appended via appendSized()) from the front of \a buffer and assigns it to \a data.
+ * \returns Returns whether \a buffer contained the data completely.
+ */
+bool takeSized(std::string_view &buffer, std::string_view &data)
+{
+    if (buffer.size() < 4) {
+        return false;
+    }
+    const auto size = LE::toUInt32(buffer.data());
+    if (buffer.size() - 4 < size) {
+        return false;
+    }
+    data = buffer.substr(4, size);
+    buffer.remove_prefix(4 + size);
+    return true;
+}
+
+/*!
+ * \brief Appends the specified \a diag to the file the diagnostic messages of the current request are recorded in.
+ * \remarks Each message is stored as level (one byte) followed by context and message (each prefixed with its size).
+ */
+void recordDiagMessages(const Diagnostics &diag)
+{
+    auto record = std::string();
+    for (const auto &message : diag) {
+        record += static_cast<char>(message.level());
+        appendSized(record, message.context());
+        appendSized(record, message.message());
+    }
+    writeAll(diagRecordFd, record);
+}
+
+bool isValidUtf8(std::string_view data)
+{
+    for (auto i = data.begin(), end = data.end(); i != end;) {
+        const auto c = static_cast<unsigned char>(*i++);
+        const auto continuationBytes = c < 0x80 ? 0 : (c >> 5) == 0x6 ? 1 : (c >> 4) == 0xE ? 2 : (c >> 3) == 0x1E ? 3 : -1;
+        if (continuationBytes < 0 || end - i < continuationBytes) {
+            return false;
+        }
+        for (auto j = 0; j != continuationBytes; ++j) {
+            if ((static_cast<unsigned char>(*i++) >> 6) != 0x2) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+using JsonWriter = RAPIDJSON_NAMESPACE::Writer<RAPIDJSON_NAMESPACE::StringBuffer>;
+
+void writeOutput(JsonWriter &writer, std::string_view key, std::string_view output)
+{
+    if (isValidUtf8(output)) {
+        writer.Key(key.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(key.size()));
+        writer.String(output.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(output.size()));
+        return;
+    }
+    const auto base64Key = argsToString(key, "Base64");
+    const auto base64 = encodeBase64(reinterpret_cast<const std::uint8_t *>(output.data()), static_cast<std::uint32_t>(output.size()));
+    writer.Key(base64Key.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(base64Key.size()));
+    writer.String(base64.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(base64.size()));
+}
+
+void writeDiagMessages(JsonWriter &writer, std::string_view records)
+{
+    writer.Key("diagnostics");
+    writer.StartArray();
+    while (!records.empty()) {
+        const auto level = static_cast<DiagLevel>(records.front());
+        auto context = std::string_view(), message = std::string_view();
+        records.remove_prefix(1);
+        if (!takeSized(records, context) || !takeSized(records, message)) {
+            break;
+        }
+        writer.StartObject();
+        writer.Key("level");
+        writer.String(DiagMessage::levelName(level));
+        writeOutput(writer, "context", context);
+        writeOutput(writer, "message", message);
+        writer.EndObject();
+    }
+    writer.EndArray();
+}
+
+struct Connection {
+    int fd = -1;
+    std::string input;
+    std::string output;
+    std::size_t pendingRequests = 0;
+    bool readClosed = false;
+};
+
+struct Request {
+    std::uint64_t connectionId = 0;
+    std::string id = "null"; /**< the ID specified by the client as serialized JSON value */
+    std::string operation;
+    std::vector<std::string> args;
+    std::string workingDirectory;
+};
+
+struct Job {
+    Request request;
+    int outputFd = -1;
+    int errorFd = -1;
+    int diagFd = -1;
+
+    void close();
+};
+
+void Job::close()
+{
+    for (auto *const fd : { &outputFd, &errorFd, &diagFd }) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+struct Worker {
+    pid_t pid = -1;
+    int fd = -1; /**< the server's end of the socket pair connected to the worker */
+    std::optional<Job> job; /**< the job the worker is currently processing */
+};
+
+/*!
+ * \brief Passes the specified \a job to the worker connected via \a fd.
+ * \remarks The request is sent as its size followed by the operation, the working directory and the arguments (each prefixed with its
+ *          size). The file descriptors to capture the output and to record diagnostic messages are passed along with the size.
+ */
+bool sendJob(int fd, const Job &job)
+{
+    auto body = std::string();
+    appendSized(body, job.request.operation);
+    appendSized(body, job.request.workingDirectory);
+    for (const auto &arg : job.request.args) {
+        appendSized(body, arg);
+    }
+    char size[4];
+    LE::getBytes(static_cast<std::uint32_t>(body.size()), size);
+    const int fds[] = { job.outputFd, job.errorFd, job.diagFd };
+    char control[CMSG_SPACE(sizeof(fds))] = {};
+    auto data = iovec{ size, sizeof(size) };
+    auto message = msghdr();
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    auto *const header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(fds));
+    std::memcpy(CMSG_DATA(header), fds, sizeof(fds));
+    auto sent = ssize_t();
+    while ((sent = ::sendmsg(fd, &message, 0)) < 0 && errno == EINTR) {
+    }
+    return sent >= 0 && writeAll(fd, std::string_view(size + sent, sizeof(size) - static_cast<std::size_t>(sent))) && writeAll(fd, body);
+}
+
+/*!
+ * \brief Receives a job sent via sendJob() from the server connected via \a fd.
+ * \returns Returns whether a job has been received; returns false when the server has closed the connection.
+ */
+bool receiveJob(int fd, Job &job)
+{
+    char size[4];
+    int fds[] = { -1, -1, -1 };
+    char control[CMSG_SPACE(sizeof(fds))] = {};
+    auto data = iovec{ size, sizeof(size) };
+    auto message = msghdr();
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    auto received = ssize_t();
+    while ((received = ::recvmsg(fd, &message, 0)) < 0 && errno == EINTR) {
+    }
+    if (received <= 0) {
+        return false;
+    }
+    for (auto *header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS && header->cmsg_len == CMSG_LEN(sizeof(fds))) {
+            std::memcpy(fds, CMSG_DATA(header), sizeof(fds));
+        }
+    }
+    job.outputFd = fds[0];
+    job.errorFd = fds[1];
+    job.diagFd = fds[2];
+    if (!readAll(fd, size + received, sizeof(size) - static_cast<std::size_t>(received))) {
+        return false;
+    }
+    auto body = std::string(LE::toUInt32(size), '\0');
+    if (!readAll(fd, body.data(), body.size())) {
+        return false;
+    }
+    auto remainingBody = std::string_view(body);
+    auto operation = std::string_view(), workingDirectory = std::string_view(), arg = std::string_view();
+    if (!takeSized(remainingBody, operation) || !takeSized(remainingBody, workingDirectory)) {
+        return false;
+    }
+    job.request.operation = operation;
+    job.request.workingDirectory = workingDirectory;
+    while (takeSized(remainingBody, arg)) {
+        job.request.args.emplace_back(arg);
+    }
+    return job.outputFd >= 0 && job.errorFd >= 0 && job.diagFd >= 0;
+}
+
+class RequestServer {
+public:
+    explicit RequestServer(ArgumentParser &parser, std::string_view socketPath, std::size_t maxJobs);
+    ~RequestServer();
+    RequestServer(const RequestServer &) = delete;
+    RequestServer &operator=(const RequestServer &) = delete;
+
+    void run();
+
+private:
+    bool isDone() const;
+    void acceptConnections();
+    bool readRequests(std::uint64_t connectionId, Connection &connection);
+    bool writeResponses(Connection &connection);
+    void handleRequest(std::uint64_t connectionId, Connection &connection, std::string_view message);
+    void handleSignals();
+    void stop();
+    void startJobs();
+    void startWorker(Worker &worker);
+    [[noreturn]] void runWorker(int fd);
+    int runJob(Job &job);
+    void readExitCode(Worker &worker);
+    void finishWorker(Worker &worker, int status);
+    void finishJob(Job &job, std::optional<int> exitCode, int signal);
+    static void respond(Connection &connection, const RAPIDJSON_NAMESPACE::StringBuffer &response);
+    static void respondWithError(Connection &connection, const std::string &id, std::string_view error);
+
+    ArgumentParser &m_parser;
+    std::string m_socketPath;
+    std::size_t m_maxJobs;
+    int m_listener;
+    bool m_bound;
+    bool m_stopping;
+    std::uint64_t m_nextConnectionId;
+    std::unordered_map<std::uint64_t, Connection> m_connections;
+    std::deque<Job> m_queuedJobs;
+    std::vector<Worker> m_workers;
+    std::string m_initialDirectory;
+};
+
+/*!
+ * \brief Binds the socket at \a socketPath and registers the signal handlers the server relies on.
+ * \remarks A stale socket left behind by an instance which has not been stopped cleanly is removed.
+ */
+RequestServer::RequestServer(ArgumentParser &parser, std::string_view socketPath, std::size_t maxJobs)
+    : m_parser(parser)
+    , m_socketPath(socketPath)
+    , m_maxJobs(maxJobs ? maxJobs : 1)
+    , m_listener(-1)
+    , m_bound(false)
+    , m_stopping(false)
+    , m_nextConnectionId(0)
+    , m_workers(m_maxJobs)
+{
+    auto address = sockaddr_un();
+    if (m_socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("the socket path is too long");
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, m_socketPath.data(), m_socketPath.size());
+    auto error = std::error_code();
+    if (std::filesystem::is_socket(m_socketPath, error)) {
+        const auto probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        const auto inUse = probe >= 0 && !::connect(probe, reinterpret_cast<const sockaddr *>(&address), sizeof(address));
+        if (probe >= 0) {
+            ::close(probe);
+        }
+        if (inUse) {
+            throw std::runtime_error("the socket is already used by another instance");
+        }
+        std::filesystem::remove(m_socketPath, error);
+    }
+
+    if ((m_listener = ::socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        throw systemError("unable to create socket");
+    }
+    makeNonBlocking(m_listener);
+    if (::bind(m_listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address))) {
+        throw systemError("unable to bind socket");
+    }
+    m_bound = true;
+    if (::listen(m_listener, SOMAXCONN)) {
+        throw systemError("unable to listen on socket");
+    }
+
+    // handle signals within the event loop
+    if (::pipe(signalPipe)) {
+        throw systemError("unable to create pipe");
+    }
+    makeNonBlocking(signalPipe[0]);
+    makeNonBlocking(signalPipe[1]);
+    struct sigaction action = {};
+    action.sa_handler = &handleSignal;
+    action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigemptyset(&action.sa_mask);
+    for (const auto signal : { SIGCHLD, SIGINT, SIGTERM }) {
+        ::sigaction(signal, &action, nullptr);
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // requests without working directory are processed within the working directory of the server
+    m_initialDirectory = std::filesystem::current_path(error).string();
+}
+
+/*!
+ * \brief Stops all workers, closes all connections and removes the socket.
+ */
+RequestServer::~RequestServer()
+{
+    for (const auto signal : { SIGCHLD, SIGINT, SIGTERM, SIGPIPE }) {
+        std::signal(signal, SIG_DFL);
+    }
+    for (auto &worker : m_workers) {
+        if (worker.pid < 0) {
+            continue;
+        }
+        // idle workers exit on their own once the connection is closed
+        ::close(worker.fd);
+        if (worker.job) {
+            ::kill(worker.pid, SIGTERM);
+            worker.job->close();
+        }
+        while (::waitpid(worker.pid, nullptr, 0) < 0 && errno == EINTR) {
+        }
+    }
+    for (auto &job : m_queuedJobs) {
+        job.close();
+    }
+    for (const auto &[id, connection] : m_connections) {
+        ::close(connection.fd);
+    }
+    for (auto &fd : signalPipe) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    if (m_listener >= 0) {
+        ::close(m_listener);
+    }
+    if (m_bound) {
+        ::unlink(m_socketPath.data());
+    }
+}
+
+/*!
+ * \brief Returns whether the server has been stopped and all responses have been sent.
+ */
+bool RequestServer::isDone() const
+{
+    return m_stopping && std::none_of(m_workers.cbegin(), m_workers.cend(), [](const auto &worker) { return worker.job.has_value(); })
+        && std::all_of(m_connections.cbegin(), m_connections.cend(), [](const auto &connection) { return connection.second.output.empty(); });
+}
+
+/*!
+ * \brief Runs the event loop until SIGINT/SIGTERM or a "shutdown" request has been received.
+ */
+void RequestServer::run()
+{
+    auto pollFds = std::vector<pollfd>();
+    auto connectionIds = std::vector<std::uint64_t>();
+    auto busyWorkers = std::vector<std::pair<std::size_t, pid_t>>();
+    while (!isDone()) {
+        const auto listening = !m_stopping;
+        pollFds.clear();
+        connectionIds.clear();
+        busyWorkers.clear();
+        pollFds.emplace_back(pollfd{ signalPipe[0], POLLIN, 0 });
+        if (listening) {
+            pollFds.emplace_back(pollfd{ m_listener, POLLIN, 0 });
+        }
+        for (const auto &[id, connection] : m_connections) {
+            auto events = short();
+            if (!connection.readClosed && listening) {
+                events |= POLLIN;
+            }
+            if (!connection.output.empty()) {
+                events |= POLLOUT;
+            }
+            pollFds.emplace_back(pollfd{ connection.fd, events, 0 });
+            connectionIds.emplace_back(id);
+        }
+        for (auto i = std::size_t(); i != m_workers.size(); ++i) {
+            if (const auto &worker = m_workers[i]; worker.job) {
+                pollFds.emplace_back(pollfd{ worker.fd, POLLIN, 0 });
+                busyWorkers.emplace_back(i, worker.pid);
+            }
+        }
+        if (::poll(pollFds.data(), static_cast<nfds_t>(pollFds.size()), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw systemError("unable to poll");
+        }
+
+        auto pollFd = pollFds.cbegin();
+        if ((pollFd++)->revents) {
+            handleSignals();
+        }
+        if (listening && (pollFd++)->revents) {
+            acceptConnections();
+        }
+        for (const auto connectionId : connectionIds) {
+            const auto revents = (pollFd++)->revents;
+            const auto connection = m_connections.find(connectionId);
+            if (!revents || connection == m_connections.end()) {
+                continue;
+            }
+            auto ok = true;
+            if ((revents & (POLLIN | POLLHUP | POLLERR)) && !connection->second.readClosed) {
+                ok = readRequests(connectionId, connection->second);
+            } else if (revents & (POLLHUP | POLLERR)) {
+                ok = false;
+            }
+            if (ok && (revents & POLLOUT)) {
+                ok = writeResponses(connection->second);
+            }
+            const auto &state = connection->second;
+            if (!ok || (state.readClosed && !state.pendingRequests && state.output.empty())) {
+                ::close(state.fd);
+                m_connections.erase(connection);
+            }
+        }
+        for (const auto &[index, pid] : busyWorkers) {
+            // skip workers which have exited in the meantime (and have been finished when handling signals)
+            auto &worker = m_workers[index];
+            if ((pollFd++)->revents && worker.pid == pid && worker.job) {
+                readExitCode(worker);
+            }
+        }
+        startJobs();
+    }
+}
+
+void RequestServer::acceptConnections()
+{
+    for (;;) {
+        const auto fd = ::accept(m_listener, nullptr, nullptr);
+        if (fd >= 0) {
+            makeNonBlocking(fd);
+            m_connections[m_nextConnectionId++].fd = fd;
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNABORTED) {
+            std::cerr << Phrases::Error << "Unable to accept connection: " << std::strerror(errno) << Phrases::EndFlush;
+        }
+        return;
+    }
+}
+
+/*!
+ * \brief Reads available data from the specified \a connection and handles all complete requests.
+ * \returns Returns whether the connection should be kept.
+ */
+bool RequestServer::readRequests(std::uint64_t connectionId, Connection &connection)
+{
+    char buffer[64 * 1024];
+    for (;;) {
+        const auto bytesRead = ::read(connection.fd, buffer, sizeof(buffer));
+        if (bytesRead > 0) {
+            connection.input.append(buffer, static_cast<std::size_t>(bytesRead));
+            continue;
+        }
+        if (!bytesRead) {
+            connection.readClosed = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        return false;
+    }
+
+    // handle each request (prefixed with its size as 32-bit big-endian integer)
+    auto offset = std::size_t();
+    while (connection.input.size() - offset >= 4) {
+        const auto size = BE::toUInt32(connection.input.data() + offset);
+        if (size > maxMessageSize) {
+            return false;
+        }
+        if (connection.input.size() - offset - 4 < size) {
+            break;
+        }
+        handleRequest(connectionId, connection, std::string_view(connection.input.data() + offset + 4, size));
+        offset += 4 + size;
+    }
+    connection.input.erase(0, offset);
+    return true;
+}
+
+/*!
+ * \brief Writes as much of the pending responses to the specified \a connection as possible without blocking.
+ * \returns Returns whether the connection should be kept.
+ */
+bool RequestServer::writeResponses(Connection &connection)
+{
+    auto offset = std::size_t();
+    while (offset < connection.output.size()) {
+        const auto written = ::write(connection.fd, connection.output.data() + offset, connection.output.size() - offset);
+        if (written >= 0) {
+            offset += static_cast<std::size_t>(written);
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        return false;
+    }
+    connection.output.erase(0, offset);
+    return true;
+}
+
+/*!
+ * \brief Parses the request \a message and queues it (or responds immediately if it is invalid).
+ */
+void RequestServer::handleRequest(std::uint64_t connectionId, Connection &connection, std::string_view message)
+{
+    auto document = RAPIDJSON_NAMESPACE::Document();
+    auto request = Request();
+    request.connectionId = connectionId;
+    document.Parse(message.data(), message.size());
+    if (document.HasParseError()) {
+        respondWithError(connection, request.id,
+            argsToString("unable to parse request: ", RAPIDJSON_NAMESPACE::GetParseError_En(document.GetParseError()), " (at offset ",
+                document.GetErrorOffset(), ')'));
+        return;
+    }
+    if (!document.IsObject()) {
+        respondWithError(connection, request.id, "the request is not a JSON object");
+        return;
+    }
+    if (const auto id = document.FindMember("id"); id != document.MemberEnd()) {
+        auto buffer = RAPIDJSON_NAMESPACE::StringBuffer();
+        auto writer = JsonWriter(buffer);
+        id->value.Accept(writer);
+        request.id.assign(buffer.GetString(), buffer.GetSize());
+    }
+
+    // determine operation
+    const auto operation = document.FindMember("operation");
+    if (operation == document.MemberEnd() || !operation->value.IsString()) {
+        respondWithError(connection, request.id, "no operation has been specified");
+        return;
+    }
+    request.operation.assign(operation->value.GetString(), operation->value.GetStringLength());
+    if (m_stopping) {
+        respondWithError(connection, request.id, "the server is shutting down");
+        return;
+    }
+    if (request.operation == "shutdown") {
+        auto buffer = RAPIDJSON_NAMESPACE::StringBuffer();
+        auto writer = JsonWriter(buffer);
+        writer.StartObject();
+        writer.Key("id");
+        writer.RawValue(request.id.data(), request.id.size(), RAPIDJSON_NAMESPACE::kObjectType);
+        writer.Key("exitCode");
+        writer.Int(EXIT_SUCCESS);
+        writer.EndObject();
+        respond(connection, buffer);
+        stop();
+        return;
+    }
+    if (request.operation != "info" && request.operation != "get" && request.operation != "set" && request.operation != "extract") {
+        respondWithError(connection, request.id, argsToString("the operation \"", request.operation, "\" is not supported"));
+        return;
+    }
+
+    // determine arguments and working directory
+    if (const auto args = document.FindMember("args"); args != document.MemberEnd()) {
+        if (!args->value.IsArray()) {
+            respondWithError(connection, request.id, "the arguments are not an array");
+            return;
+        }
+        for (const auto &arg : args->value.GetArray()) {
+            if (!arg.IsString()) {
+                respondWithError(connection, request.id, "an argument is not a string");
+                return;
+            }
+            request.args.emplace_back(arg.GetString(), arg.GetStringLength());
+        }
+    }
+    if (const auto cwd = document.FindMember("cwd"); cwd != document.MemberEnd()) {
+        if (!cwd->value.IsString()) {
+            respondWithError(connection, request.id, "the working directory is not a string");
+            return;
+        }
+        request.workingDirectory.assign(cwd->value.GetString(), cwd->value.GetStringLength());
+    }
+
+    ++connection.pendingRequests;
+    m_queuedJobs.emplace_back().request = std::move(request);
+}
+
+/*!
+ * \brief Handles signals received since the last call and finishes all workers which have exited.
+ */
+void RequestServer::handleSignals()
+{
+    char signals[64];
+    for (auto bytesRead = ::read(signalPipe[0], signals, sizeof(signals)); bytesRead > 0;
+         bytesRead = ::read(signalPipe[0], signals, sizeof(signals))) {
+        for (auto i = decltype(bytesRead)(); i != bytesRead; ++i) {
+            if (signals[i] == SIGINT || signals[i] == SIGTERM) {
+                stop();
+            }
+        }
+    }
+    auto status = int();
+    for (auto pid = ::waitpid(-1, &status, WNOHANG); pid > 0; pid = ::waitpid(-1, &status, WNOHANG)) {
+        const auto worker = std::find_if(m_workers.begin(), m_workers.end(), [pid](const auto &worker) { return worker.pid == pid; });
+        if (worker != m_workers.end()) {
+            finishWorker(*worker, status);
+        }
+    }
+}
+
+/*!
+ * \brief Stops accepting requests; requests which have not been started yet are answered with an error.
+ */
+void RequestServer::stop()
+{
+    m_stopping = true;
+    for (auto &job : m_queuedJobs) {
+        if (const auto connection = m_connections.find(job.request.connectionId); connection != m_connections.end()) {
+            --connection->second.pendingRequests;
+            respondWithError(connection->second, job.request.id, "the server is shutting down");
+        }
+    }
+    m_queuedJobs.clear();
+}
+
+/*!
+ * \brief Passes queued jobs to idle workers; workers are started on demand.
+ */
+void RequestServer::startJobs()
+{
+    for (auto &worker : m_workers) {
+        if (m_queuedJobs.empty()) {
+            break;
+        }
+        if (worker.job) {
+            continue;
+        }
+        auto job = std::move(m_queuedJobs.front());
+        m_queuedJobs.pop_front();
+        try {
+            if (worker.pid < 0) {
+                startWorker(worker);
+            }
+            job.outputFd = createTemporaryFile();
+            job.errorFd = createTemporaryFile();
+            job.diagFd = createTemporaryFile();
+            if (!sendJob(worker.fd, job)) {
+                // ensure the worker is replaced (it is finished when handling SIGCHLD)
+                const auto error = systemError("unable to pass request to worker");
+                ::kill(worker.pid, SIGKILL);
+                throw error;
+            }
+        } catch (const std::system_error &e) {
+            job.close();
+            if (const auto connection = m_connections.find(job.request.connectionId); connection != m_connections.end()) {
+                --connection->second.pendingRequests;
+                respondWithError(connection->second, job.request.id, e.what());
+            }
+            continue;
+        }
+        worker.job.emplace(std::move(job));
+    }
+}
+
+/*!
+ * \brief Forks a new process for the specified \a worker.
+ */
+void RequestServer::startWorker(Worker &worker)
+{
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) {
+        throw systemError("unable to create socket pair");
+    }
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    std::cout.flush();
+    std::cerr.flush();
+    const auto pid = ::fork();
+    if (pid < 0) {
+        const auto error = systemError("unable to fork");
+        ::close(fds[0]);
+        ::close(fds[1]);
+        throw error;
+    }
+    if (!pid) {
+        ::close(fds[0]);
+        runWorker(fds[1]);
+    }
+    ::close(fds[1]);
+    worker.pid = pid;
+    worker.fd = fds[0];
+}
+
+/*!
+ * \brief Processes jobs received via \a fd within the forked worker process until the server closes the connection.
+ * \remarks The exit code of each job is sent back as 32-bit little-endian integer.
+ */
+void RequestServer::runWorker(int fd)
+{
+    // restore the default signal handling and release the resources of the server
+    for (const auto signal : { SIGCHLD, SIGINT, SIGTERM, SIGPIPE }) {
+        std::signal(signal, SIG_DFL);
+    }
+    ::close(signalPipe[0]);
+    ::close(signalPipe[1]);
+    ::close(m_listener);
+    for (const auto &[id, connection] : m_connections) {
+        ::close(connection.fd);
+    }
+    for (auto &worker : m_workers) {
+        if (worker.fd >= 0) {
+            ::close(worker.fd);
+        }
+        if (worker.job) {
+            worker.job->close();
+        }
+    }
+    for (auto &job : m_queuedJobs) {
+        job.close();
+    }
+
+    // process jobs keeping state such as cached files between them
+    diagMessageRecorder = &recordDiagMessages;
+    keepStateBetweenOperations(true);
+    for (auto job = Job(); receiveJob(fd, job); job = Job()) {
+        char exitCode[4];
+        LE::getBytes(static_cast<std::int32_t>(runJob(job)), exitCode);
+        job.close();
+        if (!writeAll(fd, std::string_view(exitCode, sizeof(exitCode)))) {
+            break;
+        }
+    }
+    keepStateBetweenOperations(false);
+    ::_exit(EXIT_SUCCESS);
+}
+
+/*!
+ * \brief Runs the specified \a job within the worker process as if the operation had been invoked via the command line.
+ * \returns Returns the exit code of the operation. If the operation exits the worker process (e.g. due to invalid arguments), the
+ *          exit status of the worker process is taken instead (see finishWorker()).
+ */
+int RequestServer::runJob(Job &job)
+{
+    // capture the output and record diagnostic messages
+    std::cout.clear();
+    std::cerr.clear();
+    if (::dup2(job.outputFd, STDOUT_FILENO) < 0 || ::dup2(job.errorFd, STDERR_FILENO) < 0) {
+        ::_exit(EXIT_FAILURE);
+    }
+    diagRecordFd = job.diagFd;
+    EscapeCodes::enabled = false;
+    const auto &workingDirectory = job.request.workingDirectory.empty() ? m_initialDirectory : job.request.workingDirectory;
+    if (!workingDirectory.empty() && ::chdir(workingDirectory.data())) {
+        std::cerr << Phrases::Error << "Unable to change the working directory to \"" << workingDirectory << "\": " << std::strerror(errno)
+                  << Phrases::EndFlush;
+        return EXIT_FAILURE;
+    }
+
+    // parse the arguments and ensure no further operation has been specified
+    auto argv = std::vector<const char *>();
+    argv.reserve(job.request.args.size() + 3);
+    argv.emplace_back(PROJECT_NAME);
+    argv.emplace_back(job.request.operation.data());
+    for (const auto &arg : job.request.args) {
+        argv.emplace_back(arg.data());
+    }
+    argv.emplace_back(nullptr);
+    m_parser.resetArgs();
+    m_parser.parseArgs(
+        static_cast<int>(argv.size() - 1), argv.data(), ParseArgumentBehavior::CheckConstraints | ParseArgumentBehavior::ExitOnFailure);
+    EscapeCodes::enabled = false;
+    for (const auto *const arg : m_parser.mainArguments()) {
+        if (arg->isPresent() && arg->denotesOperation() && job.request.operation != arg->name()) {
+            std::cerr << Phrases::Error << "The operation \"" << arg->name() << "\" can not be combined with \"" << job.request.operation
+                      << "\"." << Phrases::EndFlush;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // invoke the operation
+    exitCode = EXIT_SUCCESS;
+    m_parser.invokeCallbacks();
+    std::cout.flush();
+    std::cerr.flush();
+    return exitCode;
+}
+
+/*!
+ * \brief Reads the exit code of the job the specified \a worker has processed and finishes the job.
+ * \remarks If the worker has exited instead, the worker is finished.
+ */
+void RequestServer::readExitCode(Worker &worker)
+{
+    char exitCode[4];
+    if (readAll(worker.fd, exitCode, sizeof(exitCode))) {
+        finishJob(*worker.job, LE::toInt32(exitCode), 0);
+        worker.job.reset();
+        return;
+    }
+    auto status = int();
+    while (::waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    finishWorker(worker, status);
+}
+
+/*!
+ * \brief Releases the specified \a worker which has exited with the specified \a status and finishes the job it was processing.
+ */
+void RequestServer::finishWorker(Worker &worker, int status)
+{
+    if (worker.job) {
+        char exitCode[4];
+        if (::recv(worker.fd, exitCode, sizeof(exitCode), MSG_DONTWAIT) == sizeof(exitCode)) {
+            finishJob(*worker.job, LE::toInt32(exitCode), 0);
+        } else {
+            finishJob(*worker.job, WIFEXITED(status) ? std::make_optional(WEXITSTATUS(status)) : std::nullopt,
+                WIFSIGNALED(status) ? WTERMSIG(status) : 0);
+        }
+    }
+    ::close(worker.fd);
+    worker = Worker();
+}
+
+/*!
+ * \brief Sends the response for the specified \a job which has finished with the specified \a exitCode or \a signal.
+ */
+void RequestServer::finishJob(Job &job, std::optional<int> exitCode, int signal)
+{
+    if (const auto connection = m_connections.find(job.request.connectionId); connection != m_connections.end()) {
+        auto buffer = RAPIDJSON_NAMESPACE::StringBuffer();
+        auto writer = JsonWriter(buffer);
+        writer.StartObject();
+        writer.Key("id");
+        writer.RawValue(job.request.id.data(), job.request.id.size(), RAPIDJSON_NAMESPACE::kObjectType);
+        writer.Key("exitCode");
+        if (exitCode.has_value()) {
+            writer.Int(exitCode.value());
+        } else {
+            writer.Null();
+        }
+        if (signal) {
+            writer.Key("signal");
+            writer.Int(signal);
+        }
+        writeOutput(writer, "stdout", readTemporaryFile(job.outputFd));
+        writeOutput(writer, "stderr", readTemporaryFile(job.errorFd));
+        writeDiagMessages(writer, readTemporaryFile(job.diagFd));
+        writer.EndObject();
+        --connection->second.pendingRequests;
+        respond(connection->second, buffer);
+    }
+    job.close();
+}
+
+void RequestServer::respond(Connection &connection, const RAPIDJSON_NAMESPACE::StringBuffer &response)
+{
+    char size[4];
+    BE::getBytes(static_cast<std::uint32_t>(response.GetSize()), size);
+    connection.output.append(size, sizeof(size));
+    connection.output.append(response.GetString(), response.GetSize());
+}
+
+void RequestServer::respondWithError(Connection &connection, const std::string &id, std::string_view error)
+{
+    auto buffer = RAPIDJSON_NAMESPACE::StringBuffer();
+    auto writer = JsonWriter(buffer);
+    writer.StartObject();
+    writer.Key("id");
+    writer.RawValue(id.data(), id.size(), RAPIDJSON_NAMESPACE::kObjectType);
+    writer.Key("error");
+    writer.String(error.data(), static_cast<RAPIDJSON_NAMESPACE::SizeType>(error.size()));
+    writer.EndObject();
+    respond(connection, buffer);
+}
+
+} // namespace
+/// \endcond
+
+#endif
+
+/*!
+ * \brief Serves requests received via the Unix domain socket at \a socketPath until SIGINT/SIGTERM or a "shutdown" request is received.
+ *
+ * Each request is a JSON object prefixed with its size as 32-bit big-endian integer. It specifies the "operation" ("info", "get",
+ * "set" or "extract"), its "args" as they would be passed on the command line, optionally the working directory "cwd" and an "id"
+ * which is passed back as-is. The response is a JSON object prefixed the same way. It contains the "id", the "exitCode", the output
+ * as "stdout" and "stderr" (or "stdoutBase64"/"stderrBase64" if not valid UTF-8) and all "diagnostics" (as objects with "level",
+ * "context" and "message" whereas the latter two are also Base64-encoded as "contextBase64"/"messageBase64" if not valid UTF-8).
+ * Invalid requests are answered with an "error" instead.
+ *
+ * Requests are processed by up to \a maxJobs worker processes in parallel. The workers are forked from the server (so the argument
+ * parser and everything else initialized before is not set up again) and each of them processes many requests one after another.
+ * State is kept between the requests processed by a worker (see keepStateBetweenOperations()). A worker which exits while
+ * processing a request (e.g. due to invalid arguments) is replaced by a new one. Responses might be sent in a different order than
+ * the requests have been received.
+ *
+ * \throws Throws std::runtime_error or std::system_error when the socket can not be set up.
+ */
+void serveRequests(ArgumentParser &parser, std::string_view socketPath, std::size_t maxJobs)
+{
+#if defined(PLATFORM_UNIX) && defined(TAGEDITOR_JSON_EXPORT)
+    auto server = RequestServer(parser, socketPath, maxJobs);
+    server.run();
+#else
+    CPP_UTILITIES_UNUSED(parser);
+    CPP_UTILITIES_UNUSED(socketPath);
+    CPP_UTILITIES_UNUSED(maxJobs);
+#ifndef PLATFORM_UNIX
+    throw std::runtime_error("serving requests is only supported on Unix platforms");
+#else
+    throw std::runtime_error("support for JSON has been disabled at compile-time");
+#endif
+#endif
+}
+
+} // namespace Cli
@@ -0,0 +1,17 @@
+#ifndef CLI_SERVER
+#define CLI_SERVER
+
+#include <cstddef>
+#include <string_view>
+
+namespace CppUtilities {
+class ArgumentParser;
+}
+
+namespace Cli {
+
+void serveRequests(CppUtilities::ArgumentParser &parser, std::string_view socketPath, std::size_t maxJobs);
+
+} // namespace Cli
+
+#endif // CLI_SERVER
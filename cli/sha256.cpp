@@ -0,0 +1,153 @@
+#include "./sha256.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Cli {
+
+/// \cond
+constexpr std::uint32_t roundConstants[64] = { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3,
+    0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08, 0x2748774c,
+    0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb,
+    0xbef9a3f7, 0xc67178f2 };
+
+constexpr std::uint32_t rotateRight(std::uint32_t value, unsigned int bits)
+{
+    return (value >> bits) | (value << (32 - bits));
+}
+/// \endcond
+
+/*!
+ * \class Sha256
+ * \brief The Sha256 class computes SHA-256 digests (see FIPS 180-4).
+ *
+ * It is used to identify binary values (e.g. covers) by their contents so identical values are only stored once. Data can be
+ * passed in chunks via update(); finalize() returns the digest of all data passed so far.
+ */
+
+/*!
+ * \brief Constructs a new object for computing a digest.
+ */
+Sha256::Sha256()
+    : m_state{ 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 }
+    , m_block{}
+    , m_blockSize(0)
+    , m_totalSize(0)
+{
+}
+
+/*!
+ * \brief Adds the specified \a size bytes of \a data.
+ */
+void Sha256::update(const char *data, std::size_t size)
+{
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(data);
+    m_totalSize += size;
+    if (m_blockSize) {
+        const auto count = std::min(size, m_block.size() - m_blockSize);
+        std::memcpy(m_block.data() + m_blockSize, bytes, count);
+        m_blockSize += count;
+        bytes += count;
+        size -= count;
+        if (m_blockSize < m_block.size()) {
+            return;
+        }
+        processBlock(m_block.data());
+        m_blockSize = 0;
+    }
+    for (; size >= m_block.size(); bytes += m_block.size(), size -= m_block.size()) {
+        processBlock(bytes);
+    }
+    std::memcpy(m_block.data(), bytes, size);
+    m_blockSize = size;
+}
+
+/*!
+ * \brief Returns the digest of all data added so far.
+ * \remarks The object must not be used anymore afterwards.
+ */
+Sha256::Digest Sha256::finalize()
+{
+    const auto bitCount = m_totalSize * 8;
+    m_block[m_blockSize++] = 0x80;
+    if (m_blockSize > 56) {
+        std::memset(m_block.data() + m_blockSize, 0, m_block.size() - m_blockSize);
+        processBlock(m_block.data());
+        m_blockSize = 0;
+    }
+    std::memset(m_block.data() + m_blockSize, 0, 56 - m_blockSize);
+    for (auto i = 0; i != 8; ++i) {
+        m_block[56 + static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(bitCount >> (56 - i * 8));
+    }
+    processBlock(m_block.data());
+
+    auto digest = Digest();
+    for (auto i = std::size_t(); i != m_state.size(); ++i) {
+        for (auto j = std::size_t(); j != 4; ++j) {
+            digest[i * 4 + j] = static_cast<std::uint8_t>(m_state[i] >> (24 - j * 8));
+        }
+    }
+    return digest;
+}
+
+/*!
+ * \brief Returns the specified \a digest as lower-case hex string.
+ */
+std::string Sha256::toHex(const Digest &digest)
+{
+    constexpr auto hexDigits = std::string_view("0123456789abcdef");
+    auto hex = std::string();
+    hex.reserve(digest.size() * 2);
+    for (const auto byte : digest) {
+        hex += hexDigits[byte >> 4];
+        hex += hexDigits[byte & 0xF];
+    }
+    return hex;
+}
+
+/*!
+ * \brief Processes the 64-byte \a block.
+ */
+void Sha256::processBlock(const std::uint8_t *block)
+{
+    std::uint32_t words[64];
+    for (auto i = std::size_t(); i != 16; ++i) {
+        words[i] = (static_cast<std::uint32_t>(block[i * 4]) << 24) | (static_cast<std::uint32_t>(block[i * 4 + 1]) << 16)
+            | (static_cast<std::uint32_t>(block[i * 4 + 2]) << 8) | static_cast<std::uint32_t>(block[i * 4 + 3]);
+    }
+    for (auto i = std::size_t(16); i != 64; ++i) {
+        const auto s0 = rotateRight(words[i - 15], 7) ^ rotateRight(words[i - 15], 18) ^ (words[i - 15] >> 3);
+        const auto s1 = rotateRight(words[i - 2], 17) ^ rotateRight(words[i - 2], 19) ^ (words[i - 2] >> 10);
+        words[i] = words[i - 16] + s0 + words[i - 7] + s1;
+    }
+    auto a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3], e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+    for (auto i = std::size_t(); i != 64; ++i) {
+        const auto s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+        const auto choice = (e & f) ^ (~e & g);
+        const auto temp1 = h + s1 + choice + roundConstants[i] + words[i];
+        const auto s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+        const auto majority = (a & b) ^ (a & c) ^ (b & c);
+        const auto temp2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+    m_state[0] += a;
+    m_state[1] += b;
+    m_state[2] += c;
+    m_state[3] += d;
+    m_state[4] += e;
+    m_state[5] += f;
+    m_state[6] += g;
+    m_state[7] += h;
+}
+
+} // namespace Cli
@@ -0,0 +1,50 @@
+#ifndef CLI_SHA256
+#define CLI_SHA256
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Cli {
+
+class Sha256 {
+public:
+    using Digest = std::array<std::uint8_t, 32>;
+
+    Sha256();
+    void update(const char *data, std::size_t size);
+    void update(std::string_view data);
+    Digest finalize();
+
+    static std::string toHex(const Digest &digest);
+    static std::string hexDigest(std::string_view data);
+
+private:
+    void processBlock(const std::uint8_t *block);
+
+    std::array<std::uint32_t, 8> m_state;
+    std::array<std::uint8_t, 64> m_block;
+    std::size_t m_blockSize;
+    std::uint64_t m_totalSize;
+};
+
+inline void Sha256::update(std::string_view data)
+{
+    update(data.data(), data.size());
+}
+
+/*!
+ * \brief Returns the SHA-256 digest of the specified \a data as lower-case hex string.
+ */
+inline std::string Sha256::hexDigest(std::string_view data)
+{
+    auto sha256 = Sha256();
+    sha256.update(data);
+    return toHex(sha256.finalize());
+}
+
+} // namespace Cli
+
+#endif // CLI_SHA256
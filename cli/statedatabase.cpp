@@ -0,0 +1,523 @@
+#include "./statedatabase.h"
+#include "./journal.h"
+
+#include <c++utilities/application/argumentparser.h>
+#include <c++utilities/io/nativefilestream.h>
+#include <c++utilities/io/path.h>
+
+#ifdef PLATFORM_UNIX
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <c++utilities/conversion/stringconversion.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <ios>
+#ifndef PLATFORM_UNIX
+#include <random>
+#endif
+#include <stdexcept>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace Cli {
+
+/// \cond
+#ifdef PLATFORM_UNIX
+/*!
+ * \brief Creates a new file named \a path followed by a unique suffix and returns its file descriptor.
+ * \remarks The suffix is appended to \a path.
+ */
+static int createUniqueFile(std::string &path)
+{
+    path += ".XXXXXX";
+    const auto fd = ::mkstemp(path.data());
+    if (fd < 0) {
+        throw std::ios_base::failure("unable to create \"" + path + '\"', std::error_code(errno, std::generic_category()));
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+#else
+/*!
+ * \brief Returns \a path followed by a random suffix which does not exist yet.
+ */
+static std::string uniquePath(const std::string &path)
+{
+    auto random = std::random_device();
+    for (;;) {
+        auto candidate = path + '.' + numberToString(random(), 36);
+        if (auto error = std::error_code(); !std::filesystem::exists(makeNativePath(candidate), error) && !error) {
+            return candidate;
+        }
+    }
+}
+#endif
+/// \endcond
+
+/*!
+ * \brief Returns the device, inode, size, modification time and status change time of the file with the specified \a path.
+ * \remarks Only the size and the modification time are available on non-UNIX platforms; the other values are always zero.
+ */
+FileStamp FileStamp::read(std::string_view path, std::error_code &error)
+{
+    auto stamp = FileStamp();
+#ifdef PLATFORM_UNIX
+    struct stat st;
+    if (::stat(std::string(path).data(), &st)) {
+        error = std::error_code(errno, std::generic_category());
+        return stamp;
+    }
+    stamp.device = static_cast<std::uint64_t>(st.st_dev);
+    stamp.inode = static_cast<std::uint64_t>(st.st_ino);
+    stamp.size = static_cast<std::uint64_t>(st.st_size);
+#ifdef PLATFORM_LINUX
+    stamp.modificationTime = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    stamp.changeTime = static_cast<std::int64_t>(st.st_ctim.tv_sec) * 1000000000 + st.st_ctim.tv_nsec;
+#else
+    stamp.modificationTime = static_cast<std::int64_t>(st.st_mtime) * 1000000000;
+    stamp.changeTime = static_cast<std::int64_t>(st.st_ctime) * 1000000000;
+#endif
+#else
+    const auto nativePath = makeNativePath(path);
+    stamp.size = std::filesystem::file_size(nativePath, error);
+    if (!error) {
+        stamp.modificationTime = static_cast<std::int64_t>(std::filesystem::last_write_time(nativePath, error).time_since_epoch().count());
+    }
+#endif
+    return stamp;
+}
+
+/*!
+ * \class StateDatabase
+ * \brief The StateDatabase class stores the state of files and the result of processing them to skip unchanged files later.
+ *
+ * The database is a single file which is memory-mapped for reading. It consists of a header, a hash table with fixed-size
+ * entries and a data section containing the paths and results. The hash table uses open addressing (linear probing) and is
+ * at most half full so looking up a file only touches a few entries regardless of the number of files.
+ *
+ * Each entry is keyed by a hash of the operation (including all relevant arguments) and the path of the file. It contains
+ * the device, inode, size, modification time and status change time of the file and a digest of the result. A cached result
+ * is only returned if the file has not been changed according to all of these values and if the digest of the result matches.
+ *
+ * Results stored via store() are appended to a file next to the database right away so only their entries are kept in memory
+ * (and not the paths and results themselves). When save() is called, the entire database is written to a new file which
+ * replaces the existing one atomically. Results of files not processed in the meantime are kept and superseded
+ * results are dropped so the database stays compact. The database uses the native byte order so it is not portable between
+ * architectures.
+ *
+ * The same database may be used by multiple processes at the same time (e.g. by the workers of the "serve"-operation). The
+ * buffered results and the new database are written to files with unique names. On UNIX, save() holds an exclusive lock
+ * (via flock() on a lock file next to the database) and merges the results with the database currently on disk (and not
+ * with the one that has been mapped when opening it) so results stored by other processes in the meantime are kept.
+ */
+
+/*!
+ * \brief Opens the database with the specified \a path; the database is created when calling save() if it does not exist.
+ * \throws Throws std::ios_base::failure when the database can not be read and std::runtime_error if it is invalid.
+ */
+StateDatabase::StateDatabase(std::string_view path)
+    : m_path(path)
+    , m_stamp()
+    , m_data(nullptr)
+    , m_size(0)
+    , m_header()
+    , m_updateFileSize(0)
+{
+    map();
+}
+
+/*!
+ * \brief Closes the database discarding results which have not been saved.
+ */
+StateDatabase::~StateDatabase()
+{
+    unmap();
+    discardUpdates();
+}
+
+/*!
+ * \brief Discards the results stored since opening or saving the database and removes the file containing their data.
+ */
+void StateDatabase::discardUpdates()
+{
+    m_updates.clear();
+    m_updateFileSize = 0;
+    if (!m_updateFile.is_open()) {
+        return;
+    }
+    m_updateFile.close();
+    m_updateFile.clear();
+    if (!m_updatePath.empty()) {
+        auto removeError = std::error_code();
+        std::filesystem::remove(makeNativePath(m_updatePath), removeError);
+        m_updatePath.clear();
+    }
+}
+
+/*!
+ * \brief Returns the key for the entry of the file with the specified \a filePath processed via the operation with the
+ *        specified \a operationHash.
+ */
+std::uint64_t StateDatabase::key(std::uint64_t operationHash, std::string_view filePath)
+{
+    const auto key = BatchJournal::hash(filePath, operationHash);
+    return key ? key : 1;
+}
+
+/*!
+ * \brief Returns the entry with the specified \a slot of the hash table.
+ */
+StateDatabase::Entry StateDatabase::entry(std::uint64_t slot) const
+{
+    auto entry = Entry();
+    std::memcpy(&entry, m_data + sizeof(Header) + slot * sizeof(Entry), sizeof(Entry));
+    return entry;
+}
+
+/*!
+ * \brief Returns the specified portion of the data section or an empty string view if it is out of range.
+ */
+std::string_view StateDatabase::dataAt(std::uint64_t offset, std::uint64_t size) const
+{
+    if (offset > m_header.dataSize || size > m_header.dataSize - offset) {
+        return std::string_view();
+    }
+    return std::string_view(m_data + sizeof(Header) + m_header.slotCount * sizeof(Entry) + offset, static_cast<std::size_t>(size));
+}
+
+/*!
+ * \brief Maps the database into memory and validates its header.
+ */
+void StateDatabase::map()
+{
+    auto error = std::error_code();
+    if (!std::filesystem::exists(makeNativePath(m_path), error)) {
+        return;
+    }
+    if (m_stamp = FileStamp::read(m_path, error); error) {
+        m_stamp = FileStamp();
+    }
+#ifdef PLATFORM_UNIX
+    const auto fd = ::open(m_path.data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::ios_base::failure("unable to open", std::error_code(errno, std::generic_category()));
+    }
+    struct stat st;
+    if (::fstat(fd, &st)) {
+        const auto statError = errno;
+        ::close(fd);
+        throw std::ios_base::failure("unable to determine size", std::error_code(statError, std::generic_category()));
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    if (m_size) {
+        auto *const data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        const auto mapError = errno;
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            m_size = 0;
+            throw std::ios_base::failure("unable to map into memory", std::error_code(mapError, std::generic_category()));
+        }
+        m_data = static_cast<const char *>(data);
+    } else {
+        ::close(fd);
+    }
+#else
+    auto file = NativeFileStream();
+    file.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+    file.open(m_path, std::ios_base::in | std::ios_base::binary);
+    m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#endif
+
+    // validate header (an empty file is treated like a new database)
+    if (!m_size) {
+        return;
+    }
+    if (m_size >= sizeof(Header)) {
+        std::memcpy(&m_header, m_data, sizeof(Header));
+    }
+    const auto maxSlotCount = (m_size - std::min(m_size, sizeof(Header))) / sizeof(Entry);
+    if (m_size < sizeof(Header) || std::memcmp(m_header.magic, "TAGEDSDB", sizeof(m_header.magic)) || m_header.version != version
+        || m_header.entrySize != sizeof(Entry) || !m_header.slotCount || (m_header.slotCount & (m_header.slotCount - 1))
+        || m_header.slotCount > maxSlotCount || m_header.dataSize != m_size - sizeof(Header) - m_header.slotCount * sizeof(Entry)) {
+        unmap();
+        throw std::runtime_error("not a state database of this version (delete it to start over)");
+    }
+}
+
+/*!
+ * \brief Unmaps the database.
+ */
+void StateDatabase::unmap()
+{
+#ifdef PLATFORM_UNIX
+    if (m_data) {
+        ::munmap(const_cast<char *>(m_data), m_size);
+    }
+#else
+    m_buffer.clear();
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_header = Header();
+    m_stamp = FileStamp();
+}
+
+/*!
+ * \brief Returns whether the database file has been replaced or modified (e.g. by another process) since it has been mapped.
+ * \remarks Such changes are not picked up by an opened database so it needs to be re-opened to take them into account.
+ */
+bool StateDatabase::hasBeenReplaced() const
+{
+    auto error = std::error_code();
+    const auto stamp = FileStamp::read(m_path, error);
+    return !((error ? FileStamp() : stamp) == m_stamp);
+}
+
+/*!
+ * \brief Returns the result cached for the file with the specified \a filePath processed via the operation with the specified
+ *        \a operationHash if the file has not been changed since then according to the specified \a stamp.
+ * \remarks The returned result is only valid until save() is called. This function may be called from multiple threads at the
+ *          same time.
+ */
+std::optional<std::string_view> StateDatabase::lookup(std::uint64_t operationHash, std::string_view filePath, const FileStamp &stamp) const
+{
+    if (!m_header.slotCount) {
+        return std::nullopt;
+    }
+    const auto key = StateDatabase::key(operationHash, filePath);
+    const auto mask = m_header.slotCount - 1;
+    for (auto slot = key & mask;; slot = (slot + 1) & mask) {
+        const auto entry = StateDatabase::entry(slot);
+        if (!entry.key) {
+            return std::nullopt;
+        }
+        if (entry.key != key || dataAt(entry.dataOffset, entry.pathSize) != filePath) {
+            continue;
+        }
+        const auto result = dataAt(entry.dataOffset + entry.pathSize, entry.resultSize);
+        const auto storedStamp = FileStamp{ entry.device, entry.inode, entry.size, entry.modificationTime, entry.changeTime };
+        if (storedStamp == stamp && result.size() == entry.resultSize && BatchJournal::hash(result) == entry.resultDigest) {
+            return result;
+        }
+        return std::nullopt;
+    }
+}
+
+/*!
+ * \brief Stores the \a result of processing the file with the specified \a filePath and \a stamp via the operation with the
+ *        specified \a operationHash.
+ * \remarks The result is only added to the database when calling save(); until then the path and the result are buffered in a
+ *          file next to the database. An error writing that file is only reported when calling save(). This function may be
+ *          called from multiple threads at the same time.
+ */
+void StateDatabase::store(std::uint64_t operationHash, std::string_view filePath, const FileStamp &stamp, std::string_view result)
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    if (!m_updateFile.is_open() && m_updateFile) {
+        try {
+#ifdef PLATFORM_UNIX
+            m_updatePath = m_path + ".updates";
+            ::close(createUniqueFile(m_updatePath));
+#else
+            m_updatePath = uniquePath(m_path + ".updates");
+#endif
+            m_updateFile.open(m_updatePath, std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+        } catch (const std::ios_base::failure &) {
+            m_updatePath.clear();
+            m_updateFile.setstate(std::ios_base::failbit);
+        }
+    }
+    const auto key = StateDatabase::key(operationHash, filePath);
+    m_updateFile.write(filePath.data(), static_cast<std::streamsize>(filePath.size()));
+    m_updateFile.write(result.data(), static_cast<std::streamsize>(result.size()));
+    m_updates[key] = Entry{ key, stamp.device, stamp.inode, stamp.size, stamp.modificationTime, stamp.changeTime, BatchJournal::hash(result),
+        m_updateFileSize, static_cast<std::uint32_t>(filePath.size()), static_cast<std::uint32_t>(result.size()) };
+    m_updateFileSize += filePath.size() + result.size();
+}
+
+/*!
+ * \brief Writes the database including all results stored via store() to a new file replacing the existing database.
+ * \remarks The results are merged with the database currently on disk which is mapped afterwards.
+ * \throws Throws std::ios_base::failure or std::filesystem::filesystem_error when an IO error occurs and std::runtime_error if
+ *         the database on disk has become invalid.
+ */
+void StateDatabase::save()
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    if (m_updates.empty()) {
+        return;
+    }
+
+    // prevent other processes from replacing the database until it has been replaced by this process and take results they
+    // have saved in the meantime into account
+#ifdef PLATFORM_UNIX
+    const auto lockPath = m_path + ".lock";
+    struct FileLock {
+        ~FileLock()
+        {
+            if (fd >= 0) {
+                ::close(fd); // releases the lock
+            }
+        }
+        int fd;
+    } const fileLock{ ::open(lockPath.data(), O_RDWR | O_CREAT | O_CLOEXEC, 0644) };
+    if (fileLock.fd < 0) {
+        throw std::ios_base::failure("unable to open \"" + lockPath + '\"', std::error_code(errno, std::generic_category()));
+    }
+    while (::flock(fileLock.fd, LOCK_EX)) {
+        if (errno != EINTR) {
+            throw std::ios_base::failure("unable to lock \"" + lockPath + '\"', std::error_code(errno, std::generic_category()));
+        }
+    }
+#endif
+    unmap();
+    map();
+
+    // determine the number of entries and the size of the data section (entries superseded by updates are dropped)
+    auto entryCount = static_cast<std::uint64_t>(m_updates.size());
+    auto dataSize = std::uint64_t();
+    for (const auto &[key, update] : m_updates) {
+        dataSize += update.pathSize + update.resultSize;
+    }
+    for (auto slot = std::uint64_t(); slot != m_header.slotCount; ++slot) {
+        if (const auto entry = StateDatabase::entry(slot); entry.key && m_updates.find(entry.key) == m_updates.end()) {
+            ++entryCount;
+            dataSize += entry.pathSize + entry.resultSize;
+        }
+    }
+    auto slotCount = std::uint64_t(1024);
+    while (slotCount < entryCount * 2) {
+        slotCount <<= 1;
+    }
+    const auto fileSize = sizeof(Header) + slotCount * sizeof(Entry) + dataSize;
+
+    // write a new database and replace the existing one with it
+#ifdef PLATFORM_UNIX
+    auto tempPath = m_path + ".tmp";
+    const auto fd = createUniqueFile(tempPath);
+    auto *buffer = static_cast<void *>(MAP_FAILED);
+    if (!::fchmod(fd, 0644) && !::ftruncate(fd, static_cast<off_t>(fileSize))) {
+        buffer = ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (buffer == MAP_FAILED) {
+        const auto writeError = errno;
+        ::close(fd);
+        ::unlink(tempPath.data());
+        throw std::ios_base::failure("unable to write \"" + tempPath + '\"', std::error_code(writeError, std::generic_category()));
+    }
+    write(static_cast<char *>(buffer), slotCount, entryCount, dataSize);
+    ::munmap(buffer, fileSize);
+    const auto syncError = ::fsync(fd) ? errno : 0;
+    ::close(fd);
+    if (syncError) {
+        ::unlink(tempPath.data());
+        throw std::ios_base::failure("unable to sync \"" + tempPath + '\"', std::error_code(syncError, std::generic_category()));
+    }
+#else
+    const auto tempPath = uniquePath(m_path + ".tmp");
+    auto buffer = std::string(fileSize, '\0');
+    write(buffer.data(), slotCount, entryCount, dataSize);
+#endif
+    // keep the existing database if the buffered results could not be written or read back
+    if (!m_updateFile) {
+        auto removeError = std::error_code();
+        std::filesystem::remove(makeNativePath(tempPath), removeError);
+        discardUpdates();
+        throw std::ios_base::failure("unable to buffer results next to \"" + m_path + '\"');
+    }
+#ifndef PLATFORM_UNIX
+    auto file = NativeFileStream();
+    file.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+    file.open(tempPath, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.close();
+#endif
+    unmap();
+    std::filesystem::rename(makeNativePath(tempPath), makeNativePath(m_path));
+    discardUpdates();
+    map();
+}
+
+/*!
+ * \brief Writes the header, the hash table and the data section of a new database to the specified zero-initialized \a buffer.
+ */
+void StateDatabase::write(char *buffer, std::uint64_t slotCount, std::uint64_t entryCount, std::uint64_t dataSize)
+{
+    auto header = Header();
+    std::memcpy(header.magic, "TAGEDSDB", sizeof(header.magic));
+    header.version = version;
+    header.entrySize = sizeof(Entry);
+    header.slotCount = slotCount;
+    header.entryCount = entryCount;
+    header.dataSize = dataSize;
+    std::memcpy(buffer, &header, sizeof(Header));
+
+    auto *const slots = buffer + sizeof(Header);
+    auto *const data = slots + slotCount * sizeof(Entry);
+    auto dataOffset = std::uint64_t();
+    const auto mask = slotCount - 1;
+    const auto insert = [&](Entry &entry) {
+        entry.dataOffset = dataOffset;
+        dataOffset += entry.pathSize + entry.resultSize;
+        for (auto slot = entry.key & mask;; slot = (slot + 1) & mask) {
+            auto *const target = slots + slot * sizeof(Entry);
+            auto existingKey = std::uint64_t();
+            std::memcpy(&existingKey, target, sizeof(existingKey));
+            if (!existingKey) {
+                std::memcpy(target, &entry, sizeof(Entry));
+                return;
+            }
+        }
+    };
+    for (auto slot = std::uint64_t(); slot != m_header.slotCount; ++slot) {
+        if (auto entry = StateDatabase::entry(slot); entry.key && m_updates.find(entry.key) == m_updates.end()) {
+            const auto stored = dataAt(entry.dataOffset, static_cast<std::uint64_t>(entry.pathSize) + entry.resultSize);
+            insert(entry);
+            std::memcpy(data + entry.dataOffset, stored.data(), stored.size());
+        }
+    }
+    if (m_updates.empty() || !m_updateFile) {
+        return;
+    }
+    m_updateFile.flush();
+    for (auto [key, update] : m_updates) {
+        const auto bufferedOffset = update.dataOffset;
+        insert(update);
+        m_updateFile.seekg(static_cast<std::streamoff>(bufferedOffset));
+        m_updateFile.read(data + update.dataOffset, static_cast<std::streamsize>(update.pathSize) + update.resultSize);
+    }
+}
+
+/*!
+ * \brief Returns a hash of the specified \a operation and the values of the specified \a args for identifying results in the
+ *        state database.
+ */
+std::uint64_t hashIncrementalArguments(std::string_view operation, std::initializer_list<const Argument *> args)
+{
+    auto res = BatchJournal::hash(operation);
+    for (const auto *const arg : args) {
+        if (!arg->isPresent()) {
+            continue;
+        }
+        res = BatchJournal::hash(std::string_view("\n", 1), BatchJournal::hash(arg->name(), res));
+        for (auto i = std::size_t(), occurrences = arg->occurrences(); i != occurrences; ++i) {
+            for (const auto *const value : arg->values(i)) {
+                res = BatchJournal::hash(std::string_view(value, std::strlen(value) + 1), res);
+            }
+        }
+    }
+    return res;
+}
+
+} // namespace Cli
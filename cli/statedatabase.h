@@ -0,0 +1,124 @@
+#ifndef CLI_STATE_DATABASE
+#define CLI_STATE_DATABASE
+
+#include <c++utilities/application/global.h>
+#include <c++utilities/io/nativefilestream.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+
+namespace CppUtilities {
+class Argument;
+}
+
+namespace Cli {
+
+struct FileStamp {
+    std::uint64_t device = 0;
+    std::uint64_t inode = 0;
+    std::uint64_t size = 0;
+    std::int64_t modificationTime = 0; /**< modification time in nanoseconds */
+    std::int64_t changeTime = 0; /**< status change time in nanoseconds */
+
+    bool operator==(const FileStamp &other) const;
+    static FileStamp read(std::string_view path, std::error_code &error);
+};
+
+/*!
+ * \brief Returns whether all values of the stamps are equal.
+ */
+inline bool FileStamp::operator==(const FileStamp &other) const
+{
+    return device == other.device && inode == other.inode && size == other.size && modificationTime == other.modificationTime
+        && changeTime == other.changeTime;
+}
+
+class StateDatabase {
+public:
+    explicit StateDatabase(std::string_view path);
+    ~StateDatabase();
+    StateDatabase(const StateDatabase &) = delete;
+    StateDatabase &operator=(const StateDatabase &) = delete;
+
+    const std::string &path() const;
+    std::size_t entryCount() const;
+    bool hasBeenReplaced() const;
+    std::optional<std::string_view> lookup(std::uint64_t operationHash, std::string_view filePath, const FileStamp &stamp) const;
+    void store(std::uint64_t operationHash, std::string_view filePath, const FileStamp &stamp, std::string_view result);
+    void save();
+
+private:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t entrySize;
+        std::uint64_t slotCount;
+        std::uint64_t entryCount;
+        std::uint64_t dataSize;
+        std::uint64_t reserved[3];
+    };
+    struct Entry {
+        std::uint64_t key; /**< hash of the operation and the path; zero denotes an empty slot */
+        std::uint64_t device;
+        std::uint64_t inode;
+        std::uint64_t size;
+        std::int64_t modificationTime;
+        std::int64_t changeTime;
+        std::uint64_t resultDigest;
+        std::uint64_t dataOffset; /**< offset of the path followed by the result within the data section */
+        std::uint32_t pathSize;
+        std::uint32_t resultSize;
+    };
+    static constexpr std::uint32_t version = 1;
+
+    static std::uint64_t key(std::uint64_t operationHash, std::string_view filePath);
+    Entry entry(std::uint64_t slot) const;
+    std::string_view dataAt(std::uint64_t offset, std::uint64_t size) const;
+    void map();
+    void unmap();
+    void write(char *buffer, std::uint64_t slotCount, std::uint64_t entryCount, std::uint64_t dataSize);
+    void discardUpdates();
+
+    std::string m_path;
+    FileStamp m_stamp; /**< stamp of the database file when it has been mapped; all zero if it did not exist */
+    const char *m_data;
+    std::size_t m_size;
+    Header m_header;
+    std::mutex m_mutex;
+    std::unordered_map<std::uint64_t, Entry> m_updates; /**< entries stored since opening; their data resides in m_updateFile */
+    CppUtilities::NativeFileStream m_updateFile;
+    std::string m_updatePath;
+    std::uint64_t m_updateFileSize;
+#ifndef PLATFORM_UNIX
+    std::string m_buffer;
+#endif
+};
+
+/*!
+ * \brief Returns the path of the database.
+ */
+inline const std::string &StateDatabase::path() const
+{
+    return m_path;
+}
+
+/*!
+ * \brief Returns the number of files the database contains results for (not taking results stored since opening it into account).
+ */
+inline std::size_t StateDatabase::entryCount() const
+{
+    return static_cast<std::size_t>(m_header.entryCount);
+}
+
+std::uint64_t hashIncrementalArguments(std::string_view operation, std::initializer_list<const CppUtilities::Argument *> args);
+
+} // namespace Cli
+
+#endif // CLI_STATE_DATABASE
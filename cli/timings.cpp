@@ -0,0 +1,262 @@
+#include "./timings.h"
+
+#include <c++utilities/application/argumentparser.h>
+#include <c++utilities/application/global.h>
+#include <c++utilities/io/ansiescapecodes.h>
+
+#ifdef PLATFORM_UNIX
+#include <time.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace CppUtilities::EscapeCodes;
+
+namespace Cli {
+
+/*!
+ * \class FileTimings
+ * \brief The FileTimings class records the wall-clock time, the CPU time and the I/O of the phases of processing a single file.
+ *
+ * The phases are recorded one after another: start() ends the current phase (if any) and starts the next one. So the phases
+ * of an operation can be marked without restructuring its code. The CPU time and the I/O are determined for the calling thread
+ * so the recorded values stay meaningful when processing multiple files in parallel. Hence all phases of a file must be started
+ * and stopped on the same thread.
+ *
+ * The I/O is determined via the "rchar"/"wchar" counters of /proc/thread-self/io which covers all reads and writes of the thread,
+ * including those of file streams used internally by tagparser. It is therefore only available under Linux and also contains
+ * output written to the terminal.
+ */
+
+/*!
+ * \brief Constructs timings which are only recorded if \a enabled is true.
+ */
+FileTimings::FileTimings(bool enabled)
+    : m_enabled(enabled)
+    , m_running(false)
+{
+}
+
+/*!
+ * \brief Clears all recorded phases to start recording the timings of the file with the specified \a path.
+ */
+void FileTimings::reset(std::string_view path)
+{
+    if (!m_enabled) {
+        return;
+    }
+    m_path = path;
+    m_phases.clear();
+    m_running = false;
+}
+
+/*!
+ * \brief Ends the current phase (if any) and starts the specified \a phase.
+ * \remarks The \a phase must outlive the timings (usually it is a string literal).
+ */
+void FileTimings::start(std::string_view phase)
+{
+    if (!m_enabled) {
+        return;
+    }
+    stop();
+    m_currentPhase = phase;
+    m_running = true;
+    m_start = takeSample();
+}
+
+/*!
+ * \brief Ends the current phase (if any).
+ */
+void FileTimings::stop()
+{
+    if (!m_enabled || !m_running) {
+        return;
+    }
+    const auto end = takeSample();
+    auto &phase = m_phases.emplace_back();
+    phase.name = m_currentPhase;
+    phase.wallTime = std::chrono::duration<double, std::milli>(end.wallTime - m_start.wallTime).count();
+    phase.cpuTime = end.cpuTime - m_start.cpuTime;
+    phase.bytesRead = end.bytesRead - std::min(end.bytesRead, m_start.bytesRead);
+    phase.bytesWritten = end.bytesWritten - std::min(end.bytesWritten, m_start.bytesWritten);
+    m_running = false;
+}
+
+/*!
+ * \brief Returns the current wall-clock time, CPU time and I/O counters of the calling thread.
+ */
+FileTimings::Sample FileTimings::takeSample()
+{
+    auto sample = Sample();
+#ifdef PLATFORM_LINUX
+    if (auto io = std::ifstream("/proc/thread-self/io")) {
+        for (auto key = std::string(); io >> key;) {
+            auto value = std::uint64_t();
+            io >> value;
+            if (key == "rchar:") {
+                sample.bytesRead = value;
+            } else if (key == "wchar:") {
+                sample.bytesWritten = value;
+            }
+        }
+    }
+#endif
+#ifdef PLATFORM_UNIX
+    auto cpuTime = timespec();
+    if (!clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime)) {
+        sample.cpuTime = static_cast<double>(cpuTime.tv_sec) * 1000.0 + static_cast<double>(cpuTime.tv_nsec) / 1000000.0;
+    }
+#else
+    sample.cpuTime = static_cast<double>(std::clock()) * 1000.0 / CLOCKS_PER_SEC;
+#endif
+    sample.wallTime = std::chrono::steady_clock::now();
+    return sample;
+}
+
+/*!
+ * \class TimingsReport
+ * \brief The TimingsReport class prints the timings of processed files tab-separated and gathers them for a summary.
+ *
+ * Lines starting with "file" contain the timings of a single phase of a single file. Lines starting with "summary" contain
+ * percentiles over all files per phase. Lines starting with "#" describe the columns. Times are in milliseconds.
+ */
+
+/// \cond
+static void printEscaped(std::ostream &out, std::string_view value)
+{
+    for (const auto c : value) {
+        switch (c) {
+        case '\t':
+            out << "\\t";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        default:
+            out << c;
+        }
+    }
+}
+
+static double percentile(std::vector<double> &values, double p)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(values.size())));
+    return values[std::clamp<std::size_t>(rank, 1, values.size()) - 1];
+}
+/// \endcond
+
+/*!
+ * \brief Constructs a report printing to the file specified via \a timingsArg or to stderr if no file has been specified.
+ */
+TimingsReport::TimingsReport(const Argument &timingsArg)
+    : m_out(&std::cerr)
+{
+    if (!timingsArg.values().empty()) {
+        const char *const path = timingsArg.values().front();
+        try {
+            m_file.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+            m_file.open(path, std::ios_base::out | std::ios_base::trunc);
+            m_out = &m_file;
+        } catch (const std::ios_base::failure &e) {
+            std::cerr << Phrases::Error << "Unable to open \"" << path << "\" for writing timings: " << e.what() << Phrases::EndFlush;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    *m_out << "#record\tfile\tphase\twall_ms\tcpu_ms\tbytes_read\tbytes_written\n";
+}
+
+/*!
+ * \brief Stops the specified \a timings, prints them and adds them to the summary.
+ */
+void TimingsReport::add(FileTimings &timings)
+{
+    timings.stop();
+    if (timings.phases().empty()) {
+        return;
+    }
+    const auto flags = m_out->flags();
+    const auto precision = m_out->precision();
+    auto total = PhaseTiming();
+    total.name = "total";
+    *m_out << std::fixed << std::setprecision(3);
+    for (const auto &phase : timings.phases()) {
+        *m_out << "file\t";
+        printEscaped(*m_out, timings.path());
+        *m_out << '\t' << phase.name << '\t' << phase.wallTime << '\t' << phase.cpuTime << '\t' << phase.bytesRead << '\t' << phase.bytesWritten
+               << '\n';
+        total.wallTime += phase.wallTime;
+        total.cpuTime += phase.cpuTime;
+        total.bytesRead += phase.bytesRead;
+        total.bytesWritten += phase.bytesWritten;
+        addPhase(timings.path(), phase);
+    }
+    addPhase(timings.path(), total);
+    m_out->flags(flags);
+    m_out->precision(precision);
+}
+
+void TimingsReport::addPhase(std::string_view path, const PhaseTiming &phase)
+{
+    auto i = m_phases.find(phase.name);
+    if (i == m_phases.end()) {
+        i = m_phases.emplace(phase.name, PhaseStatistics()).first;
+        m_phaseNames.emplace_back(phase.name);
+    }
+    auto &statistics = i->second;
+    if (statistics.wallTimes.empty() || phase.wallTime > statistics.slowestWallTime) {
+        statistics.slowestWallTime = phase.wallTime;
+        statistics.slowestFile = path;
+    }
+    statistics.wallTimes.emplace_back(phase.wallTime);
+    statistics.cpuTimes.emplace_back(phase.cpuTime);
+    statistics.bytesRead += phase.bytesRead;
+    statistics.bytesWritten += phase.bytesWritten;
+}
+
+/*!
+ * \brief Prints the 50th, 90th and 99th percentile and the maximum of the wall-clock and CPU time per phase over all files.
+ * \remarks The "total" phase covers all phases of a file. The slowest file is the one with the highest wall-clock time.
+ */
+void TimingsReport::printSummary()
+{
+    const auto flags = m_out->flags();
+    const auto precision = m_out->precision();
+    *m_out << "#record\tphase\tfiles\twall_p50_ms\twall_p90_ms\twall_p99_ms\twall_max_ms\tcpu_p50_ms\tcpu_p90_ms\tcpu_p99_ms\tcpu_max_ms\t"
+              "bytes_read\tbytes_written\tslowest_file\n"
+           << std::fixed << std::setprecision(3);
+    // print the total last
+    std::stable_partition(m_phaseNames.begin(), m_phaseNames.end(), [](std::string_view name) { return name != "total"; });
+    for (const auto name : m_phaseNames) {
+        auto &statistics = m_phases[name];
+        *m_out << "summary\t" << name << '\t' << statistics.wallTimes.size();
+        for (auto *const times : { &statistics.wallTimes, &statistics.cpuTimes }) {
+            for (const auto p : { 0.5, 0.9, 0.99, 1.0 }) {
+                *m_out << '\t' << percentile(*times, p);
+            }
+        }
+        *m_out << '\t' << statistics.bytesRead << '\t' << statistics.bytesWritten << '\t';
+        printEscaped(*m_out, statistics.slowestFile);
+        *m_out << '\n';
+    }
+    *m_out << std::flush;
+    m_out->flags(flags);
+    m_out->precision(precision);
+}
+
+} // namespace Cli
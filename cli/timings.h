@@ -0,0 +1,104 @@
+#ifndef CLI_TIMINGS
+#define CLI_TIMINGS
+
+#include <c++utilities/io/nativefilestream.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CppUtilities {
+class Argument;
+}
+
+namespace Cli {
+
+struct PhaseTiming {
+    std::string_view name;
+    double wallTime = 0.0; /**< wall-clock time in milliseconds */
+    double cpuTime = 0.0; /**< CPU time of the thread in milliseconds */
+    std::uint64_t bytesRead = 0;
+    std::uint64_t bytesWritten = 0;
+};
+
+class FileTimings {
+public:
+    explicit FileTimings(bool enabled = false);
+    bool isEnabled() const;
+    const std::string &path() const;
+    const std::vector<PhaseTiming> &phases() const;
+    void reset(std::string_view path);
+    void start(std::string_view phase);
+    void stop();
+
+private:
+    struct Sample {
+        std::chrono::steady_clock::time_point wallTime;
+        double cpuTime = 0.0;
+        std::uint64_t bytesRead = 0;
+        std::uint64_t bytesWritten = 0;
+    };
+    static Sample takeSample();
+
+    std::string m_path;
+    std::vector<PhaseTiming> m_phases;
+    std::string_view m_currentPhase;
+    Sample m_start;
+    bool m_enabled;
+    bool m_running;
+};
+
+/*!
+ * \brief Returns whether timings are recorded at all; if not, start() and stop() are no-ops.
+ */
+inline bool FileTimings::isEnabled() const
+{
+    return m_enabled;
+}
+
+/*!
+ * \brief Returns the path of the file the timings have been recorded for.
+ */
+inline const std::string &FileTimings::path() const
+{
+    return m_path;
+}
+
+/*!
+ * \brief Returns the recorded phases in the order they have been started.
+ */
+inline const std::vector<PhaseTiming> &FileTimings::phases() const
+{
+    return m_phases;
+}
+
+class TimingsReport {
+public:
+    explicit TimingsReport(const CppUtilities::Argument &timingsArg);
+    void add(FileTimings &timings);
+    void printSummary();
+
+private:
+    struct PhaseStatistics {
+        std::vector<double> wallTimes;
+        std::vector<double> cpuTimes;
+        std::uint64_t bytesRead = 0;
+        std::uint64_t bytesWritten = 0;
+        double slowestWallTime = 0.0;
+        std::string slowestFile;
+    };
+    void addPhase(std::string_view path, const PhaseTiming &phase);
+
+    CppUtilities::NativeFileStream m_file;
+    std::ostream *m_out;
+    std::vector<std::string_view> m_phaseNames;
+    std::map<std::string_view, PhaseStatistics> m_phases;
+};
+
+} // namespace Cli
+
+#endif // CLI_TIMINGS
@@ -1,7 +1,10 @@
+#include "../cli/blobstore.h"
 #include "../cli/mainfeatures.h"
+#include "../cli/sha256.h"
 
 #include "resources/config.h"
 
+#include <c++utilities/conversion/binaryconversion.h>
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/conversion/stringconversion.h>
 #include <c++utilities/io/misc.h>
@@ -36,8 +39,17 @@ using namespace CppUtilities;
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <thread>
+
+#ifdef PLATFORM_UNIX
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #ifdef stdout
 #undef stdout
@@ -58,6 +70,7 @@ enum class TagStatus { Original, TestMetaDataPresent, Removed };
  */
 class CliTests : public TestFixture {
     CPPUNIT_TEST_SUITE(CliTests);
+    CPPUNIT_TEST(testSha256);
 #if defined(PLATFORM_UNIX) || defined(CPP_UTILITIES_HAS_EXEC_APP)
     CPPUNIT_TEST(testBasicReading);
     CPPUNIT_TEST(testBasicWriting);
@@ -67,11 +80,26 @@ class CliTests : public TestFixture {
     CPPUNIT_TEST(testId3SpecificOptions);
     CPPUNIT_TEST(testEncodingOption);
     CPPUNIT_TEST(testMultipleFiles);
+    CPPUNIT_TEST(testParallelProcessing);
+    CPPUNIT_TEST(testManifest);
+    CPPUNIT_TEST(testJsonImport);
+    CPPUNIT_TEST(testSkippingUnchangedFiles);
+    CPPUNIT_TEST(testRewritePlan);
+    CPPUNIT_TEST(testPaddingAdvisor);
+    CPPUNIT_TEST(testTimings);
+    CPPUNIT_TEST(testProgress);
+    CPPUNIT_TEST(testJournal);
+    CPPUNIT_TEST(testIncremental);
+    CPPUNIT_TEST(testServe);
+    CPPUNIT_TEST(testFilesFrom);
+    CPPUNIT_TEST(testRecursive);
+    CPPUNIT_TEST(testMachineReadableOutput);
     CPPUNIT_TEST(testOutputFile);
     CPPUNIT_TEST(testBackupDir);
     CPPUNIT_TEST(testMultipleValuesPerField);
     CPPUNIT_TEST(testHandlingAttachments);
     CPPUNIT_TEST(testDisplayingInfo);
+    CPPUNIT_TEST(testVerification);
     CPPUNIT_TEST(testSettingTrackMetaData);
     CPPUNIT_TEST(testExtraction);
     CPPUNIT_TEST(testReadingAndWritingDocumentTitle);
@@ -85,6 +113,7 @@ public:
     void setUp() override;
     void tearDown() override;
 
+    void testSha256();
 #if defined(PLATFORM_UNIX) || defined(CPP_UTILITIES_HAS_EXEC_APP)
     void testBasicReading();
     void testBasicWriting();
@@ -94,11 +123,26 @@ public:
     void testId3SpecificOptions();
     void testEncodingOption();
     void testMultipleFiles();
+    void testParallelProcessing();
+    void testManifest();
+    void testJsonImport();
+    void testSkippingUnchangedFiles();
+    void testRewritePlan();
+    void testPaddingAdvisor();
+    void testTimings();
+    void testProgress();
+    void testJournal();
+    void testIncremental();
+    void testServe();
+    void testFilesFrom();
+    void testRecursive();
+    void testMachineReadableOutput();
     void testOutputFile();
     void testBackupDir();
     void testMultipleValuesPerField();
     void testHandlingAttachments();
     void testDisplayingInfo();
+    void testVerification();
     void testSettingTrackMetaData();
     void testExtraction();
     void testReadingAndWritingDocumentTitle();
@@ -120,6 +164,26 @@ void CliTests::tearDown()
 {
 }
 
+/*!
+ * \brief Tests the SHA-256 implementation used to store binary values content-addressed against the test vectors of FIPS 180-4.
+ */
+void CliTests::testSha256()
+{
+    CPPUNIT_ASSERT_EQUAL("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"s, Cli::Sha256::hexDigest(std::string_view()));
+    CPPUNIT_ASSERT_EQUAL("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"s, Cli::Sha256::hexDigest("abc"));
+    CPPUNIT_ASSERT_EQUAL("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"s,
+        Cli::Sha256::hexDigest("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+
+    // passing data in chunks which do not line up with the block size yields the same digest
+    const auto chunk = std::string(999, 'a');
+    auto sha256 = Cli::Sha256();
+    for (auto i = 0; i != 1001; ++i) {
+        sha256.update(chunk);
+    }
+    sha256.update("a");
+    CPPUNIT_ASSERT_EQUAL("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"s, Cli::Sha256::toHex(sha256.finalize()));
+}
+
 #if defined(PLATFORM_UNIX) || defined(CPP_UTILITIES_HAS_EXEC_APP)
 template <typename StringType, bool negateErrorCond = false>
 bool testContainsSubstrings(const StringType &str, std::initializer_list<const typename StringType::value_type *> substrings)
@@ -640,6 +704,651 @@ void CliTests::testMultipleFiles()
     CPPUNIT_ASSERT_EQUAL(0, remove((mkvFile3 + ".bak").data()));
 }
 
+/*!
+ * \brief Tests processing multiple files in parallel via --jobs.
+ */
+void CliTests::testParallelProcessing()
+{
+    cout << "\nProcessing multiple files in parallel" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mkvFile1 = workingCopyPath("matroska_wave1/test1.mkv");
+    const auto mkvFile2 = workingCopyPath("matroska_wave1/test2.mkv");
+    const auto mkvFile3 = workingCopyPath("matroska_wave1/test3.mkv");
+
+    // set title and part number of 3 files using 2 jobs; output and incremented values must still be in order
+    const char *const args1[] = { "tageditor", "set", "target-level=30", "title=test1", "title=test2", "title=test3", "part+=1", "--jobs", "2", "-f",
+        mkvFile1.data(), mkvFile2.data(), mkvFile3.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    const auto pos1 = stdout.find(mkvFile1), pos2 = stdout.find(mkvFile2), pos3 = stdout.find(mkvFile3);
+    CPPUNIT_ASSERT(pos1 != string::npos);
+    CPPUNIT_ASSERT(pos2 != string::npos);
+    CPPUNIT_ASSERT(pos3 != string::npos);
+    CPPUNIT_ASSERT(pos1 < pos2);
+    CPPUNIT_ASSERT(pos2 < pos3);
+
+    const char *const args2[] = { "tageditor", "get", "-f", mkvFile1.data(), mkvFile2.data(), mkvFile3.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+          "    Title             test1\n"
+          "    Part              1",
+            " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+            "    Title             test2\n"
+            "    Part              2",
+            " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+            "    Title             test3\n"
+            "    Part              3" }));
+
+    // using 0 jobs means one job per CPU core
+    const char *const args3[] = { "tageditor", "set", "title=foo", "--jobs", "0", "-q", "-f", mkvFile1.data(), mkvFile2.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile1.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile2.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile3.data()));
+    remove((mkvFile1 + ".bak").data()), remove((mkvFile2 + ".bak").data()), remove((mkvFile3 + ".bak").data());
+}
+
+/*!
+ * \brief Tests specifying files and values via a manifest.
+ */
+void CliTests::testManifest()
+{
+    cout << "\nSpecifying files and values via manifest" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mkvFile1 = workingCopyPath("matroska_wave1/test1.mkv");
+    const auto mkvFile2 = workingCopyPath("matroska_wave1/test2.mkv");
+    const auto manifestFile = workingCopyPath("manifest.tsv", WorkingCopyMode::NoCopy);
+    writeFile(manifestFile,
+        argsToString("file\ttarget-level=30 title\ttarget-level=30 part\n", mkvFile1, "\tfirst\t1\n\n", mkvFile2, "\tsecond\t\n"));
+
+    // values from the manifest are combined with values specified via the command-line
+    const char *const args1[] = { "tageditor", "set", "target-level=50", "title=MKV testfiles", "--manifest", manifestFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    const char *const args2[] = { "tageditor", "get", "-f", mkvFile1.data(), mkvFile2.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { " - \033[1mMatroska tag targeting \"level 50 'album, opera, concert, movie, episode'\"\033[0m\n"
+          "    Title             MKV testfiles\n",
+            " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+            "    Title             first\n"
+            "    Part              1",
+            " - \033[1mMatroska tag targeting \"level 50 'album, opera, concert, movie, episode'\"\033[0m\n"
+            "    Title             MKV testfiles\n",
+            " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+            "    Title             second\n" }));
+
+    // values are unescaped like the TSV output of other operations and CR-LF line breaks are supported
+    writeFile(manifestFile, argsToString("file\ttarget-level=30 title\r\n", mkvFile1, "\tback\\\\slash\\tand tab\r\n"));
+    const char *const args5[] = { "tageditor", "set", "--manifest", manifestFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args5);
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "    Title             back\\slash\tand tab\n" }));
+    CPPUNIT_ASSERT(stdout.find("\r") == string::npos);
+
+    // invalid column names are rejected before any file is modified
+    writeFile(manifestFile, argsToString("file\tfoobar\n", mkvFile1, "\tvalue\n"));
+    const char *const args3[] = { "tageditor", "set", "--manifest", manifestFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args3, EXIT_FAILURE);
+    CPPUNIT_ASSERT(stderr.find("line 1 of the manifest") != string::npos);
+
+    // --files can not be combined with --manifest
+    const char *const args4[] = { "tageditor", "set", "title=foo", "--manifest", manifestFile.data(), "-f", mkvFile1.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args4, EXIT_FAILURE);
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile1.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile2.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(manifestFile.data()));
+    remove((mkvFile1 + ".bak").data()), remove((mkvFile2 + ".bak").data());
+}
+
+/*!
+ * \brief Tests applying the output of the export operation via --from-json.
+ */
+void CliTests::testJsonImport()
+{
+#ifndef TAGEDITOR_JSON_EXPORT
+    cout << "\nSkipping JSON import (feature not enabled)" << endl;
+#else
+    cout << "\nSpecifying files and values via JSON export" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mkvFile1 = workingCopyPath("matroska_wave1/test1.mkv");
+    const auto mkvFile2 = workingCopyPath("matroska_wave1/test2.mkv");
+    const auto jsonFile = workingCopyPath("import.json", WorkingCopyMode::NoCopy);
+
+    // export the files and alter the title in the exported JSON; the files are located via "path" as "fileName" is only the
+    // file name
+    const char *const args1[] = { "tageditor", "set", "target-level=30", "title=exported", "-f", mkvFile1.data(), mkvFile2.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    const char *const args2[] = { "tageditor", "export", "--pretty", "-f", mkvFile1.data(), mkvFile2.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    auto json = stdout;
+    CPPUNIT_ASSERT(json.find("\"path\": \"" % mkvFile1 + '"') != std::string::npos);
+    CPPUNIT_ASSERT(json.find("\"path\": \"" % mkvFile2 + '"') != std::string::npos);
+    findAndReplace(json, "\"exported\""s, "\"imported\""s);
+    writeFile(jsonFile, json);
+
+    // the records are applied to the files in parallel
+    const char *const args3[] = { "tageditor", "set", "--from-json", jsonFile.data(), "--jobs", "2", nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    const char *const args4[] = { "tageditor", "get", "-f", mkvFile1.data(), mkvFile2.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args4);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+          "    Title             imported\n",
+            " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+            "    Title             imported\n" }));
+    CPPUNIT_ASSERT_EQUAL(std::string::npos, stdout.find("exported"));
+
+    // unknown fields are rejected mentioning the line the record starts at
+    writeFile(jsonFile, "[\n{\"path\": \"" % mkvFile1 + "\", \"tags\": [{\"fields\": {\"foobar\": []}}]}\n]\n");
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args3, EXIT_FAILURE);
+    CPPUNIT_ASSERT(stderr.find("\"foobar\" of the record in line 2") != string::npos);
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile1.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile2.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(jsonFile.data()));
+    remove((mkvFile1 + ".bak").data()), remove((mkvFile2 + ".bak").data());
+#endif // TAGEDITOR_JSON_EXPORT
+}
+
+/*!
+ * \brief Tests skipping files which would not be altered via --skip-unchanged.
+ */
+void CliTests::testSkippingUnchangedFiles()
+{
+    cout << "\nSkipping unchanged files" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mkvFile = workingCopyPath("matroska_wave1/test2.mkv");
+    const auto lastWriteTime = [&mkvFile] { return std::filesystem::last_write_time(mkvFile); };
+
+    // the file is altered as usual when values differ
+    const char *const args1[] = { "tageditor", "set", "target-level=30", "title=skip test", "track-id=1863976627", "name=video", "--skip-unchanged",
+        "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(stdout.find("Changes have been applied") != string::npos);
+    const auto writeTime = lastWriteTime();
+
+    // the file is not written at all when all values already match
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(stdout.find("Skipping file because no changes are required") != string::npos);
+    CPPUNIT_ASSERT(stdout.find("Changes have been applied") == string::npos);
+    CPPUNIT_ASSERT(writeTime == lastWriteTime());
+
+    // a differing track property is enough to alter the file
+    const char *const args2[] = { "tageditor", "set", "target-level=30", "title=skip test", "track-id=1863976627", "name=other video",
+        "--skip-unchanged", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(stdout.find("Changes have been applied") != string::npos);
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile.data()));
+    remove((mkvFile + ".bak").data());
+}
+
+/*!
+ * \brief Tests predicting how changes would be applied via --plan.
+ */
+void CliTests::testRewritePlan()
+{
+    cout << "\nPredicting how changes would be applied" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mkvFile = workingCopyPath("matroska_wave1/test2.mkv");
+    const auto mp3File = workingCopyPath("mtx-test-data/mp3/id3-tag-and-xing-header.mp3");
+    const auto writeTime = std::filesystem::last_write_time(mkvFile);
+
+    // a plan is printed for each file and for the whole batch
+    const char *const args1[] = { "tageditor", "set", "title=plan test", "--plan", "-f", mkvFile.data(), mp3File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(
+        stdout, { " - Plan: ", "   Tag size: ", "   Padding: ", "   Bytes to be written: ", " - Plan: ", "Plan for all files:\n" }));
+
+    // the files are not modified
+    CPPUNIT_ASSERT(writeTime == std::filesystem::last_write_time(mkvFile));
+    const char *const args2[] = { "tageditor", "get", "title", "-f", mkvFile.data(), mp3File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(stdout.find("plan test") == string::npos);
+
+    // forcing a rewrite is taken into account
+    const char *const args3[] = { "tageditor", "set", "title=plan test", "--force-rewrite", "--plan", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { " - Plan: The entire file would be rewritten because a rewrite is forced.\n", "Plan for all files:\n",
+            " - Files changed in-place: 0\n", " - Files rewritten entirely: 1" }));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(mp3File.data()));
+}
+
+/*!
+ * \brief Tests gathering padding statistics via --padding-stats and --padding.
+ */
+void CliTests::testPaddingAdvisor()
+{
+    cout << "\nGathering padding statistics" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mkvFile = testFilePath("matroska_wave1/test2.mkv");
+    const auto mkvWorkingCopy = workingCopyPath("matroska_wave1/test2.mkv");
+
+    // no suggestion is made for too few files
+    const char *const args1[] = { "tageditor", "info", "--padding-stats", "-f", mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { "Padding statistics", " (suggestions keep the expected rate of rewrites below 5 %):\n", "Matroska", ": 1 files\n", "   Tag sizes:\n",
+            "   Paddings:\n", "   Suggestion: not enough files (at least 16 files are required)\n" }));
+
+    // a suggestion is made when enough files have been analyzed
+    auto args2 = std::vector<const char *>{ "tageditor", "info", "--padding-stats", "10", "-f" };
+    args2.insert(args2.end(), 16, mkvFile.data());
+    args2.emplace_back(nullptr);
+    TESTUTILS_ASSERT_EXEC(args2.data());
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { " (suggestions keep the expected rate of rewrites below 10 %):\n", ": 16 files\n", "   Suggestion: --min-padding 0 --max-padding " }));
+
+    // the growth of tags is recorded when setting values
+    const char *const args3[] = { "tageditor", "set", "title=padding test", "--plan", "--padding", "stats", "-f", mkvWorkingCopy.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Plan: ", "Padding statistics", ": 1 files\n", "   Growth of tags (median/95 %): " }));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mkvWorkingCopy.data()));
+}
+
+/*!
+ * \brief Tests recording timings of processing phases via --timings.
+ */
+void CliTests::testTimings()
+{
+    cout << "\nRecording timings of processing phases" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mkvFile = testFilePath("matroska_wave1/test2.mkv");
+    const auto mp4File = workingCopyPath("mtx-test-data/aac/he-aacv2-ps.m4a");
+    const auto timingsFile = (std::filesystem::temp_directory_path() / "timings.tsv").string();
+
+    // timings are printed to stderr by default
+    const char *const args1[] = { "tageditor", "get", "title", "--timings", "-f", mkvFile.data(), mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr,
+        { "#record\tfile\tphase\twall_ms\tcpu_ms\tbytes_read\tbytes_written\n", "file\t", "\topen\t", "\tparse-container\t",
+            "\tparse-tags\t", "\tprint\t", "#record\tphase\tfiles\twall_p50_ms", "summary\topen\t2\t", "summary\ttotal\t2\t" }));
+    CPPUNIT_ASSERT(stdout.find("#record") == string::npos);
+
+    // timings are written to the specified file; phases of the set operation are recorded
+    const char *const args2[] = { "tageditor", "set", "title=timings test", "--timings", timingsFile.data(), "-f", mp4File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    const auto timings = readFile(timingsFile);
+    CPPUNIT_ASSERT(testContainsSubstrings(timings,
+        { "#record\tfile\tphase", "\tparse-container\t", "\tparse-tags\t", "\tmodify\t", "\tapply-changes\t", "summary\tapply-changes\t1\t",
+            "summary\ttotal\t1\t" }));
+    CPPUNIT_ASSERT(stderr.find("#record") == string::npos);
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(timingsFile.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(mp4File.data()));
+    remove((mp4File + ".bak").data());
+}
+
+/*!
+ * \brief Tests showing the progress of the whole batch via --progress.
+ */
+void CliTests::testProgress()
+{
+    cout << "\nShowing the progress of the whole batch" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mkvFile = testFilePath("matroska_wave1/test2.mkv");
+    const auto mp4File = workingCopyPath("mtx-test-data/aac/he-aacv2-ps.m4a");
+
+    // the final status line is printed to stderr
+    const char *const args1[] = { "tageditor", "get", "title", "--progress", "-f", mkvFile.data(), mkvFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { " - [2/2 files, 100.0 %] ", " files/s, ", "/s, took " }));
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Tag information for \"", "Tag information for \"" }));
+    CPPUNIT_ASSERT(stdout.find("files/s") == string::npos);
+
+    // the output of the set operation is still printed
+    const char *const args2[] = { "tageditor", "set", "title=progress test", "--progress", "-f", mp4File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Setting tag information for \"", " - Changes have been applied.\n" }));
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { " - [1/1 files, 100.0 %] ", ", took " }));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mp4File.data()));
+    remove((mp4File + ".bak").data());
+}
+
+/*!
+ * \brief Tests resuming a batch of the set operation via --journal.
+ */
+void CliTests::testJournal()
+{
+    cout << "\nResuming a batch via a journal" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mp4File = workingCopyPath("mtx-test-data/aac/he-aacv2-ps.m4a");
+    const auto journalFile = workingCopyPath("set.journal", WorkingCopyMode::NoCopy);
+    remove(journalFile.data());
+
+    // the file is processed once and skipped when running the same operation again
+    const char *const args1[] = { "tageditor", "set", "title=journal test", "--journal", journalFile.data(), "-f", mp4File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Setting tag information for \"", " - Changes have been applied.\n" }));
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Skipping file because it has already been processed according to the journal.\n" }));
+    CPPUNIT_ASSERT(stdout.find("Changes have been applied") == string::npos);
+
+    // the file is processed again when requesting a different operation
+    const char *const args2[] = { "tageditor", "set", "title=journal test 2", "--journal", journalFile.data(), "-f", mp4File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Changes have been applied.\n" }));
+
+    // the original file is restored from the backup if a previous run has been interrupted while rewriting it
+    const auto nativePath = std::filesystem::path(makeNativePath(mp4File));
+    const auto backupPath = std::filesystem::path(makeNativePath(mp4File + ".bak"));
+    std::filesystem::copy_file(nativePath, backupPath, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::last_write_time(backupPath, std::filesystem::last_write_time(nativePath));
+    {
+        auto journal = std::ofstream(journalFile, std::ios_base::app);
+        journal << "started\t0\t" << std::filesystem::file_size(nativePath) << '\t'
+                << std::filesystem::last_write_time(nativePath).time_since_epoch().count() << '\t' << mp4File << '\n';
+        auto partiallyWrittenFile = std::ofstream(mp4File, std::ios_base::trunc);
+        partiallyWrittenFile << "incomplete";
+    }
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Restored the original file from the backup \"", " - Changes have been applied.\n" }));
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Skipping file because it has already been processed according to the journal.\n" }));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mp4File.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(journalFile.data()));
+    remove((mp4File + ".bak").data());
+}
+
+/*!
+ * \brief Tests skipping unchanged files via --incremental.
+ */
+void CliTests::testIncremental()
+{
+    cout << "\nSkipping unchanged files via a state database" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mp4File = workingCopyPath("mtx-test-data/aac/he-aacv2-ps.m4a");
+    const auto stateFile = workingCopyPath("state.db", WorkingCopyMode::NoCopy);
+    remove(stateFile.data());
+
+    // the file is only modified once
+    const char *const args1[] = { "tageditor", "set", "title=incremental test", "--incremental", stateFile.data(), "-f", mp4File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Changes have been applied.\n" }));
+#ifdef PLATFORM_UNIX
+    CPPUNIT_ASSERT_MESSAGE("method of applying changes printed for in-place edits as well",
+        stdout.find(" - The file has been modified in-place.\n") != string::npos || stdout.find(" - The file has been rewritten; ") != string::npos);
+#endif
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Skipping file because it has not been changed since it has been processed.\n" }));
+
+    // the output of the get operation is the same when using the cached result
+    const char *const args2[] = { "tageditor", "get", "title", "--incremental", stateFile.data(), "-f", mp4File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    const auto firstOutput = stdout;
+    CPPUNIT_ASSERT(testContainsSubstrings(firstOutput, { "Tag information for \"", "    Title             incremental test\n" }));
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT_EQUAL(firstOutput, stdout);
+    const auto stateFileName = std::filesystem::path(stateFile).filename().string();
+    for (const auto &entry : std::filesystem::directory_iterator(std::filesystem::path(stateFile).parent_path())) {
+        const auto fileName = entry.path().filename().string();
+        CPPUNIT_ASSERT_MESSAGE("buffered results and temporary files removed after saving: " + fileName,
+            !startsWith(fileName, stateFileName + ".updates") && !startsWith(fileName, stateFileName + ".tmp"));
+    }
+
+    // the cached result is not used anymore when the file has been changed
+    const char *const args3[] = { "tageditor", "set", "title=changed", "-f", mp4File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "    Title             changed\n" }));
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Changes have been applied.\n" }));
+
+    // files used as values are taken into account (and not only their paths)
+    const auto coverFile = workingCopyPath("matroska_wave1/logo3_256x256.png");
+    const auto setCover = "cover=" + coverFile;
+    const char *const args5[] = { "tageditor", "set", setCover.data(), "--incremental", stateFile.data(), "-f", mp4File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args5);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Changes have been applied.\n" }));
+    TESTUTILS_ASSERT_EXEC(args5);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Skipping file because it has not been changed since it has been processed.\n" }));
+    CPPUNIT_ASSERT_EQUAL(0, remove(coverFile.data()));
+    writeFile(coverFile, readFile(testFilePath("matroska_wave1/logo3_256x256.png")));
+    TESTUTILS_ASSERT_EXEC(args5);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Changes have been applied.\n" }));
+
+    CPPUNIT_ASSERT_EQUAL(0, remove(mp4File.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(coverFile.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(stateFile.data()));
+    remove((stateFile + ".lock").data());
+    remove((mp4File + ".bak").data());
+}
+
+/*!
+ * \brief Tests serving requests via a Unix domain socket.
+ */
+void CliTests::testServe()
+{
+#if !defined(TAGEDITOR_JSON_EXPORT) || !defined(PLATFORM_UNIX)
+    cout << "\nSkipping serving requests (feature not enabled)" << endl;
+#else
+    cout << "\nServing requests via a Unix domain socket" << endl;
+    const auto mkvFile = workingCopyPath("matroska_wave1/test2.mkv");
+    const auto socketPath = workingCopyPath("tageditor.sock", WorkingCopyMode::NoCopy);
+    remove(socketPath.data());
+
+    // run the server in a separate process
+    const auto server = fork();
+    CPPUNIT_ASSERT(server >= 0);
+    if (!server) {
+        auto stdout = std::string(), stderr = std::string();
+        const char *const args[] = { "tageditor", "serve", "--socket", socketPath.data(), "--jobs", "2", nullptr };
+        _exit(execApp(args, stdout, stderr));
+    }
+
+    // connect to the server (which might take a moment to create the socket)
+    auto address = sockaddr_un();
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.data(), sizeof(address.sun_path) - 1);
+    const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    CPPUNIT_ASSERT(fd >= 0);
+    auto connected = false;
+    for (auto attempt = 0; attempt != 100 && !connected; ++attempt) {
+        if (!(connected = !connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)))) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    }
+    CPPUNIT_ASSERT(connected);
+
+    // send requests and receive responses
+    const auto frame = [](const std::string &request) {
+        char size[4];
+        BE::getBytes(static_cast<std::uint32_t>(request.size()), size);
+        return std::string(size, sizeof(size)) + request;
+    };
+    const auto send = [fd, &frame](const std::string &request) {
+        const auto framed = frame(request);
+        CPPUNIT_ASSERT_EQUAL(static_cast<ssize_t>(framed.size()), write(fd, framed.data(), framed.size()));
+    };
+    const auto receive = [fd] {
+        const auto readExactly = [fd](char *buffer, std::size_t size) {
+            for (auto offset = std::size_t(); offset != size;) {
+                const auto bytesRead = read(fd, buffer + offset, size - offset);
+                CPPUNIT_ASSERT(bytesRead > 0);
+                offset += static_cast<std::size_t>(bytesRead);
+            }
+        };
+        char size[4];
+        readExactly(size, sizeof(size));
+        auto response = std::string(BE::toUInt32(size), '\0');
+        readExactly(response.data(), response.size());
+        return response;
+    };
+    send(argsToString(R"({"id":1,"operation":"get","args":["title","-f",")", mkvFile, R"("]})"));
+    auto response = receive();
+    CPPUNIT_ASSERT(testContainsSubstrings(response, { R"({"id":1,"exitCode":0,"stdout":")", "Title             Elephant Dream - test 2" }));
+    send(R"({"id":"foo","operation":"html-info"})");
+    response = receive();
+    CPPUNIT_ASSERT_EQUAL(R"({"id":"foo","error":"the operation \"html-info\" is not supported"})"s, response);
+    send(R"({"id":2,"operation":"get","args":["--no-such-option"]})");
+    response = receive();
+    CPPUNIT_ASSERT(testContainsSubstrings(response, { R"({"id":2,"exitCode":1,)", "--no-such-option" }));
+
+    // requests are still processed after a worker has exited due to an invalid request
+    for (const auto id : { "3", "4", "5" }) {
+        send(argsToString(R"({"id":)", id, R"(,"operation":"get","args":["title","-f",")", mkvFile, R"("]})"));
+        response = receive();
+        CPPUNIT_ASSERT(testContainsSubstrings(response, { R"(,"exitCode":0,"stdout":")", "Title             Elephant Dream - test 2" }));
+        CPPUNIT_ASSERT(startsWith(response, argsToString(R"({"id":)", id, ',')));
+    }
+
+    // stop the server; requests sent after the shutdown request are rejected (even if they are received at the same time)
+    const auto framedRequests = frame(R"({"id":6,"operation":"shutdown"})")
+        + frame(argsToString(R"({"id":7,"operation":"get","args":["title","-f",")", mkvFile, R"("]})"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<ssize_t>(framedRequests.size()), write(fd, framedRequests.data(), framedRequests.size()));
+    CPPUNIT_ASSERT_EQUAL(R"({"id":6,"exitCode":0})"s, receive());
+    CPPUNIT_ASSERT_EQUAL(R"({"id":7,"error":"the server is shutting down"})"s, receive());
+    close(fd);
+    auto status = int();
+    CPPUNIT_ASSERT_EQUAL(server, waitpid(server, &status, 0));
+    CPPUNIT_ASSERT(WIFEXITED(status));
+    CPPUNIT_ASSERT_EQUAL(EXIT_SUCCESS, WEXITSTATUS(status));
+    CPPUNIT_ASSERT(!std::filesystem::exists(socketPath));
+    remove(mkvFile.data());
+#endif
+}
+
+/*!
+ * \brief Tests reading the paths of the files to be processed via --files-from.
+ */
+void CliTests::testFilesFrom()
+{
+    cout << "\nReading paths via --files-from" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mkvFile1 = workingCopyPath("matroska_wave1/test1.mkv");
+    const auto mkvFile2 = workingCopyPath("matroska_wave1/test2.mkv");
+    const auto mkvFile3 = workingCopyPath("matroska_wave1/test3.mkv");
+    const auto lineList = workingCopyPath("files.txt", WorkingCopyMode::NoCopy);
+    const auto nulList = workingCopyPath("files.bin", WorkingCopyMode::NoCopy);
+    std::ofstream(lineList, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary) << mkvFile1 << "\r\n\n" << mkvFile2 << '\n';
+    std::ofstream(nulList, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary)
+        << mkvFile3 << '\0' << '\0' << mkvFile2 << '\0';
+
+    // paths separated by newlines are read after the paths specified via --files (empty lines are skipped)
+    const char *const args1[] = { "tageditor", "get", "title", "-f", mkvFile3.data(), "--files-from", lineList.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { "Title             Elephant Dream - test 3", "Title             Big Buck Bunny - test 1", "Title             Elephant Dream - test 2" }));
+
+    // paths separated by NUL characters are read when --null is present
+    const char *const args2[] = { "tageditor", "set", "title=listed", "--files-from", nulList.data(), "--null", nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    const char *const args3[] = { "tageditor", "get", "title", "-f", mkvFile1.data(), mkvFile2.data(), mkvFile3.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    CPPUNIT_ASSERT(testContainsSubstrings(
+        stdout, { "Title             Big Buck Bunny - test 1", "Title             listed", "Title             listed" }));
+
+    // output files can not be specified
+    const char *const args4[] = { "tageditor", "set", "title=foo", "--files-from", lineList.data(), "-o", "foo", "bar", nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args4, EXIT_FAILURE);
+
+    // prefetching files does not change the order or the number of files
+    const char *const args5[] = { "tageditor", "get", "title", "-f", mkvFile3.data(), "--files-from", lineList.data(), "--prefetch", "1", nullptr };
+    TESTUTILS_ASSERT_EXEC(args5);
+    CPPUNIT_ASSERT(testContainsSubstrings(
+        stdout, { "Title             listed", "Title             Big Buck Bunny - test 1", "Title             listed" }));
+    const char *const args6[] = { "tageditor", "info", "-f", mkvFile1.data(), mkvFile2.data(), "--prefetch", nullptr };
+    TESTUTILS_ASSERT_EXEC(args6);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "test1.mkv", "test2.mkv" }));
+
+    for (const auto &file : { mkvFile1, mkvFile2, mkvFile3, lineList, nulList }) {
+        remove(file.data());
+    }
+    remove((mkvFile2 + ".bak").data()), remove((mkvFile3 + ".bak").data());
+}
+
+/*!
+ * \brief Tests walking directories via --recursive.
+ */
+void CliTests::testRecursive()
+{
+    cout << "\nWalking directories via --recursive" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto mkvFile1 = workingCopyPath("matroska_wave1/test1.mkv");
+    const auto mkvFile2 = workingCopyPath("matroska_wave1/test2.mkv");
+    const auto dir = std::filesystem::temp_directory_path() / "tageditor-recursive";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "a");
+    std::filesystem::create_directories(dir / "b" / "sub");
+    std::filesystem::copy_file(mkvFile1, dir / "a" / "test1.mkv");
+    std::filesystem::copy_file(mkvFile2, dir / "b" / "sub" / "test2.MKV");
+    std::ofstream((dir / "b" / "notes.mkv").string()) << "not a Matroska file";
+    std::ofstream((dir / "b" / "cover.jpg").string()) << "\xFF\xD8\xFF\xE0";
+#ifdef PLATFORM_UNIX
+    std::filesystem::create_hard_link(dir / "a" / "test1.mkv", dir / "b" / "link.mkv");
+    std::filesystem::create_symlink("../b/sub/test2.MKV", dir / "a" / "symlink.mkv");
+#endif
+    const auto dirPath = dir.string();
+
+    // all taggable files are found (files with other signatures and further hard and symbolic links are skipped)
+    const char *const args1[] = { "tageditor", "get", "title", "--recursive", dirPath.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Title             Big Buck Bunny - test 1" }));
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Title             Elephant Dream - test 2" }));
+    CPPUNIT_ASSERT_EQUAL(stdout.rfind("Big Buck Bunny - test 1"), stdout.find("Big Buck Bunny - test 1"));
+    CPPUNIT_ASSERT_EQUAL(stdout.rfind("Elephant Dream - test 2"), stdout.find("Elephant Dream - test 2"));
+    CPPUNIT_ASSERT(stdout.find("notes.mkv") == std::string::npos);
+    CPPUNIT_ASSERT(stdout.find("cover.jpg") == std::string::npos);
+
+    // extensions are matched case-insensitively; sorting by inode still yields all files
+    const char *const args2[] = { "tageditor", "set", "title=walked", "--recursive", dirPath.data(), "--extensions", ".mkv", "--sort-by-inode",
+        nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    const auto walkedFile1 = (dir / "a" / "test1.mkv").string(), walkedFile2 = (dir / "b" / "sub" / "test2.MKV").string();
+    const char *const args3[] = { "tageditor", "get", "title", "-f", walkedFile1.data(), walkedFile2.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { "Title             walked", "Title             walked" }));
+
+    // files with other extensions are skipped
+    const char *const args4[] = { "tageditor", "get", "title", "--recursive", dirPath.data(), "--extensions", "opus", nullptr };
+    TESTUTILS_ASSERT_EXEC(args4);
+    CPPUNIT_ASSERT(stdout.find("Title") == std::string::npos);
+
+    // output files can not be specified
+    const char *const args5[] = { "tageditor", "set", "title=foo", "--recursive", dirPath.data(), "-o", "foo", nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args5, EXIT_FAILURE);
+
+    std::filesystem::remove_all(dir);
+    remove(mkvFile1.data()), remove(mkvFile2.data());
+}
+
+/*!
+ * \brief Tests the "--format" option of the get operation.
+ */
+void CliTests::testMachineReadableOutput()
+{
+    cout << "\nPrinting tag information in machine-readable formats" << endl;
+    auto stdout = std::string(), stderr = std::string();
+    const auto flacFile = testFilePath("flac/test.flac");
+
+    // columns are in the specified order and there is a header line
+    const char *const args1[] = { "tageditor", "get", "title", "artist", "track", "--format", "tsv", "-f", flacFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT_EQUAL("path\tTitle\tArtist\tTrack\n" % flacFile + "\tSad Song\tOasis\t3/4\n", stdout);
+
+    // missing values are null and values are arrays
+    const char *const args2[] = { "tageditor", "get", "title", "lyricist", "--format", "ndjson", "-f", flacFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT_EQUAL(R"({"path":")" % flacFile + R"(","Title":["Sad Song"],"Lyricist":null})" + '\n', stdout);
+
+    // values are quoted as needed and there might be a record per tag
+    const char *const args3[] = { "tageditor", "get", "album", "--format", "csv", "--per-tag", "-f", flacFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    CPPUNIT_ASSERT_EQUAL("path,tag,Album\n" % flacFile + ",Vorbis comment,Don't Go Away (Apple Lossless)\n", stdout);
+
+    // unsupported fields can not be shown
+    const char *const args4[] = { "tageditor", "get", "--format", "csv", "--show-unsupported", "-f", flacFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args4, EXIT_FAILURE);
+}
+
 /*!
  * \brief Tests reading and writing multiple files at once with output files are specified.
  */
@@ -673,10 +1382,27 @@ void CliTests::testOutputFile()
             " - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
             "    Title             test2\n" }));
 
+    // output files might be copied via reflink/copy_file_range first to apply changes in-place; this must not leave anything behind
+    const auto outputFile = mkvFile1 + ".out.mkv";
+    const char *const args4[] = { "tageditor", "set", "target-level=30", "title=test3", "-f", mkvFile1.data(), "-o", outputFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args4);
+    CPPUNIT_ASSERT_MESSAGE("method of applying changes printed",
+        stdout.find(" - The output file has been written from scratch.\n") != string::npos || stdout.find(" - The clone has been ") != string::npos);
+    TESTUTILS_ASSERT_EXEC(args2);
+    CPPUNIT_ASSERT(stdout.find("Title             test3") == string::npos);
+    const char *const args5[] = { "tageditor", "get", "-f", outputFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args5);
+    CPPUNIT_ASSERT(stdout.find(" - \033[1mMatroska tag targeting \"level 30 'track, song, chapter'\"\033[0m\n"
+                               "    Title             test3\n")
+        != string::npos);
+    CPPUNIT_ASSERT(!std::filesystem::exists(outputFile + ".tmp"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(outputFile + ".bak"));
+
     CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile1.data()));
     CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile2.data()));
     CPPUNIT_ASSERT_EQUAL(0, remove(tempFile1.data()));
     CPPUNIT_ASSERT_EQUAL(0, remove(tempFile2.data()));
+    CPPUNIT_ASSERT_EQUAL(0, remove(outputFile.data()));
 }
 
 /*!
@@ -807,6 +1533,33 @@ void CliTests::testHandlingAttachments()
     // clear backup file
     CPPUNIT_ASSERT_EQUAL(0, remove(mkvFile1Backup.data()));
 
+    // setting only tags preserves attachments and tracks (although they are not parsed before altering tags)
+    // note: Writing a Matroska file still requires parsing them (right before applying changes)
+    const char *const args6[] = { "tageditor", "set", "title=attachment test", "--timings", "-f", mkvFile1.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args6);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "\tparse-tags\t", "\tparse-tracks\t", "\tapply-changes\t" }));
+    TESTUTILS_ASSERT_EXEC(args1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { "Tracks:", "Attachments:", "Name                          test2.mkv", "Description                   Updated test attachment",
+            "Size                          20.16 MiB (21142764 byte)" }));
+    remove(mkvFile1Backup.data());
+
+    // tracks and attachments are not parsed at all when the file is not written
+    const char *const args7[] = { "tageditor", "set", "title=attachment test", "--skip-unchanged", "--timings", "-f", mkvFile1.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args7);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { " - Skipping file because no changes are required." }));
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "\tparse-tags\t", "summary\ttotal\t1\t" }));
+    CPPUNIT_ASSERT(stderr.find("\tparse-tracks\t") == string::npos);
+
+    // tracks and attachments are not parsed at all for formats without container
+    const auto mp3File = workingCopyPath("mtx-test-data/mp3/id3-tag-and-xing-header.mp3");
+    const char *const args8[] = { "tageditor", "set", "title=attachment test", "--timings", "-f", mp3File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args8);
+    CPPUNIT_ASSERT(testContainsSubstrings(stderr, { "\tparse-tags\t", "\tapply-changes\t" }));
+    CPPUNIT_ASSERT(stderr.find("\tparse-tracks\t") == string::npos);
+    CPPUNIT_ASSERT_EQUAL(0, remove(mp3File.data()));
+    remove((mp3File + ".bak").data());
+
     // extract assigned attachment again
     const auto tmpFile = (std::filesystem::temp_directory_path() / "extracted.mkv").string();
     const char *const args4[] = { "tageditor", "extract", "--attachment", "name=test2.mkv", "-f", mkvFile1.data(), "-o", tmpFile.data(), nullptr };
@@ -822,6 +1575,39 @@ void CliTests::testHandlingAttachments()
     }
     remove(tmpFile.data());
 
+    // reading the file via a memory mapping yields the same information and attachment data
+    const char *const mmapArgs1[] = { "tageditor", "info", "--mmap", "-f", mkvFile1.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(mmapArgs1);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { "Tracks:", "Attachments:", "Name                          test2.mkv", "Size                          20.16 MiB (21142764 byte)" }));
+    const char *const mmapArgs2[]
+        = { "tageditor", "extract", "--attachment", "name=test2.mkv", "--mmap", "-f", mkvFile1.data(), "-o", tmpFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(mmapArgs2);
+    CPPUNIT_ASSERT(readFile(mkvFile2.data() + 5) == readFile(tmpFile));
+    remove(tmpFile.data());
+
+    // extract the attachment of multiple files into a directory under its name and deduplicated
+    const auto attachmentData = readFile(mkvFile2.data() + 5);
+    const auto outputDir = (std::filesystem::temp_directory_path() / "extracted-attachments").string();
+    std::filesystem::remove_all(outputDir);
+    const char *const outputDirArgs1[] = { "tageditor", "extract", "--attachment", "name=test2.mkv", "-f", mkvFile1.data(), mkvFile1.data(),
+        "--output-dir", outputDir.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(outputDirArgs1);
+    CPPUNIT_ASSERT(stdout.find("Stored 2 attachments as 2 distinct files") != std::string::npos);
+    CPPUNIT_ASSERT(attachmentData == readFile(outputDir + "/test2.mkv"));
+    CPPUNIT_ASSERT(attachmentData == readFile(outputDir + "/test2-1.mkv"));
+    CPPUNIT_ASSERT(testContainsSubstrings(readFile(outputDir + "/index.tsv"),
+        { "file\tattachment\tmime-type\tsize\tpath\n", "\ttest2.mkv\tvideo/x-matroska\t21142764\ttest2.mkv\n",
+            "\ttest2.mkv\tvideo/x-matroska\t21142764\ttest2-1.mkv\n" }));
+    std::filesystem::remove_all(outputDir);
+    const char *const outputDirArgs2[] = { "tageditor", "extract", "--attachment", "name=test2.mkv", "-f", mkvFile1.data(), mkvFile1.data(),
+        "--output-dir", outputDir.data(), "--dedup", nullptr };
+    TESTUTILS_ASSERT_EXEC(outputDirArgs2);
+    CPPUNIT_ASSERT(stdout.find("Stored 2 attachments as 1 distinct files") != std::string::npos);
+    const auto blobPath = argsToString(outputDir, '/', Cli::BlobStore::relativePath(Cli::Sha256::hexDigest(attachmentData)));
+    CPPUNIT_ASSERT(attachmentData == readFile(blobPath));
+    std::filesystem::remove_all(outputDir);
+
     // remove assigned attachment
     const char *const args5[] = { "tageditor", "set", "--remove-attachment", "name=test2.mkv", "-f", mkvFile1.data(), nullptr };
     TESTUTILS_ASSERT_EXEC(args5);
@@ -945,6 +1731,39 @@ void CliTests::testDisplayingInfo()
             "    Modification time             2014-12-10 16:22:41" }));
 }
 
+/*!
+ * \brief Tests the "verify"-operation.
+ */
+void CliTests::testVerification()
+{
+    cout << "\nVerification" << endl;
+    string stdout, stderr;
+
+    // files are verified in parallel but printed in order; the broken Matroska file fails
+    const auto mkvFile1 = testFilePath("matroska_wave1/test2.mkv");
+    const auto mkvFile2 = testFilePath("matroska_wave1/test4.mkv");
+    const char *const args1[]
+        = { "tageditor", "--no-color", "verify", "--jobs", "2", "-f", mkvFile1.data(), mkvFile2.data(), mkvFile1.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args1, EXIT_PARSING_FAILURE);
+    const auto failedLine = "fail  " % mkvFile2 + '\n';
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout,
+        { mkvFile1.data(), failedLine.data(), "EBML ID length at 35 is not supported", mkvFile1.data(), "Verified 3 files: ", ", 1 failed\n" }));
+    CPPUNIT_ASSERT(stdout.find("fail  " + mkvFile1) == std::string::npos);
+
+    // the result is the same when not reading files ahead
+    const char *const args2[] = { "tageditor", "--no-color", "verify", "--read-ahead", "0", "-f", mkvFile1.data(), mkvFile2.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args2, EXIT_PARSING_FAILURE);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { mkvFile1.data(), failedLine.data(), "Verified 2 files: ", ", 1 failed\n" }));
+
+    // files which can not be read fail with an IO error
+    const auto missingFile = (std::filesystem::temp_directory_path() / "missing.mkv").string();
+    std::filesystem::remove(missingFile);
+    const char *const args3[] = { "tageditor", "--no-color", "verify", "-f", missingFile.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC_EXIT_STATUS(args3, EXIT_IO_FAILURE);
+    const auto missingLine = "fail  " % missingFile + "\n      unable to open the file";
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { missingLine.data(), "Verified 1 files: 0 passed, 0 with warnings, 1 failed\n" }));
+}
+
 /*!
  * \brief Tests setting track meta-data.
  */
@@ -1075,6 +1894,26 @@ void CliTests::testExtraction()
     CPPUNIT_ASSERT_EQUAL(static_cast<std::uint64_t>(22771), extractedInfo.size());
     CPPUNIT_ASSERT(ContainerFormat::Jpeg == extractedInfo.containerFormat());
     extractedInfo.close();
+
+    // extract covers of multiple files into a directory storing identical covers only once
+    const auto outputDir = (std::filesystem::temp_directory_path() / "extracted-covers").string();
+    std::filesystem::remove_all(outputDir);
+    const char *const args4[]
+        = { "tageditor", "extract", "cover", "-f", mp4File1.data(), mp4File2.data(), "--output-dir", outputDir.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args4);
+    CPPUNIT_ASSERT(stdout.find("Stored 2 values as 1 distinct files") != std::string::npos);
+    const auto index = readFile(outputDir + "/index.tsv");
+    const auto lines = splitStringSimple<std::vector<std::string_view>>(index, "\n");
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), lines.size());
+    CPPUNIT_ASSERT_EQUAL("file\ttag\tmime-type\tsize\tblob"s, std::string(lines[0]));
+    const auto columns = splitStringSimple<std::vector<std::string_view>>(lines[1], "\t");
+    CPPUNIT_ASSERT_EQUAL(std::size_t(5), columns.size());
+    CPPUNIT_ASSERT_EQUAL(mp4File1, std::string(columns[0]));
+    CPPUNIT_ASSERT_EQUAL("22771"s, std::string(columns[3]));
+    CPPUNIT_ASSERT_EQUAL(std::string(columns[4]), std::string(lines[2].substr(lines[2].rfind('\t') + 1)));
+    CPPUNIT_ASSERT_EQUAL(std::uintmax_t(22771), std::filesystem::file_size(argsToString(outputDir, '/', columns[4])));
+    std::filesystem::remove_all(outputDir);
+
     CPPUNIT_ASSERT_EQUAL(0, remove(tempFile.data()));
     CPPUNIT_ASSERT_EQUAL(0, remove(mp4File2.data()));
     CPPUNIT_ASSERT_EQUAL(0, remove((mp4File2 + ".bak").data()));
@@ -1168,12 +2007,52 @@ void CliTests::testJsonExport()
     const auto expectedJson = readFile(testFilePath("matroska_wave1-test3.json"));
     const char *const args[] = { "tageditor", "export", "--pretty", "-f", file.data(), nullptr };
     TESTUTILS_ASSERT_EXEC(args);
-    const char *const jqArgs[]
-        = { "jq", "--argjson", "expected", expectedJson.data(), "--argjson", "actual", stdout.data(), "-n", "$actual == $expected", nullptr };
+    // the path depends on the location of the test files so it is compared separately
+    const char *const jqArgs[] = { "jq", "--argjson", "expected", expectedJson.data(), "--argjson", "actual", stdout.data(), "--arg", "path",
+        file.data(), "-n", "($actual | map(.path)) == [$path] and ($actual | map(del(.path))) == $expected", nullptr };
     const auto *const logJsonExport = std::getenv(PROJECT_VARNAME_UPPER "_LOG_JQ_INVOCATION");
     execHelperAppInSearchPath("jq", jqArgs, stdout, stderr, !logJsonExport || !std::strlen(logJsonExport));
     CPPUNIT_ASSERT_EQUAL(""s, stderr);
     CPPUNIT_ASSERT_EQUAL("true\n"s, stdout);
+
+    // files processed in parallel are still printed in order
+    const char *const args2[] = { "tageditor", "export", "--jobs", "2", "-f", file.data(), file.data(), file.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args2);
+    const auto arrayOutput = stdout;
+    const char *const jqArgs2[] = { "jq", "--argjson", "expected", expectedJson.data(), "--argjson", "actual", arrayOutput.data(), "-n",
+        "($actual | map(del(.path))) == $expected + $expected + $expected", nullptr };
+    execHelperAppInSearchPath("jq", jqArgs2, stdout, stderr, !logJsonExport || !std::strlen(logJsonExport));
+    CPPUNIT_ASSERT_EQUAL("true\n"s, stdout);
+
+    // the same objects are printed one per line when using --ndjson
+    const char *const args3[] = { "tageditor", "export", "--ndjson", "-f", file.data(), file.data(), file.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args3);
+    const auto lines = splitStringSimple<std::vector<std::string_view>>(stdout, "\n");
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), lines.size());
+    CPPUNIT_ASSERT(lines.back().empty());
+    CPPUNIT_ASSERT_EQUAL(argsToString('[', lines[0], ',', lines[1], ',', lines[2], "]\n"), arrayOutput);
+
+    // covers are stored once in the blob directory and only referenced by their digest when using --blobs
+    const auto coverFile = testFilePath("matroska_wave1/logo3_256x256.png");
+    const auto coverDigest = Cli::Sha256::hexDigest(readFile(coverFile));
+    const auto coverValue = "\"sha256\":\"" % coverDigest + '"';
+    const auto mp3File = workingCopyPath("mtx-test-data/mp3/id3-tag-and-xing-header.mp3");
+    const auto setCover = "cover=" + coverFile;
+    const char *const args4[] = { "tageditor", "set", setCover.data(), "-f", mp3File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args4);
+    const auto blobDir = (std::filesystem::temp_directory_path() / "tageditor-blobs").string();
+    std::filesystem::remove_all(blobDir);
+    const char *const args5[] = { "tageditor", "export", "--blobs", blobDir.data(), "-f", mp3File.data(), mp3File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args5);
+    CPPUNIT_ASSERT(testContainsSubstrings(stdout, { coverValue.data(), coverValue.data() }));
+    const auto blobPath = argsToString(blobDir, '/', coverDigest.substr(0, 2), '/', coverDigest);
+    CPPUNIT_ASSERT_EQUAL(readFile(coverFile), readFile(blobPath));
+    std::filesystem::remove_all(blobDir);
+    const char *const args6[] = { "tageditor", "export", "--blobs", "hash-only", "-f", mp3File.data(), nullptr };
+    TESTUTILS_ASSERT_EXEC(args6);
+    CPPUNIT_ASSERT(stdout.find(coverValue) != std::string::npos);
+    CPPUNIT_ASSERT(!std::filesystem::exists(blobDir));
+    remove(mp3File.data());
 #endif // TAGEDITOR_JSON_EXPORT
 }
 